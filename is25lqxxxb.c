@@ -10,15 +10,28 @@
 //Includes
 #include "is25lq040b_ext_mem.h"
 
+//QSPI calls, routed through the trace recorder with IS25_TRACE
+#include "is25lqxxxb_trace.h"
+
 //Private variables
 IS25mem_Identification	memory_ident		= {0};
 IS25mem_MemorySpace		memory_space		= {0};
 QSPI_HandleTypeDef 		*qspi_h				=  0;
+IS25mem_readConfig		read_config			= {IS25_READCFG_MAGIC, IS25_READ_1_1_1, 8, 0, 0, 0, 0};
+static uint32_t			base_prescaler		= 255;			// QSPI clock of IS25mem_Init, used by every command
+static uint32_t			base_shift			= 0;			// except the reads with a read configuration
 
 
 //function prototypes
 void (*autoPollingCallback)(void) 	= 0;
 void (*pEraseDoneCallback) 			= 0;
+void (*pWearCallback)(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs) = 0;
+void (*pChangeCallback)(mem_address address, uint32_t size) = 0;
+flash_err (*pProtectCallback)(mem_address address, uint32_t size) = 0;
+
+static IS25mem_wearOp		eraseOp			= IS25_WEAR_SECTOR_ERASE;		// Running IS25mem_xxxErase, for the wear report
+static mem_address			eraseAddress	= {0};
+static IS25mem_busyTimer	eraseTimer		= {0};
 
 
 //Function to register the Callback in Callback routine
@@ -41,6 +54,189 @@ void setEraseDoneCallbackFct(void (*fct)){
 	pEraseDoneCallback = fct;
 }
 
+/**
+ * IS25mem_setWearCallback(void (*fct)(IS25mem_wearOp, mem_address, uint32_t, uint32_t))
+ *
+ * @Brief
+ * 		Registers a function which is called after every successful page program and erase of the driver and the
+ * 		request queue, with the time the memory was busy (WIP set). Erases started with IS25mem_sectorErase /
+ * 		blockErase / chipErase report from the status match interrupt, before the erase done callback.
+ *
+ * @Parameter
+ * 		fct		- 0 to disable the reports
+ */
+void IS25mem_setWearCallback(void (*fct)(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs)){
+	pWearCallback = fct;
+}
+
+/**
+ * IS25mem_setChangeCallback(void (*fct)(mem_address, uint32_t))
+ *
+ * @Brief
+ * 		Registers a function which is called with the range of every successful page program and erase of the driver
+ * 		and the request queue, e.g. to drop cached copies (IS25pf_invalidate). Called from interrupt context for the
+ * 		request queue and the interrupt driven erases.
+ *
+ * @Parameter
+ * 		fct		- 0 to disable the reports
+ */
+void IS25mem_setChangeCallback(void (*fct)(mem_address address, uint32_t size)){
+	pChangeCallback = fct;
+}
+
+/**
+ * IS25mem_setProtectCallback(flash_err (*fct)(mem_address, uint32_t))
+ *
+ * @Brief
+ * 		Registers a check of the range of every program and erase of the driver and the request queue before anything
+ * 		is sent, e.g. IS25prot_check of the block protection planner (registered by IS25prot_init). The device
+ * 		ignores writes into protected blocks without an error, the check turns them into MEMORY_PROTECTED_ERR. May be
+ * 		called from interrupt context (IS25async_submit), must not access the memory.
+ *
+ * @Parameter
+ * 		fct		- 0 to disable the check
+ */
+void IS25mem_setProtectCallback(flash_err (*fct)(mem_address address, uint32_t size)){
+	pProtectCallback = fct;
+}
+
+/**
+ * IS25mem_checkProtect(mem_address address, uint32_t size)
+ *
+ * @return
+ * 		flash_err	- result of the protect callback, MEMORY_OK without one
+ */
+flash_err IS25mem_checkProtect(mem_address address, uint32_t size){
+	return pProtectCallback != 0 ? pProtectCallback(address, size) : MEMORY_OK;
+}
+
+/**
+ * IS25mem_checkErase(IS25mem_wearOp op, mem_address address)
+ *
+ * @Brief
+ * 		Protect callback with the range erased by a sector / 64 kByte block / chip erase.
+ */
+static flash_err IS25mem_checkErase(IS25mem_wearOp op, mem_address address){
+	uint32_t size = 4096UL;
+
+	if(op == IS25_WEAR_BLOCK_ERASE){
+		size = 65536UL;
+	}else if(op == IS25_WEAR_CHIP_ERASE){
+		address.val	= 0;
+		size		= memory_space.bytes;
+	}
+	address.val &= ~(size - 1);
+	return IS25mem_checkProtect(address, size);
+}
+
+/**
+ * IS25mem_busyStart(IS25mem_busyTimer *timer)
+ *
+ * @Brief
+ * 		Starts a busy time measurement.
+ */
+void IS25mem_busyStart(IS25mem_busyTimer *timer){
+	timer->cycles	= IS25_BUSY_CYCLES();
+	timer->tick		= HAL_GetTick();
+}
+
+/**
+ * IS25mem_busyUs(const IS25mem_busyTimer *timer)
+ *
+ * @Brief
+ * 		Microseconds since IS25mem_busyStart. Uses the cycle counter below 10 s, the HAL tick above (the 32 bit cycle
+ * 		counter wraps after 53 s at 80 MHz) or if the cycle counter does not run.
+ *
+ * @return
+ * 		uint32_t	- microseconds
+ */
+uint32_t IS25mem_busyUs(const IS25mem_busyTimer *timer){
+	uint32_t ms		= HAL_GetTick() - timer->tick;
+	uint32_t cycles	= IS25_BUSY_CYCLES() - timer->cycles;
+	uint32_t perUs	= HAL_RCC_GetHCLKFreq() / 1000000UL;
+
+	if(ms >= 10000 || cycles == 0 || perUs == 0){
+		return ms * 1000;
+	}
+	return cycles / perUs;
+}
+
+/**
+ * IS25mem_reportWear(IS25mem_wearOp op, mem_address address, uint32_t size, const IS25mem_busyTimer *timer)
+ *
+ * @Brief
+ * 		Passes a finished program / erase to the change and the wear callback. Used by the driver and the request queue.
+ */
+void IS25mem_reportWear(IS25mem_wearOp op, mem_address address, uint32_t size, const IS25mem_busyTimer *timer){
+	if(pChangeCallback != 0){
+		pChangeCallback(address, size);
+	}
+	if(pWearCallback != 0){
+		pWearCallback(op, address, size, IS25mem_busyUs(timer));
+	}
+}
+
+/**
+ * IS25mem_eraseDone(void)
+ *
+ * @Brief
+ * 		Status match of an interrupt driven erase with a change / wear callback: report, then the user's erase done
+ * 		callback.
+ */
+static void IS25mem_eraseDone(void){
+	uint32_t size = eraseOp == IS25_WEAR_SECTOR_ERASE ? 4096UL :
+					eraseOp == IS25_WEAR_BLOCK_ERASE ? 65536UL : memory_space.bytes;
+
+	IS25mem_reportWear(eraseOp, eraseAddress, size, &eraseTimer);
+	if(pEraseDoneCallback != 0){
+		((void (*)(void))pEraseDoneCallback)();
+	}
+}
+
+/**
+ * IS25mem_registerEraseDone(IS25mem_wearOp op, mem_address address)
+ *
+ * @Brief
+ * 		Registers the erase done callback of an interrupt driven erase, wrapped for the reports if a change or wear
+ * 		callback is set.
+ */
+static void IS25mem_registerEraseDone(IS25mem_wearOp op, mem_address address){
+	if(pWearCallback == 0 && pChangeCallback == 0){
+		IS25mem_registerCallback(pEraseDoneCallback);
+		return;
+	}
+	eraseOp			= op;
+	eraseAddress	= address;
+	IS25mem_busyStart(&eraseTimer);
+	IS25mem_registerCallback(IS25mem_eraseDone);
+}
+
+/**
+ * IS25mem_getMemorySpace(void)
+ *
+ * @Brief
+ * 		Returns the memory geometry detected by IS25mem_Init. All fields are zero before a successful init.
+ *
+ * @return
+ * 		const IS25mem_MemorySpace *
+ */
+const IS25mem_MemorySpace *IS25mem_getMemorySpace(void){
+	return &memory_space;
+}
+
+/**
+ * IS25mem_getQspiHandle(void)
+ *
+ * @Brief
+ * 		Returns the QSPI handle registered in IS25mem_Init, used by the driver extensions.
+ *
+ * @return
+ * 		QSPI_HandleTypeDef *
+ */
+QSPI_HandleTypeDef *IS25mem_getQspiHandle(void){
+	return qspi_h;
+}
+
 /**
  * Init IS24lq flash driver
  *
@@ -57,7 +253,18 @@ void setEraseDoneCallbackFct(void (*fct)){
 flash_err IS25mem_Init(QSPI_HandleTypeDef *qSPIHandler){
 
 	if(qSPIHandler != 0){
-		qspi_h = qSPIHandler;
+		qspi_h 			= qSPIHandler;
+		base_prescaler	= qspi_h->Init.ClockPrescaler;
+		base_shift		= qspi_h->Init.SampleShifting;
+
+		//Default read configuration: FR at the base clock
+		read_config				= (IS25mem_readConfig){IS25_READCFG_MAGIC, IS25_READ_1_1_1, 8, 0, 0, 0, 0};
+		read_config.prescaler	= (uint8_t)base_prescaler;
+		read_config.sampleShift	= (base_shift != QSPI_SAMPLE_SHIFTING_NONE);
+		read_config.check		= IS25mem_readConfigCheck(&read_config);
+
+		//Busy times, trace and read-ahead timestamps count CPU cycles, the DWT counter is off after reset
+		IS25_BUSY_CYCLES_ENABLE();
 	}
 
 	IS25mem_readProductId(&memory_ident);
@@ -65,24 +272,72 @@ flash_err IS25mem_Init(QSPI_HandleTypeDef *qSPIHandler){
 		case 0x13:	memory_space.blocks64 	= 8;
 					memory_space.blocks32 	= 16;
 					memory_space.sectors	= 128;
-					return MEMORY_OK;
+					break;
 		case 0x12:	memory_space.blocks64 	= 4;
 					memory_space.blocks32 	= 8;
 					memory_space.sectors	= 64;
-					return MEMORY_OK;
+					break;
 		case 0x11:	memory_space.blocks64 	= 2;
 					memory_space.blocks32 	= 4;
 					memory_space.sectors	= 32;
-					return MEMORY_OK;
+					break;
 		case 0x10:	memory_space.blocks64 	= 0;
 					memory_space.blocks32 	= 2;
 					memory_space.sectors	= 16;
-					return MEMORY_OK;
+					break;
 		case 0x09:	memory_space.blocks64 	= 0;
 					memory_space.blocks32 	= 1;
 					memory_space.sectors	= 8;
-					return MEMORY_OK;
-		default: return MEMORY_WRONG_CPACITY_ERR;
+					break;
+		default:
+			//Larger ISSI parts encode the density as 2^Capacity bytes (0x14 = 1 MByte ... 0x1A = 64 MByte)
+			if(memory_ident.Capacity < 0x14 || memory_ident.Capacity > 0x1A){
+				memory_space = (IS25mem_MemorySpace){0};
+				return MEMORY_WRONG_CPACITY_ERR;
+			}
+			memory_space.blocks64 	= 1UL << (memory_ident.Capacity - 16);
+			memory_space.blocks32 	= 1UL << (memory_ident.Capacity - 15);
+			memory_space.sectors	= 1UL << (memory_ident.Capacity - 12);
+			break;
+	}
+
+	memory_space.bytes			= memory_space.sectors * 4096UL;
+	//Above 16 MByte the 3 byte address can not reach the whole array, use the 4 byte address opcodes
+	memory_space.addressBytes	= (memory_space.bytes > 0x1000000UL) ? 4 : 3;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25mem_adaptAddressing(QSPI_CommandTypeDef *memCmd)
+ *
+ * @Brief
+ * 		Sets the address size of a command with address phase. On parts above 16 MByte the instruction is replaced
+ * 		by its 4 byte address variant, so no address mode switch (EN4B/EX4B) has to be tracked across resets.
+ *
+ * @Parameter
+ * 		QSPI_CommandTypeDef *	- command with filled Instruction and Address
+ */
+void IS25mem_adaptAddressing(QSPI_CommandTypeDef *memCmd){
+	if(memory_space.addressBytes != 4){
+		memCmd->AddressSize = QSPI_ADDRESS_24_BITS;
+		return;
+	}
+
+	memCmd->AddressSize = QSPI_ADDRESS_32_BITS;
+	switch(memCmd->Instruction){
+		case RD:		memCmd->Instruction = RD4;		break;
+		case FR:		memCmd->Instruction = FR4;		break;
+		case FRDO:		memCmd->Instruction = FRDO4;	break;
+		case FRDIO:		memCmd->Instruction = FRDIO4;	break;
+		case FRQO:		memCmd->Instruction = FRQO4;	break;
+		case FRQIO:		memCmd->Instruction = FRQIO4;	break;
+		case PP:		memCmd->Instruction = PP4;		break;
+		case PPQ:		memCmd->Instruction = PPQ4;		break;
+		case SER:		memCmd->Instruction = SER4;		break;
+		case BER32:		memCmd->Instruction = BER32_4;	break;
+		case BER64:		memCmd->Instruction = BER64_4;	break;
+		default:		break;
 	}
 }
 
@@ -114,10 +369,12 @@ flash_err IS25mem_readData(uint8_t *readBuffer,mem_address address, uint16_t siz
 	memCmd.NbData 				= size;
 
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, readBuffer, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -150,10 +407,12 @@ flash_err IS25mem_fastReadData(uint8_t *readBuffer,mem_address address, uint16_t
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= size;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, readBuffer, 200) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -189,10 +448,12 @@ flash_err IS25mem_DualFastReadData(uint8_t *readBuffer,mem_address address, uint
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= size;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, readBuffer, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, 2)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -227,16 +488,250 @@ flash_err IS25mem_QuadFastReadData(uint8_t *readBuffer,mem_address address, uint
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= size;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, 4)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25mem_readConfigCheck(const IS25mem_readConfig *cfg)
+ *
+ * @return
+ * 		uint16_t	- check word over the configuration fields, stored in cfg->check
+ */
+uint16_t IS25mem_readConfigCheck(const IS25mem_readConfig *cfg){
+	const uint8_t *raw	= (const uint8_t *)cfg;
+	uint16_t check		= 0x1D0F;
+
+	for(uint8_t i = 0; i < offsetof(IS25mem_readConfig, check); i++){
+		check = (uint16_t)((check << 5) | (check >> 11)) ^ raw[i];
+	}
+	return check;
+}
+
+/**
+ * IS25mem_setClock(const IS25mem_readConfig *cfg)
+ *
+ * @Brief	Switches the QSPI peripheral to prescaler and sample shift of cfg, 0 switches back to the clock found in
+ * 			IS25mem_Init. HAL_QSPI_Init only runs if the setting changes.
+ *
+ * @Parameter		const IS25mem_readConfig *	- read configuration, 0 for the base clock
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_setClock(const IS25mem_readConfig *cfg){
+	uint32_t prescaler	= base_prescaler;
+	uint32_t shift		= base_shift;
+
+	if(cfg != 0){
+		prescaler	= cfg->prescaler;
+		shift		= cfg->sampleShift ? QSPI_SAMPLE_SHIFTING_HALFCYCLE : QSPI_SAMPLE_SHIFTING_NONE;
+	}
+	if(qspi_h->Init.ClockPrescaler == prescaler && qspi_h->Init.SampleShifting == shift){
+		return MEMORY_OK;
+	}
+
+	qspi_h->Init.ClockPrescaler	= prescaler;
+	qspi_h->Init.SampleShifting	= shift;
+
+	return (HAL_QSPI_Init(qspi_h) == HAL_OK) ? MEMORY_OK : MEMORY_ERROR;
+}
+
+/**
+ * IS25mem_setClockIT(const IS25mem_readConfig *cfg)
+ *
+ * @Brief	IS25mem_setClock for interrupt context and critical sections. HAL_QSPI_Init waits with HAL_GetTick, which
+ * 			does not run there, so prescaler and sample shift are written to QUADSPI CR directly. CR may only change
+ * 			while the peripheral is not busy, a transfer still running is aborted first.
+ *
+ * @Parameter		const IS25mem_readConfig *	- read configuration, 0 for the base clock
+ * @Return value 	flash_err		- MEMORY_BUSY if the abort did not finish
+ */
+flash_err IS25mem_setClockIT(const IS25mem_readConfig *cfg){
+	uint32_t prescaler	= base_prescaler;
+	uint32_t shift		= base_shift;
+	uint32_t polls		= IS25_ABORT_POLLS;
+
+	if(cfg != 0){
+		prescaler	= cfg->prescaler;
+		shift		= cfg->sampleShift ? QSPI_SAMPLE_SHIFTING_HALFCYCLE : QSPI_SAMPLE_SHIFTING_NONE;
+	}
+	if(qspi_h->Init.ClockPrescaler == prescaler && qspi_h->Init.SampleShifting == shift){
+		return MEMORY_OK;
+	}
+
+	if(READ_BIT(qspi_h->Instance->SR, QUADSPI_SR_BUSY)){
+		SET_BIT(qspi_h->Instance->CR, QUADSPI_CR_ABORT);
+		while(READ_BIT(qspi_h->Instance->SR, QUADSPI_SR_BUSY)){
+			if(--polls == 0){
+				return MEMORY_BUSY;
+			}
+		}
+	}
+	MODIFY_REG(qspi_h->Instance->CR, QUADSPI_CR_PRESCALER | QUADSPI_CR_SSHIFT,
+			(prescaler << QUADSPI_CR_PRESCALER_Pos) | shift);
+	qspi_h->Init.ClockPrescaler	= prescaler;
+	qspi_h->Init.SampleShifting	= shift;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25mem_readCommand(QSPI_CommandTypeDef *memCmd, mem_address address, uint32_t size, const IS25mem_readConfig *cfg)
+ *
+ * @Brief	Read command of a read configuration. The mode bits of the I/O modes are sent as 00h, so the memory never
+ * 			enters continuous read mode.
+ *
+ * @Parameter		QSPI_CommandTypeDef *		- command, filled completely
+ * 					mem_address 				- memory Address
+ * 					uint32_t					- size
+ * 					const IS25mem_readConfig *	- read mode and dummy cycles
+ * @Return value 	uint8_t		- data lines of the mode, 0 for an invalid mode
+ */
+uint8_t IS25mem_readCommand(QSPI_CommandTypeDef *memCmd, mem_address address, uint32_t size, const IS25mem_readConfig *cfg){
+	static const struct{
+		uint8_t		instruction;
+		uint32_t	addressMode;
+		uint32_t	dataMode;
+		uint8_t		lines;
+	}modes[] = {
+		[IS25_READ_1_1_1] = {FR,	QSPI_ADDRESS_1_LINE,	QSPI_DATA_1_LINE,	1},
+		[IS25_READ_1_1_2] = {FRDO,	QSPI_ADDRESS_1_LINE,	QSPI_DATA_2_LINES,	2},
+		[IS25_READ_1_2_2] = {FRDIO,	QSPI_ADDRESS_2_LINES,	QSPI_DATA_2_LINES,	2},
+		[IS25_READ_1_1_4] = {FRQO,	QSPI_ADDRESS_1_LINE,	QSPI_DATA_4_LINES,	4},
+		[IS25_READ_1_4_4] = {FRQIO,	QSPI_ADDRESS_4_LINES,	QSPI_DATA_4_LINES,	4},
+	};
+
+	if(cfg->mode > IS25_READ_1_4_4){
+		return 0;
+	}
+
+	//Set QSPI CMD
+	*memCmd						= (QSPI_CommandTypeDef){0};
+	memCmd->InstructionMode 	= QSPI_INSTRUCTION_1_LINE;
+	memCmd->Instruction 		= modes[cfg->mode].instruction;
+	memCmd->AddressMode 		= modes[cfg->mode].addressMode;
+	memCmd->AddressSize 		= QSPI_ADDRESS_24_BITS;
+	memCmd->AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd->DataMode 			= modes[cfg->mode].dataMode;
+	memCmd->DummyCycles 		= cfg->dummyCycles;
+	memCmd->Address 			= address.val;
+	memCmd->DdrMode 			= QSPI_DDR_MODE_DISABLE;
+	memCmd->SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd->NbData 				= size;
+
+	//I/O modes clock the mode bits M7-M0 on the address lines
+	if(cfg->mode == IS25_READ_1_2_2 || cfg->mode == IS25_READ_1_4_4){
+		memCmd->AlternateByteMode	= (cfg->mode == IS25_READ_1_2_2) ? QSPI_ALTERNATE_BYTES_2_LINES : QSPI_ALTERNATE_BYTES_4_LINES;
+		memCmd->AlternateBytesSize	= QSPI_ALTERNATE_BYTES_8_BITS;
+		memCmd->AlternateBytes		= 0x00;
+	}
+
+	IS25mem_adaptAddressing(memCmd);
+
+	return modes[cfg->mode].lines;
+}
+
+/**
+ * IS25mem_readDataCfg(uint8_t *readBuffer, mem_address address, uint32_t size, const IS25mem_readConfig *cfg)
+ *
+ * @Brief	Read with an explicit read configuration. Prescaler and sample shift of cfg are applied for this read only,
+ * 			every other command runs at the clock found in IS25mem_Init (RD is limited to 33 MHz).
+ *
+ * @Parameter		uint8_t *					- bufferPointer
+ * 					mem_address 				- memory Address
+ * 					uint32_t					- size
+ * 					const IS25mem_readConfig *	- read mode, dummy cycles and clock
+ * @Return value 	flash_err		- flash memory return value (MEMORY_ERROR or MEMORY_OK)
+ */
+flash_err IS25mem_readDataCfg(uint8_t *readBuffer,mem_address address, uint32_t size, const IS25mem_readConfig *cfg){
+	QSPI_CommandTypeDef memCmd;
+	flash_err err = MEMORY_OK;
+	uint8_t lines;
+
+	if((lines = IS25mem_readCommand(&memCmd, address, size, cfg)) == 0){
+		return MEMORY_ERROR;
+	}
+	if(IS25mem_setClock(cfg) != MEMORY_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, readBuffer, 100) != HAL_OK){
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		err = MEMORY_ERROR;
+	}else if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, lines)) != HAL_OK){
+		err = MEMORY_ERROR;
+	}
+
+	if(IS25mem_setClock(0) != MEMORY_OK){
+		err = MEMORY_ERROR;
+	}
+
+	return err;
+}
+
+/**
+ * IS25mem_readDataFast(uint8_t *readBuffer, mem_address address, uint32_t size)
+ *
+ * @Brief	Read with the active read configuration (IS25mem_setReadConfig), FR with 8 dummy cycles by default.
+ *
+ * @Return value 	flash_err		- flash memory return value (MEMORY_ERROR or MEMORY_OK)
+ */
+flash_err IS25mem_readDataFast(uint8_t *readBuffer,mem_address address, uint32_t size){
+	return IS25mem_readDataCfg(readBuffer, address, size, &read_config);
+}
+
+/**
+ * IS25mem_setReadConfig(const IS25mem_readConfig *cfg)
+ *
+ * @Brief	Activates a read configuration, e.g. the stored result of IS25cal_run. Prescaler and sample shift are only
+ * 			used by the configured reads (IS25mem_readDataFast, IS25mem_readDataCfg), all other commands keep the clock
+ * 			found in IS25mem_Init. Quad modes set the non-volatile QE bit if it is not set yet.
+ *
+ * @Parameter		const IS25mem_readConfig *	- configuration, magic and check word must be valid
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_setReadConfig(const IS25mem_readConfig *cfg){
+	extFlash_stat status;
+
+	if(cfg->magic != IS25_READCFG_MAGIC || cfg->mode > IS25_READ_1_4_4 || cfg->check != IS25mem_readConfigCheck(cfg)){
 		return MEMORY_ERROR;
 	}
 
+	if(cfg->mode == IS25_READ_1_1_4 || cfg->mode == IS25_READ_1_4_4){
+		if(IS25mem_readStatusReg(&status) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		if(!(status & 0x40)){
+			status = (status | 0x40) & 0xFC;
+			if(IS25mem_writeEnable() != MEMORY_OK || IS25mem_writeStatReg(&status) != MEMORY_OK){
+				return MEMORY_ERROR;
+			}
+			if(IS25mem_waitMemReady(IS25_TW_MAX_MS) != MEMORY_OK){
+				return MEMORY_ERROR;
+			}
+		}
+	}
+
+	read_config = *cfg;
+
 	return MEMORY_OK;
 }
 
+/**
+ * IS25mem_getReadConfig(IS25mem_readConfig *cfg)
+ *
+ * @Brief	Copy of the active read configuration, FR at the clock of IS25mem_Init until IS25mem_setReadConfig.
+ */
+void IS25mem_getReadConfig(IS25mem_readConfig *cfg){
+	*cfg = read_config;
+}
+
 /**
  * @Brief        	READ PRODUCT IDENTIFICATION (RDID, ABh)
  * @Description
@@ -266,10 +761,10 @@ flash_err IS25mem_readID(IS25mem_deviceID *id){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 1;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, id, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, id, IS25mem_timeoutMs(1, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -302,10 +797,10 @@ flash_err IS25mem_readProductId(IS25mem_Identification *productId){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 3;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, (uint8_t *)productId, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, (uint8_t *)productId, IS25mem_timeoutMs(3, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -342,7 +837,7 @@ flash_err IS25mem_releasePowerDown(void){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -385,7 +880,7 @@ flash_err IS25mem_DeepPowerDown(void){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -418,10 +913,10 @@ flash_err IS25mem_writeFctReg(extFlash_func *statFctVal){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 1;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Transmit(qspi_h, statFctVal, 100) != HAL_OK){
+	if(QSPI_TRANSMIT(qspi_h, statFctVal, IS25mem_timeoutMs(1, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -451,10 +946,10 @@ flash_err IS25mem_readFctReg(extFlash_func *fctReg){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 1;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Receive(qspi_h, fctReg, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, fctReg, IS25mem_timeoutMs(1, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -487,7 +982,7 @@ flash_err IS25mem_writeEnable(void){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -515,15 +1010,32 @@ flash_err IS25mem_writeDisable(void){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
 	return MEMORY_OK;
 }
 
+/**
+ * PAGE PROGRAM OPERATION (PP, 02h)
+ *
+ * @Brief	Programs up to 256 bytes inside one page and waits until the memory is ready. The Write Enable Latch must be
+ * 			set via IS25mem_writeEnable before. Data beyond the page end wraps around to the start of the page.
+ *
+ * @Parameter		uint8_t *		- bufferPointer
+ * 					mem_address 	- memory Address
+ * 					uint16_t		- size (1 ... 256)
+ * @Return value 	flash_err		- MEMORY_PROTECTED_ERR if the protect callback rejects the range
+ */
+flash_err IS25mem_pageProgramm(uint8_t *writeBuffer,mem_address address, uint16_t size){
+	IS25mem_busyTimer timer;
+	flash_err err = IS25mem_checkProtect(address, size);
+
+	if(err != MEMORY_OK){
+		return err;
+	}
 
-flash_err IS25mem_pageProgramm(uint8_t *writeBuffer,mem_address address, uint8_t size){
 	//Set QSPI CMD
 	QSPI_CommandTypeDef memCmd	= {0};
 	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
@@ -538,89 +1050,188 @@ flash_err IS25mem_pageProgramm(uint8_t *writeBuffer,mem_address address, uint8_t
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= size;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
-	if(HAL_QSPI_Transmit(qspi_h, writeBuffer, 100) != HAL_OK){
+	if(QSPI_TRANSMIT(qspi_h, writeBuffer, IS25mem_timeoutMs(size, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
-	//@TODO at the moment a workaround.
-	HAL_Delay(500);
-//	if (IS25mem_AutoPollingMemReady() != MEMORY_OK) {
-//		return MEMORY_ERROR;
-//	}
+	IS25mem_busyStart(&timer);
+	if (IS25mem_waitMemReady(IS25_TPP_MAX_MS) != MEMORY_OK) {
+		return MEMORY_ERROR;
+	}
+	IS25mem_reportWear(IS25_WEAR_PROGRAM, address, size, &timer);
 
 	return MEMORY_OK;
 }
 
 /**
- * WRITE STATUS REGISTER OPERATION (WRSR, 01h)
- * The Write Status Register (WRSR) instruction allows the user to enable or disable the block protection and Status
- * Register write protection features by writing “0”s or “1”s into the non-volatile BP3, BP2, BP1, BP0, and SRWD
- * bits. Also WRSR instruction allows the user to disable or enable quad operation by writing “0” or “1” into the nonvolatile
- * QE bit.
+ * QUAD INPUT PAGE PROGRAM OPERATION (PPQ, 38h)
  *
- * 	@Parameter 		extFlash_stat
- * 	@Return Value	flash_err
+ * @Brief	Same as IS25mem_pageProgramm with the data on four lines. The QE bit must be set.
+ *
+ * @Parameter		uint8_t *		- bufferPointer
+ * 					mem_address 	- memory Address
+ * 					uint16_t		- size (1 ... 256)
+ * @Return value 	flash_err		- MEMORY_PROTECTED_ERR if the protect callback rejects the range
  */
-flash_err IS25mem_writeStatReg(extFlash_stat *statRegVal){
+flash_err IS25mem_quadPageProgramm(uint8_t *writeBuffer,mem_address address, uint16_t size){
+	IS25mem_busyTimer timer;
+	flash_err err = IS25mem_checkProtect(address, size);
+
+	if(err != MEMORY_OK){
+		return err;
+	}
+
 	//Set QSPI CMD
 	QSPI_CommandTypeDef memCmd	= {0};
 	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
-	memCmd.Instruction 			= WRSR;
-	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.Instruction 			= PPQ;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
 	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
 	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
-	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+	memCmd.DataMode 			= QSPI_DATA_4_LINES;
 	memCmd.DummyCycles 			= 0;
-	memCmd.Address 				= 0;
+	memCmd.Address 				= address.val;
 	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
-	memCmd.NbData 				= 1;
+	memCmd.NbData 				= size;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	if(QSPI_TRANSMIT(qspi_h, writeBuffer, IS25mem_timeoutMs(size, 4)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
-	if(HAL_QSPI_Transmit(qspi_h, statRegVal, 100) != HAL_OK){
+
+	IS25mem_busyStart(&timer);
+	if (IS25mem_waitMemReady(IS25_TPP_MAX_MS) != MEMORY_OK) {
 		return MEMORY_ERROR;
 	}
+	IS25mem_reportWear(IS25_WEAR_PROGRAM, address, size, &timer);
 
 	return MEMORY_OK;
 }
 
 /**
- * READ STATUS REGISTER OPERATION (RDSR, 05h)
- * The Read Status Register (RDSR) instruction provides access to the Status Register. During the execution of a
- * program, erase or write Status Register operation, all other instructions will be ignored except the RDSR
- * instruction, which can be used to check the progress or completion of an operation by reading the WIP bit of
- * Status Register.
+ * IS25mem_programData(uint8_t *writeBuffer, mem_address address, uint32_t size)
  *
- * 	@Parameter 		extFlash_stat
- * 	@Return Value	flash_err
+ * @Brief	Programs any number of bytes. The data is split at page boundaries, every page gets its own write enable
+ * 			and WIP polling. Uses quad page program once a quad read configuration was activated (QE is set).
+ * 			The target range must be erased. A range rejected by the protect callback returns MEMORY_PROTECTED_ERR
+ * 			before anything is sent.
+ *
+ * @Parameter		uint8_t *		- bufferPointer
+ * 					mem_address 	- memory Address
+ * 					uint32_t		- size
+ * @Return value 	flash_err
  */
-flash_err IS25mem_readStatusReg(extFlash_stat *statReg){
-	//Set QSPI CMD
-	QSPI_CommandTypeDef memCmd	= {0};
-	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
-	memCmd.Instruction 			= RDSR;
-	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
-	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
-	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
-	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+flash_err IS25mem_programData(uint8_t *writeBuffer,mem_address address, uint32_t size){
+	uint8_t quad = (read_config.mode == IS25_READ_1_1_4 || read_config.mode == IS25_READ_1_4_4);
+	uint32_t chunk;
+	flash_err err;
+
+	err = IS25mem_checkProtect(address, size);
+	if(err != MEMORY_OK){
+		return err;
+	}
+
+	while(size > 0){
+		chunk = 256 - (address.val & 0xFF);
+		if(chunk > size){
+			chunk = size;
+		}
+
+		if(IS25mem_writeEnable() != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		err = quad ? IS25mem_quadPageProgramm(writeBuffer, address, (uint16_t)chunk)
+				   : IS25mem_pageProgramm(writeBuffer, address, (uint16_t)chunk);
+		if(err != MEMORY_OK){
+			return err;
+		}
+
+		writeBuffer	+= chunk;
+		address.val	+= chunk;
+		size		-= chunk;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * WRITE STATUS REGISTER OPERATION (WRSR, 01h)
+ * The Write Status Register (WRSR) instruction allows the user to enable or disable the block protection and Status
+ * Register write protection features by writing “0”s or “1”s into the non-volatile BP3, BP2, BP1, BP0, and SRWD
+ * bits. Also WRSR instruction allows the user to disable or enable quad operation by writing “0” or “1” into the nonvolatile
+ * QE bit.
+ *
+ * 	@Parameter 		extFlash_stat
+ * 	@Return Value	flash_err
+ */
+flash_err IS25mem_writeStatReg(extFlash_stat *statRegVal){
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= WRSR;
+	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
 	memCmd.DummyCycles 			= 0;
 	memCmd.Address 				= 0;
 	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 1;
 
-	HAL_StatusTypeDef spi_status = HAL_QSPI_Command(qspi_h, &memCmd, 100);
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_TRANSMIT(qspi_h, statRegVal, IS25mem_timeoutMs(1, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * READ STATUS REGISTER OPERATION (RDSR, 05h)
+ * The Read Status Register (RDSR) instruction provides access to the Status Register. During the execution of a
+ * program, erase or write Status Register operation, all other instructions will be ignored except the RDSR
+ * instruction, which can be used to check the progress or completion of an operation by reading the WIP bit of
+ * Status Register.
+ *
+ * 	@Parameter 		extFlash_stat
+ * 	@Return Value	flash_err
+ */
+flash_err IS25mem_readStatusReg(extFlash_stat *statReg){
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= RDSR;
+	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= 0;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 1;
+
+	HAL_StatusTypeDef spi_status = QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1));
 	if(spi_status != HAL_OK){
 		return MEMORY_ERROR;
 	}
 	HAL_Delay(5);
-	if(HAL_QSPI_Receive(qspi_h, statReg, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, statReg, IS25mem_timeoutMs(1, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -642,13 +1253,13 @@ flash_err IS25mem_reset(){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 1;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
 	memCmd.Instruction 			= RST;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
@@ -657,10 +1268,16 @@ flash_err IS25mem_reset(){
 }
 
 flash_err IS25mem_sectorErase(mem_address address){
+	flash_err err = IS25mem_checkErase(IS25_WEAR_SECTOR_ERASE, address);
+
+	if(err != MEMORY_OK){
+		return err;
+	}
+
 	//Set QSPI CMD
 	QSPI_CommandTypeDef memCmd	= {0};
 	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
-	memCmd.Instruction 			= 0xD7;
+	memCmd.Instruction 			= SER;
 	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
 	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
 	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
@@ -671,16 +1288,20 @@ flash_err IS25mem_sectorErase(mem_address address){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
+	//Register before polling starts, a short erase can match before we return
+	IS25mem_registerEraseDone(IS25_WEAR_SECTOR_ERASE, address);
+
 	if (IS25mem_AutoPollingMemReady() != MEMORY_OK) {
+		IS25mem_registerCallback(0);
 		return MEMORY_ERROR;
 	}
 
-	IS25mem_registerCallback(pEraseDoneCallback);
-
 	return MEMORY_OK;
 }
 
@@ -696,6 +1317,12 @@ flash_err IS25mem_sectorErase(mem_address address){
  * 	@Return Value	flash_err
  */
 flash_err IS25mem_blockErase(mem_address address){
+	flash_err err = IS25mem_checkErase(IS25_WEAR_BLOCK_ERASE, address);
+
+	if(err != MEMORY_OK){
+		return err;
+	}
+
 	//Set QSPI CMD
 	QSPI_CommandTypeDef memCmd	= {0};
 	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
@@ -710,16 +1337,20 @@ flash_err IS25mem_blockErase(mem_address address){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	IS25mem_adaptAddressing(&memCmd);
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
+	//Register before polling starts, a short erase can match before we return
+	IS25mem_registerEraseDone(IS25_WEAR_BLOCK_ERASE, address);
+
 	if (IS25mem_AutoPollingMemReady() != MEMORY_OK) {
+		IS25mem_registerCallback(0);
 		return MEMORY_ERROR;
 	}
 
-	IS25mem_registerCallback(pEraseDoneCallback);
-
 	return MEMORY_OK;
 }
 
@@ -734,6 +1365,12 @@ flash_err IS25mem_blockErase(mem_address address){
  * 	@Return Value	flash_err
  */
 flash_err IS25mem_chipErase(mem_address address){
+	flash_err err = IS25mem_checkErase(IS25_WEAR_CHIP_ERASE, address);
+
+	if(err != MEMORY_OK){
+		return err;
+	}
+
 	//Set QSPI CMD
 	QSPI_CommandTypeDef memCmd	= {0};
 	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
@@ -748,17 +1385,19 @@ flash_err IS25mem_chipErase(mem_address address){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 0;
 
-	uint8_t testVal = HAL_QSPI_Command(qspi_h, &memCmd, 100);
+	uint8_t testVal = QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1));
 	if(testVal != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
+	//Register before polling starts, a short erase can match before we return
+	IS25mem_registerEraseDone(IS25_WEAR_CHIP_ERASE, address);
+
 	if (IS25mem_AutoPollingMemReady() != MEMORY_OK) {
+		IS25mem_registerCallback(0);
 		return MEMORY_ERROR;
 	}
 
-	IS25mem_registerCallback(pEraseDoneCallback);
-
 	return MEMORY_OK;
 }
 
@@ -787,11 +1426,11 @@ flash_err IS25mem_readUid(uint8_t *UID){
 	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
 	memCmd.NbData 				= 16;
 
-	if(HAL_QSPI_Command(qspi_h, &memCmd, 100) != HAL_OK){
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
-	if(HAL_QSPI_Receive(qspi_h, UID, 100) != HAL_OK){
+	if(QSPI_RECEIVE(qspi_h, UID, IS25mem_timeoutMs(16, 1)) != HAL_OK){
 		return MEMORY_ERROR;
 	}
 	return MEMORY_OK;
@@ -830,13 +1469,443 @@ flash_err IS25mem_AutoPollingMemReady(void){
 	s_config.AutomaticStop   = QSPI_AUTOMATIC_STOP_ENABLE;
 
 
-	if (HAL_QSPI_AutoPolling_IT(qspi_h, &memCmd, &s_config) != HAL_OK){
+	if (QSPI_AUTOPOLLING_IT(qspi_h, &memCmd, &s_config) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+
+
+
+
+/**
+ * IS25mem_timeoutMs(uint32_t size, uint8_t lines)
+ *
+ * @Brief
+ * 		Timeout for a transfer of size bytes over the given number of data lines, derived from HCLK and the QSPI
+ * 		prescaler. Twice the transfer time plus command overhead, plus IS25_TIMEOUT_MARGIN_MS for the tick granularity.
+ *
+ * 	@Parameter 		uint32_t	- bytes
+ * 					uint8_t		- data lines (1, 2 or 4)
+ * 	@Return Value	uint32_t	- timeout in ms
+ */
+uint32_t IS25mem_timeoutMs(uint32_t size, uint8_t lines){
+	uint32_t sclk	= HAL_RCC_GetHCLKFreq() / ((qspi_h != 0 ? qspi_h->Init.ClockPrescaler : 255) + 1);
+	//Instruction, 4 byte address, mode bits and dummy cycles in the worst case
+	uint64_t cycles	= 8 + 32 + 8 + 16 + ((uint64_t)size * 8) / (lines ? lines : 1);
+
+	if(sclk == 0){
+		return 100;
+	}
+	return (uint32_t)((2 * cycles * 1000) / sclk) + IS25_TIMEOUT_MARGIN_MS;
+}
+
+/**
+ * IS25mem_waitMemReady(uint32_t timeout)
+ *
+ * @Brief
+ * 		Blocking counterpart of IS25mem_AutoPollingMemReady, returns when the WIP bit is cleared.
+ *
+ * 	@Parameter 		uint32_t	- timeout in ms, use the IS25_Txx_MAX_MS of the operation
+ * 	@Return Value	flash_err	- MEMORY_TIMEOUT if the memory is still busy
+ */
+flash_err IS25mem_waitMemReady(uint32_t timeout){
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= RDSR;
+	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= 0;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	QSPI_AutoPollingTypeDef s_config = {0};
+	s_config.Match           = 0;
+	s_config.Mask            = 0x01;
+	s_config.MatchMode       = QSPI_MATCH_MODE_AND;
+	s_config.StatusBytesSize = 1;
+	s_config.Interval        = 0x10;
+	s_config.AutomaticStop   = QSPI_AUTOMATIC_STOP_ENABLE;
+
+	HAL_StatusTypeDef spi_status = QSPI_AUTOPOLLING(qspi_h, &memCmd, &s_config, timeout + IS25_TIMEOUT_MARGIN_MS);
+	if(spi_status == HAL_TIMEOUT){
+		return MEMORY_TIMEOUT;
+	}
+	if(spi_status != HAL_OK){
 		return MEMORY_ERROR;
 	}
 
 	return MEMORY_OK;
 }
 
+/**
+ * IS25mem_sectorEraseWait(mem_address address)
+ *
+ * @Brief
+ * 		Blocking sector erase including write enable, for callers which can not use the erase done callback.
+ * 		MEMORY_PROTECTED_ERR if the protect callback rejects the sector, nothing is sent then.
+ *
+ * 	@Parameter 		mem_address
+ * 	@Return Value	flash_err
+ */
+flash_err IS25mem_sectorEraseWait(mem_address address){
+	IS25mem_busyTimer timer;
+	flash_err err;
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= SER;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= address.val;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	IS25mem_adaptAddressing(&memCmd);
+
+	err = IS25mem_checkErase(IS25_WEAR_SECTOR_ERASE, address);
+	if(err != MEMORY_OK){
+		return err;
+	}
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	IS25mem_busyStart(&timer);
+	err = IS25mem_waitMemReady(IS25_TSE_MAX_MS);
+	if(err == MEMORY_OK){
+		IS25mem_reportWear(IS25_WEAR_SECTOR_ERASE, address, 4096UL, &timer);
+	}
+	return err;
+}
+
+/**
+ * IS25mem_blockEraseWait(mem_address address)
+ *
+ * @Brief
+ * 		Blocking 64 kByte block erase including write enable. MEMORY_PROTECTED_ERR if the protect callback rejects
+ * 		the block.
+ *
+ * 	@Parameter 		mem_address
+ * 	@Return Value	flash_err
+ */
+flash_err IS25mem_blockEraseWait(mem_address address){
+	IS25mem_busyTimer timer;
+	flash_err err;
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= BER64;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= address.val;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	IS25mem_adaptAddressing(&memCmd);
+
+	err = IS25mem_checkErase(IS25_WEAR_BLOCK_ERASE, address);
+	if(err != MEMORY_OK){
+		return err;
+	}
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	IS25mem_busyStart(&timer);
+	err = IS25mem_waitMemReady(IS25_TBE_MAX_MS);
+	if(err == MEMORY_OK){
+		IS25mem_reportWear(IS25_WEAR_BLOCK_ERASE, address, 65536UL, &timer);
+	}
+	return err;
+}
+
+/**
+ * IS25mem_chipEraseWait(void)
+ *
+ * @Brief
+ * 		Blocking chip erase including write enable. The timeout is the block erase maximum of every 64 kByte block.
+ * 		MEMORY_PROTECTED_ERR if the protect callback rejects any part of the memory (the device ignores a chip erase
+ * 		while any BP bit is set).
+ *
+ * 	@Return Value	flash_err
+ */
+flash_err IS25mem_chipEraseWait(void){
+	IS25mem_busyTimer timer;
+	mem_address address = {0};
+	flash_err err;
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= CER;
+	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= 0;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	err = IS25mem_checkErase(IS25_WEAR_CHIP_ERASE, address);
+	if(err != MEMORY_OK){
+		return err;
+	}
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	IS25mem_busyStart(&timer);
+	err = IS25mem_waitMemReady((memory_space.blocks64 ? memory_space.blocks64 : 1) * IS25_TBE_MAX_MS);
+	if(err == MEMORY_OK){
+		IS25mem_reportWear(IS25_WEAR_CHIP_ERASE, address, memory_space.bytes, &timer);
+	}
+	return err;
+}
+
+/**
+ * SECTOR UNLOCK OPERATION (SECUNLOCK, 26h)
+ *
+ * @Brief	Allows program and erase of one sector inside the block protected area, without a write cycle of the status
+ * 			register. Only one sector can be unlocked, a new SECUNLOCK or SECLOCK ends it. Sends the write enable
+ * 			itself. The command has a 3 byte address, parts above 16 MByte are not supported.
+ *
+ * @Parameter		mem_address 	- address inside the sector
+ * @Return value 	flash_err		- MEMORY_WRONG_CPACITY_ERR on 4 byte address parts
+ */
+flash_err IS25mem_sectorUnlock(mem_address address){
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= SECUNLOCK;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= address.val & ~0xFFFUL;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	if(memory_space.addressBytes == 4){
+		return MEMORY_WRONG_CPACITY_ERR;
+	}
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * SECTOR LOCK OPERATION (SECLOCK, 24h)
+ *
+ * @Brief	Ends a SECUNLOCK, the block protection applies to all sectors again.
+ *
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_sectorLock(void){
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= SECLOCK;
+	memCmd.AddressMode 			= QSPI_ADDRESS_NONE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= 0;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * READ INFORMATION ROW OPERATION (IRRD, 68h)
+ *
+ * @Brief	Reads from one of the four 256 byte information rows. Like FR the command needs 8 dummy cycles.
+ * 			The information rows always use a 3 byte address, IS25mem_adaptAddressing is not applied.
+ *
+ * @Parameter		uint8_t *		- bufferPointer
+ * 					uint8_t			- row 0 ... IS25_IR_ROWS - 1
+ * 					uint8_t			- offset inside the row
+ * 					uint16_t		- size, offset + size <= IS25_IR_SIZE
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_readInfoRow(uint8_t *readBuffer, uint8_t row, uint8_t offset, uint16_t size){
+	if(row >= IS25_IR_ROWS || size == 0 || offset + size > IS25_IR_SIZE){
+		return MEMORY_ERROR;
+	}
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= IRRD;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+	memCmd.DummyCycles 			= 8;
+	memCmd.Address 				= IS25_IR_ADDR(row) + offset;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= size;
+
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_RECEIVE(qspi_h, readBuffer, IS25mem_timeoutMs(size, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * PROGRAM INFORMATION ROW OPERATION (IRP, 62h)
+ *
+ * @Brief	Programs bytes of an information row including write enable and waits for the end of the program cycle.
+ * 			Like a page program it can only clear bits, a locked row is not changed.
+ *
+ * @Parameter		uint8_t *		- bufferPointer
+ * 					uint8_t			- row 0 ... IS25_IR_ROWS - 1
+ * 					uint8_t			- offset inside the row
+ * 					uint16_t		- size, offset + size <= IS25_IR_SIZE
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_programInfoRow(uint8_t *writeBuffer, uint8_t row, uint8_t offset, uint16_t size){
+	if(row >= IS25_IR_ROWS || size == 0 || offset + size > IS25_IR_SIZE){
+		return MEMORY_ERROR;
+	}
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= IRP;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= IS25_IR_ADDR(row) + offset;
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= size;
+
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_TRANSMIT(qspi_h, writeBuffer, IS25mem_timeoutMs(size, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return IS25mem_waitMemReady(IS25_TPP_MAX_MS);
+}
+
+/**
+ * ERASE INFORMATION ROW OPERATION (IRER, 64h)
+ *
+ * @Brief	Erases one information row including write enable and waits like a sector erase.
+ *
+ * @Parameter		uint8_t			- row 0 ... IS25_IR_ROWS - 1
+ * @Return value 	flash_err
+ */
+flash_err IS25mem_eraseInfoRow(uint8_t row){
+	if(row >= IS25_IR_ROWS){
+		return MEMORY_ERROR;
+	}
+
+	//Set QSPI CMD
+	QSPI_CommandTypeDef memCmd	= {0};
+	memCmd.InstructionMode 		= QSPI_INSTRUCTION_1_LINE;
+	memCmd.Instruction 			= IRER;
+	memCmd.AddressMode 			= QSPI_ADDRESS_1_LINE;
+	memCmd.AddressSize 			= QSPI_ADDRESS_24_BITS;
+	memCmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd.DataMode 			= QSPI_DATA_NONE;
+	memCmd.DummyCycles 			= 0;
+	memCmd.Address 				= IS25_IR_ADDR(row);
+	memCmd.DdrMode 				= QSPI_DDR_MODE_DISABLE;
+	memCmd.SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+	memCmd.NbData 				= 0;
+
+	if(IS25mem_writeEnable() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(QSPI_COMMAND(qspi_h, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return MEMORY_ERROR;
+	}
+
+	return IS25mem_waitMemReady(IS25_TSE_MAX_MS);
+}
+
+/**
+ * IS25mem_crc32(uint32_t crc, const uint8_t *data, uint32_t size)
+ *
+ * @Brief
+ * 		CRC-32 (IEEE 802.3) with a 16 entry table, can be fed in chunks. Start with crc = 0.
+ *
+ * 	@Parameter 		uint32_t		- crc of the previous chunks
+ * 					const uint8_t *	- data
+ * 					uint32_t		- size
+ * 	@Return Value	uint32_t		- crc including this chunk
+ */
+uint32_t IS25mem_crc32(uint32_t crc, const uint8_t *data, uint32_t size){
+	static const uint32_t table[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+
+	crc = ~crc;
+	while(size--){
+		crc ^= *data++;
+		crc = (crc >> 4) ^ table[crc & 0x0F];
+		crc = (crc >> 4) ^ table[crc & 0x0F];
+	}
+	return ~crc;
+}
+
 
 
 
@@ -10,6 +10,7 @@
 #ifndef INC_IS25LQ040B_EXT_MEM_H_
 #define INC_IS25LQ040B_EXT_MEM_H_
 
+#include <stddef.h>
 #include "stm32l4xx_hal.h"
 
 /**
@@ -47,9 +48,44 @@
 #define RST						0x99						// Reset
 #define IRP						0x62						// Program Information Row
 #define IRRD					0x68						// Read Information Row
+#define IRER					0x64						// Erase Information Row
 #define SECUNLOCK				0x26						// Sector Unlock
 #define SECLOCK					0x24						// Sector Lock
 
+//4 byte address instructions of the parts above 16 MByte
+#define RD4						0x13						// Read Data with 4 byte address
+#define FR4						0x0C						// Fast Read with 4 byte address
+#define FRDO4					0x3C						// Fast Read Dual Output with 4 byte address
+#define FRDIO4					0xBC						// Fast Read Dual I/O with 4 byte address
+#define FRQO4					0x6C						// Fast Read Quad Output with 4 byte address
+#define FRQIO4					0xEC						// Fast Read Quad I/O with 4 byte address
+#define PP4						0x12						// Page program with 4 byte address
+#define PPQ4					0x34						// Quad input page program with 4 byte address
+#define SER4					0x21						// Sector erase 4Kb with 4 byte address
+#define BER32_4					0x5C						// Block erase 32Kb with 4 byte address
+#define BER64_4					0xDC						// Block erase 64Kb with 4 byte address
+
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+/**
+ * 						Maximum operation times (datasheet worst case)
+ */
+#define IS25_TPP_MAX_MS			2							// Page program
+#define IS25_TSE_MAX_MS			300							// Sector erase 4Kb
+#define IS25_TBE_MAX_MS			1000						// Block erase 64Kb
+#define IS25_TW_MAX_MS			15							// Write status / function register
+#define IS25_TIMEOUT_MARGIN_MS	2							// Added to derived timeouts, covers the HAL tick granularity
+#define IS25_ABORT_POLLS		1000						// Status register polls of the abort in IS25mem_setClockIT
+
+#ifndef IS25_BUSY_CYCLES
+#define IS25_BUSY_CYCLES()		(DWT->CYCCNT)				// Busy time source, (0) measures in HAL ticks only
+#define IS25_BUSY_CYCLES_ENABLE()	do{ CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; }while(0)
+#endif
+
+#ifndef IS25_BUSY_CYCLES_ENABLE
+#define IS25_BUSY_CYCLES_ENABLE()							// Starts the busy time source, called by IS25mem_Init
+#endif
+
 /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
 
 /**
@@ -61,7 +97,8 @@ typedef enum
   MEMORY_ERROR    			= 0x01,
   MEMORY_BUSY     			= 0x02,
   MEMORY_TIMEOUT  			= 0x03,
-  MEMORY_WRONG_CPACITY_ERR 	= 0x04
+  MEMORY_WRONG_CPACITY_ERR 	= 0x04,
+  MEMORY_PROTECTED_ERR		= 0x05		// Range is block protected, nothing was sent
 } flash_err;
 
 
@@ -104,7 +141,8 @@ typedef uint8_t flash_bwp_t;
 /* External Flash Memory Function Register
  *
  * BIT		7		 6			5		4		3	 2		1		0
- * 		|IR Lock3|IR Lock2|IR Lock1|IR Lock0| ESUS| PSUS|	R	|	R	|	R=Reserved
+ * 		|IR Lock3|IR Lock2|IR Lock1|IR Lock0| ESUS| PSUS|  TBS	|	R	|	R=Reserved
+ * 			 |		 |			|		|		|	 |		|->	Top / bottom selection (OTP), "1" BP protects from address 0
  * 			 |		 |			|		|		|	 |-> 	Program suspend bit
  * 			 |		 |			|		|		|------>	Erase suspend bit
  * 			 |		 |			|		|--------------> 	Lock the Information Row 0
@@ -114,6 +152,12 @@ typedef uint8_t flash_bwp_t;
  */
 typedef uint8_t	extFlash_func;
 
+#define IR_LOCK(row)			(0x10 << (row))				// Function register lock bit of an information row (OTP)
+
+#define IS25_IR_ROWS			4							// Information rows of 256 bytes
+#define IS25_IR_SIZE			256
+#define IS25_IR_ADDR(row)		((uint32_t)(row) << 12)		// Row n at 0x00n000
+
 /**
  * Manufacturer ID 		|									(MF7-MF0)									|
  * ISSI Serial Flash 	| 									   9Dh										|
@@ -124,6 +168,7 @@ typedef uint8_t	extFlash_func;
  * 1Mb 					|					10h 				|					4011h				|
  * 512K 				|					05h 				|					4010h				|
  * 256K 				|					02h 				|					4009h				|
+ * 8Mb ... 512Mb		|										|	Capacity 14h ... 1Ah = 2^Capacity Bytes	|
  *
  */
 typedef uint8_t IS25mem_ManfID;
@@ -139,27 +184,77 @@ typedef struct{
 typedef union{
 	struct{
 		uint32_t	sectorBytes:12;		// Bytes inside a sector
-		uint32_t	sector:8;			// Memory Sector	(4  kByte)
-		uint32_t 	undefined:4;		// Not used
+		uint32_t	sector:20;			// Memory Sector	(4  kByte)
 		};
 	uint32_t val;				// address value
 }mem_address;
 
+/**
+ * Read configuration, the result of the read calibration (IS25cal_run). 8 bytes, can be stored as is.
+ */
+typedef enum{
+	IS25_READ_1_1_1			= 0x00,		// FR	 0Bh	instruction - address - data lines
+	IS25_READ_1_1_2			= 0x01,		// FRDO	 3Bh
+	IS25_READ_1_2_2			= 0x02,		// FRDIO BBh
+	IS25_READ_1_1_4			= 0x03,		// FRQO	 6Bh
+	IS25_READ_1_4_4			= 0x04		// FRQIO EBh
+}IS25mem_readMode;
+
+#define IS25_READCFG_MAGIC		0xA5
+
+typedef struct{
+	uint8_t		magic;				// IS25_READCFG_MAGIC
+	uint8_t		mode;				// IS25mem_readMode
+	uint8_t		dummyCycles;		// Dummy cycles after address / mode bits
+	uint8_t		prescaler;			// QSPI ClockPrescaler
+	uint8_t		sampleShift;		// "1" QSPI_SAMPLE_SHIFTING_HALFCYCLE
+	uint8_t		reserved;
+	uint16_t	check;				// IS25mem_readConfigCheck
+}IS25mem_readConfig;
+
+/**
+ * Program / erase report, see IS25mem_setWearCallback
+ */
+typedef enum{
+	IS25_WEAR_PROGRAM		= 0x00,		// One page program, size = bytes
+	IS25_WEAR_SECTOR_ERASE	= 0x01,		// size = 4 kByte
+	IS25_WEAR_BLOCK_ERASE	= 0x02,		// size = 64 kByte
+	IS25_WEAR_CHIP_ERASE	= 0x03		// size = memory size
+}IS25mem_wearOp;
+
+typedef struct{
+	uint32_t	cycles;				// IS25_BUSY_CYCLES at the start
+	uint32_t	tick;				// HAL_GetTick at the start
+}IS25mem_busyTimer;
+
 typedef struct{
-	uint8_t		blocks64;
-	uint8_t		blocks32;
-	uint8_t		sectors;
+	uint32_t	blocks64;
+	uint32_t	blocks32;
+	uint32_t	sectors;
+	uint32_t	bytes;				// Memory size in bytes
+	uint8_t		addressBytes;		// 3, or 4 for parts above 16 MByte
 }IS25mem_MemorySpace;
 
 
 //External function declaration
 
 extern void (*autoPollingCallback)(void);
+extern void (*pEraseDoneCallback);
 
 //Functions to register the Callbacks.
 extern void setEraseDoneCallbackFct(void (*fct));
+extern void IS25mem_setWearCallback(void (*fct)(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs));
+extern void IS25mem_setChangeCallback(void (*fct)(mem_address address, uint32_t size));
+extern void IS25mem_setProtectCallback(flash_err (*fct)(mem_address address, uint32_t size));
+extern flash_err IS25mem_checkProtect(mem_address address, uint32_t size);
+extern void IS25mem_reportWear(IS25mem_wearOp op, mem_address address, uint32_t size, const IS25mem_busyTimer *timer);
+extern void IS25mem_busyStart(IS25mem_busyTimer *timer);
+extern uint32_t IS25mem_busyUs(const IS25mem_busyTimer *timer);
 
 extern flash_err IS25mem_Init(QSPI_HandleTypeDef *qSPIHandler);
+extern const IS25mem_MemorySpace *IS25mem_getMemorySpace(void);
+extern QSPI_HandleTypeDef *IS25mem_getQspiHandle(void);
+extern void IS25mem_adaptAddressing(QSPI_CommandTypeDef *memCmd);
 extern flash_err IS25mem_reset(void);
 extern flash_err IS25mem_writeEnable(void);
 extern flash_err IS25mem_sectorErase(mem_address address);
@@ -174,7 +269,29 @@ extern flash_err IS25mem_writeStatReg(extFlash_stat *statRegVal);
 extern flash_err IS25mem_readData(uint8_t *readBuffer,mem_address address, uint16_t size);
 extern flash_err IS25mem_fastReadData(uint8_t *readBuffer,mem_address address, uint16_t size);
 extern flash_err IS25mem_QuadFastReadData(uint8_t *readBuffer,mem_address address, uint8_t size);
-extern flash_err IS25mem_pageProgramm(uint8_t *writeBuffer,mem_address address, uint8_t size);
+extern flash_err IS25mem_pageProgramm(uint8_t *writeBuffer,mem_address address, uint16_t size);
+extern flash_err IS25mem_blockErase(mem_address address);
 extern flash_err IS25mem_chipErase(mem_address address);
+extern flash_err IS25mem_sectorEraseWait(mem_address address);
+extern flash_err IS25mem_blockEraseWait(mem_address address);
+extern flash_err IS25mem_chipEraseWait(void);
+extern flash_err IS25mem_sectorUnlock(mem_address address);
+extern flash_err IS25mem_sectorLock(void);
+extern flash_err IS25mem_quadPageProgramm(uint8_t *writeBuffer,mem_address address, uint16_t size);
+extern flash_err IS25mem_programData(uint8_t *writeBuffer,mem_address address, uint32_t size);
+extern flash_err IS25mem_waitMemReady(uint32_t timeout);
+extern uint32_t IS25mem_timeoutMs(uint32_t size, uint8_t lines);
+extern flash_err IS25mem_setClock(const IS25mem_readConfig *cfg);
+extern flash_err IS25mem_setClockIT(const IS25mem_readConfig *cfg);
+extern uint8_t IS25mem_readCommand(QSPI_CommandTypeDef *memCmd, mem_address address, uint32_t size, const IS25mem_readConfig *cfg);
+extern flash_err IS25mem_readDataCfg(uint8_t *readBuffer,mem_address address, uint32_t size, const IS25mem_readConfig *cfg);
+extern flash_err IS25mem_readDataFast(uint8_t *readBuffer,mem_address address, uint32_t size);
+extern flash_err IS25mem_setReadConfig(const IS25mem_readConfig *cfg);
+extern void IS25mem_getReadConfig(IS25mem_readConfig *cfg);
+extern uint16_t IS25mem_readConfigCheck(const IS25mem_readConfig *cfg);
+extern flash_err IS25mem_readInfoRow(uint8_t *readBuffer, uint8_t row, uint8_t offset, uint16_t size);
+extern flash_err IS25mem_programInfoRow(uint8_t *writeBuffer, uint8_t row, uint8_t offset, uint16_t size);
+extern flash_err IS25mem_eraseInfoRow(uint8_t row);
+extern uint32_t IS25mem_crc32(uint32_t crc, const uint8_t *data, uint32_t size);
 
 #endif /* INC_IS25LQ040B_EXT_MEM_H_ */
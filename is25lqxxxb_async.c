@@ -0,0 +1,643 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB non-blocking request queue
+ *
+ */
+
+//Includes
+#include "is25lqxxxb_async.h"
+#include "is25lqxxxb_trace.h"
+
+#define QUEUE_MASK				(IS25ASYNC_QUEUE_DEPTH - 1)
+
+#if (IS25ASYNC_QUEUE_DEPTH & QUEUE_MASK) != 0
+#error "IS25ASYNC_QUEUE_DEPTH must be a power of two"
+#endif
+
+//Private variables
+static IS25async_request		queue[IS25ASYNC_QUEUE_DEPTH];
+static volatile uint8_t			queueHead		= 0;
+static volatile uint8_t			queueTail		= 0;			// Slot of the oldest queued request
+static IS25async_request		*active			= 0;			// Running request, a queue slot or suspendedReq
+
+static volatile IS25async_state	state			= IS25_STATE_IDLE;
+static uint32_t					progress		= 0;			// Bytes of the running request already transferred
+static uint32_t					chunk			= 0;			// Bytes of the running data phase
+static IS25mem_busyTimer		busyTimer		= {0};			// Start of the running poll, for the wear report
+
+// Erase suspend, the suspended erase leaves the queue until it is resumed
+static IS25async_request		suspendedReq;
+static volatile uint8_t			suspended		= 0;
+static volatile uint8_t			suspendRequested = 0;			// Suspend as soon as the erase command is done
+static IS25mem_busyTimer		suspendTimer	= {0};			// Start of the suspension, not counted as busy time
+
+// Requests failed while IS25async_submit holds the critical section, their callbacks run after it is left
+typedef struct{
+	IS25async_callback			callback;
+	void						*context;
+	flash_err					result;
+}IS25async_done;
+
+static IS25async_done			*deferred		= 0;			// IS25ASYNC_QUEUE_DEPTH + 1 entries
+static uint8_t					deferredCnt		= 0;
+
+//function prototypes
+static void IS25async_start(void);
+static void IS25async_finish(flash_err result);
+
+
+/**
+ * IS25async_initCmd(QSPI_CommandTypeDef *memCmd, uint8_t instruction)
+ *
+ * @Brief
+ * 		Single line command without address and data, the callers add the phases they need.
+ */
+static void IS25async_initCmd(QSPI_CommandTypeDef *memCmd, uint8_t instruction){
+	*memCmd						= (QSPI_CommandTypeDef){0};
+	memCmd->InstructionMode 	= QSPI_INSTRUCTION_1_LINE;
+	memCmd->Instruction 		= instruction;
+	memCmd->AddressMode 		= QSPI_ADDRESS_NONE;
+	memCmd->AddressSize 		= QSPI_ADDRESS_24_BITS;
+	memCmd->AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;
+	memCmd->DataMode 			= QSPI_DATA_NONE;
+	memCmd->DummyCycles 		= 0;
+	memCmd->DdrMode 			= QSPI_DDR_MODE_DISABLE;
+	memCmd->SIOOMode 			= QSPI_SIOO_INST_EVERY_CMD;
+}
+
+/**
+ * IS25async_sendWren(void)
+ *
+ * @Brief
+ * 		Write enable, completes with the command complete interrupt.
+ */
+static HAL_StatusTypeDef IS25async_sendWren(void){
+	QSPI_CommandTypeDef memCmd;
+
+	IS25async_initCmd(&memCmd, WREN);
+	state = IS25_STATE_WREN;
+
+	return QSPI_COMMAND_IT(IS25mem_getQspiHandle(), &memCmd);
+}
+
+/**
+ * IS25async_sendPoll(IS25async_state next)
+ *
+ * @Brief
+ * 		Auto polling of the WIP bit, completes with the status match interrupt.
+ */
+static HAL_StatusTypeDef IS25async_sendPoll(IS25async_state next){
+	QSPI_CommandTypeDef memCmd;
+	QSPI_AutoPollingTypeDef s_config = {0};
+
+	IS25async_initCmd(&memCmd, RDSR);
+	memCmd.DataMode 			= QSPI_DATA_1_LINE;
+
+	s_config.Match           	= 0;
+	s_config.Mask            	= 0x01;
+	s_config.MatchMode       	= QSPI_MATCH_MODE_AND;
+	s_config.StatusBytesSize 	= 1;
+	s_config.Interval        	= 0x10;
+	s_config.AutomaticStop   	= QSPI_AUTOMATIC_STOP_ENABLE;
+
+	state = next;
+
+	return QSPI_AUTOPOLLING_IT(IS25mem_getQspiHandle(), &memCmd, &s_config);
+}
+
+/**
+ * IS25async_sendOperation(void)
+ *
+ * @Brief
+ * 		Main command of the running request. Commands with a data phase complete with rx/tx complete, erases with
+ * 		command complete. Reads use the active read configuration (IS25mem_setReadConfig) and its clock, the base
+ * 		clock is restored when the request finishes.
+ */
+static HAL_StatusTypeDef IS25async_sendOperation(void){
+	QSPI_HandleTypeDef *qspi	= IS25mem_getQspiHandle();
+	IS25async_request *req		= active;
+	QSPI_CommandTypeDef memCmd;
+	IS25mem_readConfig cfg;
+	uint32_t address			= req->address.val + progress;
+	mem_address readAddress		= {.val = address};
+
+	switch(req->op){
+		case IS25_REQ_READ:
+			IS25mem_getReadConfig(&cfg);
+			chunk				= req->size;
+			if(IS25mem_readCommand(&memCmd, readAddress, chunk, &cfg) == 0 || IS25mem_setClockIT(&cfg) != MEMORY_OK){
+				return HAL_ERROR;
+			}
+			break;
+		case IS25_REQ_PROGRAM:
+			IS25async_initCmd(&memCmd, PP);
+			memCmd.AddressMode 	= QSPI_ADDRESS_1_LINE;
+			memCmd.DataMode 	= QSPI_DATA_1_LINE;
+			//Never cross a page boundary, the memory would wrap inside the page
+			chunk				= IS25_PAGE_SIZE - (address % IS25_PAGE_SIZE);
+			if(chunk > req->size - progress){
+				chunk			= req->size - progress;
+			}
+			break;
+		case IS25_REQ_READ_STATUS:
+			IS25async_initCmd(&memCmd, RDSR);
+			memCmd.DataMode 	= QSPI_DATA_1_LINE;
+			chunk				= 1;
+			break;
+		case IS25_REQ_READ_ID:
+			IS25async_initCmd(&memCmd, RDJDID);
+			memCmd.DataMode 	= QSPI_DATA_1_LINE;
+			chunk				= 3;
+			break;
+		case IS25_REQ_SECTOR_ERASE:
+			IS25async_initCmd(&memCmd, SER);
+			memCmd.AddressMode 	= QSPI_ADDRESS_1_LINE;
+			break;
+		case IS25_REQ_BLOCK_ERASE:
+			IS25async_initCmd(&memCmd, BER64);
+			memCmd.AddressMode 	= QSPI_ADDRESS_1_LINE;
+			break;
+		case IS25_REQ_CHIP_ERASE:
+			IS25async_initCmd(&memCmd, CER);
+			break;
+		default:
+			return HAL_ERROR;
+	}
+
+	if(req->op != IS25_REQ_READ){
+		memCmd.Address = address;
+		if(memCmd.AddressMode != QSPI_ADDRESS_NONE){
+			IS25mem_adaptAddressing(&memCmd);
+		}
+	}
+
+	if(memCmd.DataMode == QSPI_DATA_NONE){
+		state = IS25_STATE_CMD;
+		return QSPI_COMMAND_IT(qspi, &memCmd);
+	}
+
+	//With a data phase the command is only latched, the transfer starts with the data
+	memCmd.NbData 	= chunk;
+	state			= IS25_STATE_DATA;
+	if(QSPI_COMMAND(qspi, &memCmd, IS25mem_timeoutMs(0, 1)) != HAL_OK){
+		return HAL_ERROR;
+	}
+	if(req->op == IS25_REQ_PROGRAM){
+		return QSPI_TRANSMIT_IT(qspi, req->buffer + progress);
+	}
+	return QSPI_RECEIVE_IT(qspi, req->buffer + progress);
+}
+
+/**
+ * IS25async_suspendable(const IS25async_request *req)
+ *
+ * @return
+ * 		uint8_t		- "1" for the erases the memory can suspend (sector and block, not chip erase)
+ */
+static uint8_t IS25async_suspendable(const IS25async_request *req){
+	return req->op == IS25_REQ_SECTOR_ERASE || req->op == IS25_REQ_BLOCK_ERASE;
+}
+
+/**
+ * IS25async_checkProtect(const IS25async_request *req)
+ *
+ * @return
+ * 		flash_err	- protect callback of the driver for the range a program / erase writes, MEMORY_OK otherwise
+ */
+static flash_err IS25async_checkProtect(const IS25async_request *req){
+	mem_address address = req->address;
+
+	switch(req->op){
+		case IS25_REQ_PROGRAM:
+			return IS25mem_checkProtect(address, req->size);
+		case IS25_REQ_SECTOR_ERASE:
+			address.val &= ~0xFFFUL;
+			return IS25mem_checkProtect(address, 4096UL);
+		case IS25_REQ_BLOCK_ERASE:
+			address.val &= ~0xFFFFUL;
+			return IS25mem_checkProtect(address, 65536UL);
+		case IS25_REQ_CHIP_ERASE:
+			address.val = 0;
+			return IS25mem_checkProtect(address, IS25mem_getMemorySpace()->bytes);
+		default:
+			return MEMORY_OK;
+	}
+}
+
+/**
+ * IS25async_readOnly(const IS25async_request *req)
+ *
+ * @return
+ * 		uint8_t		- "1" for the requests which may run while an erase is suspended
+ */
+static uint8_t IS25async_readOnly(const IS25async_request *req){
+	return req->op == IS25_REQ_READ || req->op == IS25_REQ_READ_STATUS || req->op == IS25_REQ_READ_ID;
+}
+
+/**
+ * IS25async_sendSuspend(void)
+ *
+ * @Brief
+ * 		PERSUS, completes with the command complete interrupt. The memory needs tSUS until WIP is cleared.
+ */
+static HAL_StatusTypeDef IS25async_sendSuspend(void){
+	QSPI_CommandTypeDef memCmd;
+
+	suspendRequested = 0;
+	IS25mem_busyStart(&suspendTimer);
+	IS25async_initCmd(&memCmd, PERSUS);
+	state = IS25_STATE_SUSPEND;
+
+	return QSPI_COMMAND_IT(IS25mem_getQspiHandle(), &memCmd);
+}
+
+/**
+ * IS25async_sendResume(void)
+ *
+ * @Brief
+ * 		PERRSM for the suspended erase, which becomes the running request again. The time it was suspended is
+ * 		taken out of its busy time.
+ */
+static HAL_StatusTypeDef IS25async_sendResume(void){
+	QSPI_CommandTypeDef memCmd;
+
+	active				= &suspendedReq;
+	suspended			= 0;
+	busyTimer.cycles   += IS25_BUSY_CYCLES() - suspendTimer.cycles;
+	busyTimer.tick	   += HAL_GetTick() - suspendTimer.tick;
+
+	IS25async_initCmd(&memCmd, PERRSM);
+	state = IS25_STATE_RESUME;
+
+	return QSPI_COMMAND_IT(IS25mem_getQspiHandle(), &memCmd);
+}
+
+/**
+ * IS25async_pollErase(void)
+ *
+ * @Brief
+ * 		Erase command sent or resumed: poll until it is done, or suspend it right away if that was requested.
+ */
+static HAL_StatusTypeDef IS25async_pollErase(void){
+	if(suspendRequested && IS25async_suspendable(active)){
+		return IS25async_sendSuspend();
+	}
+	return IS25async_sendPoll(IS25_STATE_POLL);
+}
+
+/**
+ * IS25async_start(void)
+ *
+ * @Brief
+ * 		Starts the request at the queue tail if the engine is idle. While an erase is suspended only reads are
+ * 		started, the erase is resumed before anything else and when the queue runs empty.
+ */
+static void IS25async_start(void){
+	IS25async_request *req;
+	HAL_StatusTypeDef status;
+
+	if(state != IS25_STATE_IDLE){
+		return;
+	}
+	if(suspended && (queueTail == queueHead || !IS25async_readOnly(&queue[queueTail & QUEUE_MASK]))){
+		if(IS25async_sendResume() != HAL_OK){
+			IS25async_finish(MEMORY_ERROR);
+		}
+		return;
+	}
+	if(queueTail == queueHead){
+		return;
+	}
+
+	req			= &queue[queueTail & QUEUE_MASK];
+	active		= req;
+	progress	= 0;
+	chunk		= 0;
+
+	switch(req->op){
+		case IS25_REQ_PROGRAM:
+		case IS25_REQ_SECTOR_ERASE:
+		case IS25_REQ_BLOCK_ERASE:
+		case IS25_REQ_CHIP_ERASE:
+			status = IS25async_sendWren();
+			break;
+		default:
+			status = IS25async_sendOperation();
+			break;
+	}
+
+	if(status != HAL_OK){
+		IS25async_finish(MEMORY_ERROR);
+	}
+}
+
+/**
+ * IS25async_finish(flash_err result)
+ *
+ * @Brief
+ * 		Completes the running request, calls its callback and starts the next one. Inside IS25async_submit the
+ * 		callback is only recorded and called once the critical section is left.
+ */
+static void IS25async_finish(flash_err result){
+	IS25async_request done = *active;
+
+	//A read may have switched to the clock of the read configuration, no HAL_QSPI_Init in the interrupt
+	if(done.op == IS25_REQ_READ && IS25mem_setClockIT(0) != MEMORY_OK){
+		result = MEMORY_ERROR;
+	}
+
+	state = IS25_STATE_IDLE;
+	if(active != &suspendedReq){
+		queueTail++;
+	}
+	active				= 0;
+	suspendRequested	= 0;
+
+	if(done.callback != 0){
+		if(deferred != 0){
+			deferred[deferredCnt++] = (IS25async_done){done.callback, done.context, result};
+		}else{
+			done.callback(result, done.context);
+		}
+	}
+
+	IS25async_start();
+}
+
+/**
+ * IS25async_submit(const IS25async_request *request)
+ *
+ * @Brief
+ * 		Queues a request. The request is copied, the buffer must stay valid until the callback was called.
+ * 		Requests complete in submission order. Can be called from task and interrupt context.
+ *
+ * @Parameter
+ * 		const IS25async_request *	- request
+ *
+ * @return
+ * 		flash_err	- MEMORY_BUSY if the queue is full, MEMORY_ERROR for an invalid request (a read / program without
+ * 					  data would leave the transfer length of the peripheral undefined), MEMORY_PROTECTED_ERR if the
+ * 					  protect callback of the driver rejects the written range
+ */
+flash_err IS25async_submit(const IS25async_request *request){
+	IS25async_done failed[IS25ASYNC_QUEUE_DEPTH + 1];
+	uint8_t failedCnt;
+	flash_err err;
+
+	if(request->op > IS25_REQ_READ_ID){
+		return MEMORY_ERROR;
+	}
+	if(request->buffer == 0 && (request->op == IS25_REQ_READ || request->op == IS25_REQ_PROGRAM ||
+			request->op == IS25_REQ_READ_STATUS || request->op == IS25_REQ_READ_ID)){
+		return MEMORY_ERROR;
+	}
+	if(request->size == 0 && (request->op == IS25_REQ_READ || request->op == IS25_REQ_PROGRAM)){
+		return MEMORY_ERROR;
+	}
+	err = IS25async_checkProtect(request);
+	if(err != MEMORY_OK){
+		return err;
+	}
+
+	IS25ASYNC_ENTER_CRITICAL();
+
+	if((uint8_t)(queueHead - queueTail) >= IS25ASYNC_QUEUE_DEPTH){
+		IS25ASYNC_EXIT_CRITICAL();
+		return MEMORY_BUSY;
+	}
+
+	queue[queueHead & QUEUE_MASK] = *request;
+	queueHead++;
+
+	//A start which fails right away finishes requests here, keep their callbacks out of the critical section
+	deferred	= failed;
+	deferredCnt	= 0;
+	IS25async_start();
+	failedCnt	= deferredCnt;
+	deferred	= 0;
+
+	IS25ASYNC_EXIT_CRITICAL();
+
+	for(uint8_t i = 0; i < failedCnt; i++){
+		failed[i].callback(failed[i].result, failed[i].context);
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25async_suspend(void)
+ *
+ * @Brief
+ * 		Suspends the running sector / block erase (PERSUS), so the reads queued behind it do not wait for tSE / tBE.
+ * 		The erase leaves the queue while it is suspended and is resumed (PERRSM) before the next request which is no
+ * 		read, or when the queue runs empty. If the erase command was not sent yet, it is suspended right after it.
+ * 		The suspended erase range must not be read, see IS25sched for a caller which checks that. Can be called from
+ * 		task and interrupt context.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if no sector / block erase is running
+ */
+flash_err IS25async_suspend(void){
+	IS25async_done failed[IS25ASYNC_QUEUE_DEPTH + 1];
+	uint8_t failedCnt;
+	flash_err err = MEMORY_OK;
+
+	IS25ASYNC_ENTER_CRITICAL();
+
+	deferred	= failed;
+	deferredCnt	= 0;
+
+	if(suspended || state == IS25_STATE_SUSPEND || state == IS25_STATE_SUSPEND_POLL){
+		//Already suspended
+	}else if(state == IS25_STATE_IDLE || !IS25async_suspendable(active)){
+		err = MEMORY_ERROR;
+	}else if(state == IS25_STATE_POLL){
+		HAL_QSPI_Abort(IS25mem_getQspiHandle());
+		if(IS25async_sendSuspend() != HAL_OK && IS25async_sendPoll(IS25_STATE_POLL) != HAL_OK){
+			IS25async_finish(MEMORY_ERROR);
+			err = MEMORY_ERROR;
+		}
+	}else{
+		suspendRequested = 1;
+	}
+
+	failedCnt	= deferredCnt;
+	deferred	= 0;
+
+	IS25ASYNC_EXIT_CRITICAL();
+
+	for(uint8_t i = 0; i < failedCnt; i++){
+		failed[i].callback(failed[i].result, failed[i].context);
+	}
+
+	return err;
+}
+
+/**
+ * IS25async_pending(void)
+ *
+ * @return
+ * 		uint8_t		- queued requests including the running one and a suspended erase
+ */
+uint8_t IS25async_pending(void){
+	return (uint8_t)(queueHead - queueTail) + suspended;
+}
+
+/**
+ * IS25async_getState(void)
+ *
+ * @return
+ * 		IS25async_state		- state of the running request
+ */
+IS25async_state IS25async_getState(void){
+	return state;
+}
+
+/**
+ * IS25async_cmdCpltCallback(void)
+ *
+ * @Brief
+ * 		Call from HAL_QSPI_CmdCpltCallback. Advances WREN -> command, erase command -> poll and suspend / resume
+ * 		command -> poll.
+ */
+uint8_t IS25async_cmdCpltCallback(void){
+	HAL_StatusTypeDef status;
+
+	switch(state){
+		case IS25_STATE_WREN:		status = IS25async_sendOperation();
+									break;
+		case IS25_STATE_CMD:		IS25mem_busyStart(&busyTimer);
+									status = IS25async_pollErase();
+									break;
+		case IS25_STATE_SUSPEND:	status = IS25async_sendPoll(IS25_STATE_SUSPEND_POLL);
+									break;
+		case IS25_STATE_RESUME:		status = IS25async_pollErase();
+									break;
+		default:					return 0;
+	}
+
+	if(status != HAL_OK){
+		IS25async_finish(MEMORY_ERROR);
+	}
+	return 1;
+}
+
+/**
+ * IS25async_txCpltCallback(void)
+ *
+ * @Brief
+ * 		Call from HAL_QSPI_TxCpltCallback. Page data is sent, poll until the page is programmed.
+ */
+uint8_t IS25async_txCpltCallback(void){
+	if(state != IS25_STATE_DATA){
+		return 0;
+	}
+
+	progress += chunk;
+	IS25mem_busyStart(&busyTimer);
+	if(IS25async_sendPoll(IS25_STATE_POLL) != HAL_OK){
+		IS25async_finish(MEMORY_ERROR);
+	}
+	return 1;
+}
+
+/**
+ * IS25async_rxCpltCallback(void)
+ *
+ * @Brief
+ * 		Call from HAL_QSPI_RxCpltCallback. Read requests are done.
+ */
+uint8_t IS25async_rxCpltCallback(void){
+	if(state != IS25_STATE_DATA){
+		return 0;
+	}
+
+	progress += chunk;
+	IS25async_finish(MEMORY_OK);
+	return 1;
+}
+
+/**
+ * IS25async_reportWear(const IS25async_request *req)
+ *
+ * @Brief
+ * 		Reports the page program / erase which just finished to the wear callback of the driver.
+ */
+static void IS25async_reportWear(const IS25async_request *req){
+	mem_address address = req->address;
+
+	switch(req->op){
+		case IS25_REQ_PROGRAM:
+			address.val += progress - chunk;
+			IS25mem_reportWear(IS25_WEAR_PROGRAM, address, chunk, &busyTimer);
+			break;
+		case IS25_REQ_SECTOR_ERASE:
+			IS25mem_reportWear(IS25_WEAR_SECTOR_ERASE, address, 4096UL, &busyTimer);
+			break;
+		case IS25_REQ_BLOCK_ERASE:
+			IS25mem_reportWear(IS25_WEAR_BLOCK_ERASE, address, 65536UL, &busyTimer);
+			break;
+		case IS25_REQ_CHIP_ERASE:
+			IS25mem_reportWear(IS25_WEAR_CHIP_ERASE, address, IS25mem_getMemorySpace()->bytes, &busyTimer);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * IS25async_statusMatchCallback(void)
+ *
+ * @Brief
+ * 		Call from HAL_QSPI_StatusMatchCallback. The memory is ready again, continue with the next page or finish.
+ * 		Returns "0" if the match belongs to a legacy IS25mem_AutoPollingMemReady call.
+ */
+uint8_t IS25async_statusMatchCallback(void){
+	IS25async_request *req = active;
+
+	if(state == IS25_STATE_SUSPEND_POLL){
+		//Erase suspended, it leaves the queue until IS25async_start resumes it
+		if(active != &suspendedReq){
+			suspendedReq = *active;
+			queueTail++;
+		}
+		suspended		= 1;
+		active			= 0;
+		state			= IS25_STATE_IDLE;
+		IS25async_start();
+		return 1;
+	}
+	if(state != IS25_STATE_POLL){
+		return 0;
+	}
+
+	IS25async_reportWear(req);
+
+	if(req->op == IS25_REQ_PROGRAM && progress < req->size){
+		if(IS25async_sendWren() != HAL_OK){
+			IS25async_finish(MEMORY_ERROR);
+		}
+		return 1;
+	}
+
+	IS25async_finish(MEMORY_OK);
+	return 1;
+}
+
+/**
+ * IS25async_errorCallback(void)
+ *
+ * @Brief
+ * 		Call from HAL_QSPI_ErrorCallback and HAL_QSPI_TimeOutCallback. Fails the running request.
+ */
+uint8_t IS25async_errorCallback(void){
+	if(state == IS25_STATE_IDLE){
+		return 0;
+	}
+
+	HAL_QSPI_Abort_IT(IS25mem_getQspiHandle());
+	IS25async_finish(MEMORY_ERROR);
+	return 1;
+}
@@ -0,0 +1,82 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB non-blocking request queue
+ *
+ *      Every request runs as a state machine (WREN -> command -> data -> poll) which is advanced from the
+ *      QSPI interrupt callbacks. Requests are executed strictly one after another in submission order, except
+ *      for reads which run while a sector / block erase is suspended (IS25async_suspend).
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_ASYNC_H_
+#define INC_IS25LQXXXB_ASYNC_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25ASYNC_QUEUE_DEPTH
+#define IS25ASYNC_QUEUE_DEPTH		8			// Pending requests, must be a power of two
+#endif
+
+#ifndef IS25ASYNC_ENTER_CRITICAL
+#define IS25ASYNC_ENTER_CRITICAL()	uint32_t primask_ = __get_PRIMASK(); __disable_irq()
+#define IS25ASYNC_EXIT_CRITICAL()	__set_PRIMASK(primask_)
+#endif
+
+#define IS25_PAGE_SIZE				256			// Page program size
+
+/**
+ * Request type
+ */
+typedef enum{
+	IS25_REQ_READ				= 0x00,		// Read of size bytes into buffer, active read configuration
+	IS25_REQ_PROGRAM			= 0x01,		// Page program of size bytes, split at page boundaries
+	IS25_REQ_SECTOR_ERASE		= 0x02,		// 4 kByte sector erase
+	IS25_REQ_BLOCK_ERASE		= 0x03,		// 64 kByte block erase
+	IS25_REQ_CHIP_ERASE			= 0x04,		// Chip erase
+	IS25_REQ_READ_STATUS		= 0x05,		// Status register into buffer[0]
+	IS25_REQ_READ_ID			= 0x06		// JEDEC ID into buffer[0..2]
+}IS25async_op;
+
+/**
+ * Request state
+ */
+typedef enum{
+	IS25_STATE_IDLE				= 0x00,
+	IS25_STATE_WREN				= 0x01,		// Write enable sent, waiting for command complete
+	IS25_STATE_CMD				= 0x02,		// Command without data phase sent, waiting for command complete
+	IS25_STATE_DATA				= 0x03,		// Data phase running, waiting for rx/tx complete
+	IS25_STATE_POLL				= 0x04,		// Auto polling WIP, waiting for status match
+	IS25_STATE_SUSPEND			= 0x05,		// Erase suspend sent, waiting for command complete
+	IS25_STATE_SUSPEND_POLL		= 0x06,		// Auto polling WIP until the erase is suspended
+	IS25_STATE_RESUME			= 0x07		// Erase resume sent, waiting for command complete
+}IS25async_state;
+
+typedef void (*IS25async_callback)(flash_err result, void *context);
+
+typedef struct{
+	IS25async_op		op;
+	mem_address			address;
+	uint8_t				*buffer;
+	uint32_t			size;
+	IS25async_callback	callback;			// Called from interrupt context when the request is finished, may be 0
+	void				*context;			// Passed to the callback
+}IS25async_request;
+
+
+//External function declaration
+
+extern flash_err IS25async_submit(const IS25async_request *request);
+extern flash_err IS25async_suspend(void);
+extern uint8_t IS25async_pending(void);
+extern IS25async_state IS25async_getState(void);
+
+//Event sources, call them from the matching HAL_QSPI_xxxCallback (or from a simulated interrupt source).
+//They return "1" if the event belonged to a queued request.
+extern uint8_t IS25async_cmdCpltCallback(void);
+extern uint8_t IS25async_txCpltCallback(void);
+extern uint8_t IS25async_rxCpltCallback(void);
+extern uint8_t IS25async_statusMatchCallback(void);
+extern uint8_t IS25async_errorCallback(void);
+
+#endif /* INC_IS25LQXXXB_ASYNC_H_ */
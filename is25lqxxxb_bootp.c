@@ -0,0 +1,206 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB boot parameter store
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_bootp.h"
+
+#define BOOTP_MAGIC				0x5042				// "BP"
+#define BOOTP_VERSION			1
+#define BOOTP_ERASED			0xFFFF
+
+#if IS25BOOTP_ROW >= IS25_IR_ROWS
+#error "IS25BOOTP_ROW must be an information row 0 ... 3"
+#endif
+
+/**
+ * One slot of the information row. A slot whose CRC does not match (interrupted program) is skipped.
+ */
+typedef struct{
+	uint16_t			magic;
+	uint8_t				version;
+	uint8_t				role;
+	IS25mem_readConfig	readConfig;
+	uint32_t			calibration[IS25BOOTP_CALIB_WORDS];
+	uint32_t			crc;				// CRC-32 of all fields above
+}bootp_record;
+
+typedef char bootp_record_size_check[(sizeof(bootp_record) * IS25BOOTP_SLOTS == IS25_IR_SIZE) ? 1 : -1];
+
+//Private variables
+static bootp_record		row[IS25BOOTP_SLOTS];
+
+
+static uint32_t IS25bootp_crc(const bootp_record *rec){
+	return IS25mem_crc32(0, (const uint8_t *)rec, offsetof(bootp_record, crc));
+}
+
+/**
+ * IS25bootp_readRow(int8_t *last, uint8_t *freeSlot)
+ *
+ * @Brief
+ * 		Reads the whole row with one IRRD and finds the newest valid slot and the first erased slot.
+ *
+ * @Parameter
+ * 		int8_t *	- newest valid slot, -1 if there is none
+ * 		uint8_t *	- first erased slot, IS25BOOTP_SLOTS if the row is full
+ */
+static flash_err IS25bootp_readRow(int8_t *last, uint8_t *freeSlot){
+	*last = -1;
+	*freeSlot = IS25BOOTP_SLOTS;
+
+	if(IS25mem_readInfoRow((uint8_t *)row, IS25BOOTP_ROW, 0, IS25_IR_SIZE) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	for(uint8_t i = 0; i < IS25BOOTP_SLOTS; i++){
+		if(row[i].magic == BOOTP_ERASED){
+			*freeSlot = i;
+			break;						// Slots are appended, everything behind is erased
+		}
+		if(row[i].magic == BOOTP_MAGIC && row[i].version == BOOTP_VERSION && IS25bootp_crc(&row[i]) == row[i].crc){
+			*last = (int8_t)i;
+		}
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25bootp_load(IS25bootp_params *params)
+ *
+ * @Brief
+ * 		Reads the newest boot parameters. Works with the reset read configuration, call it before applying
+ * 		params->readConfig with IS25mem_setReadConfig.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if no valid parameters are stored
+ */
+flash_err IS25bootp_load(IS25bootp_params *params){
+	int8_t last;
+	uint8_t freeSlot;
+
+	if(IS25bootp_readRow(&last, &freeSlot) != MEMORY_OK || last < 0){
+		return MEMORY_ERROR;
+	}
+
+	params->role		= row[last].role;
+	params->readConfig	= row[last].readConfig;
+	memcpy(params->calibration, row[last].calibration, sizeof(params->calibration));
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25bootp_store(const IS25bootp_params *params)
+ *
+ * @Brief
+ * 		Appends the parameters to the next free slot and verifies them. Unchanged parameters are not written again.
+ * 		A full row is erased first, a power loss during that erase loses the stored parameters.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the row is locked or the slot does not read back
+ */
+flash_err IS25bootp_store(const IS25bootp_params *params){
+	bootp_record rec;
+	bootp_record check;
+	uint8_t locked;
+	int8_t last;
+	uint8_t freeSlot;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic		= BOOTP_MAGIC;
+	rec.version		= BOOTP_VERSION;
+	rec.role		= params->role;
+	rec.readConfig	= params->readConfig;
+	memcpy(rec.calibration, params->calibration, sizeof(rec.calibration));
+	rec.crc			= IS25bootp_crc(&rec);
+
+	if(IS25bootp_readRow(&last, &freeSlot) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(last >= 0 && memcmp(&row[last], &rec, sizeof(rec)) == 0){
+		return MEMORY_OK;
+	}
+
+	if(IS25bootp_isLocked(&locked) != MEMORY_OK || locked){
+		return MEMORY_ERROR;
+	}
+
+	if(freeSlot == IS25BOOTP_SLOTS){
+		if(IS25mem_eraseInfoRow(IS25BOOTP_ROW) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		freeSlot = 0;
+	}
+
+	if(IS25mem_programInfoRow((uint8_t *)&rec, IS25BOOTP_ROW, freeSlot * sizeof(rec), sizeof(rec)) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25mem_readInfoRow((uint8_t *)&check, IS25BOOTP_ROW, freeSlot * sizeof(rec), sizeof(check)) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	return memcmp(&check, &rec, sizeof(rec)) == 0 ? MEMORY_OK : MEMORY_ERROR;
+}
+
+/**
+ * IS25bootp_isLocked(uint8_t *locked)
+ *
+ * @return
+ * 		uint8_t *	- "1" if the IR lock bit of IS25BOOTP_ROW is set
+ */
+flash_err IS25bootp_isLocked(uint8_t *locked){
+	extFlash_func fct;
+
+	if(IS25mem_readFctReg(&fct) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	*locked = (fct & IR_LOCK(IS25BOOTP_ROW)) ? 1 : 0;
+
+	return MEMORY_OK;
+}
+
+#ifdef IS25BOOTP_ALLOW_LOCK
+/**
+ * IS25bootp_lock(uint32_t key)
+ *
+ * @Brief
+ * 		Sets the IR lock bit of IS25BOOTP_ROW via the function register. This can NOT be undone, the stored
+ * 		parameters can not be changed anymore afterwards.
+ *
+ * @Parameter
+ * 		uint32_t	- IS25BOOTP_LOCK_KEY
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR on a wrong key, without valid parameters or if the lock bit did not stick
+ */
+flash_err IS25bootp_lock(uint32_t key){
+	IS25bootp_params params;
+	extFlash_func fct;
+
+	if(key != IS25BOOTP_LOCK_KEY || IS25bootp_load(&params) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25mem_readFctReg(&fct) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(fct & IR_LOCK(IS25BOOTP_ROW)){
+		return MEMORY_OK;
+	}
+
+	fct |= IR_LOCK(IS25BOOTP_ROW);
+	if(IS25mem_writeEnable() != MEMORY_OK || IS25mem_writeFctReg(&fct) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25mem_waitMemReady(IS25_TW_MAX_MS) != MEMORY_OK || IS25mem_readFctReg(&fct) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	return (fct & IR_LOCK(IS25BOOTP_ROW)) ? MEMORY_OK : MEMORY_ERROR;
+}
+#endif
@@ -0,0 +1,45 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB boot parameter store
+ *
+ *      Keeps the tuned read configuration, the device role and a few calibration words in an information row,
+ *      outside the main array. IS25bootp_load needs a single IRRD of one row, so the parameters are available
+ *      before any filesystem is mounted. Updates are appended to the next free 32 byte slot, the row is only
+ *      erased when all slots are used.
+ *
+ *      The information row lock is one time programmable. IS25bootp_lock only exists when IS25BOOTP_ALLOW_LOCK
+ *      is defined and it has to be called with IS25BOOTP_LOCK_KEY.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_BOOTP_H_
+#define INC_IS25LQXXXB_BOOTP_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25BOOTP_ROW
+#define IS25BOOTP_ROW				0			// Information row 0 ... 3
+#endif
+
+#define IS25BOOTP_CALIB_WORDS		4
+#define IS25BOOTP_SLOTS				(IS25_IR_SIZE / 32)
+#define IS25BOOTP_LOCK_KEY			0x4C4F434B	// "LOCK"
+
+typedef struct{
+	uint8_t				role;									// Application defined device role
+	IS25mem_readConfig	readConfig;								// e.g. result of IS25cal_run
+	uint32_t			calibration[IS25BOOTP_CALIB_WORDS];		// Application calibration values
+}IS25bootp_params;
+
+
+//External function declaration
+
+extern flash_err IS25bootp_load(IS25bootp_params *params);
+extern flash_err IS25bootp_store(const IS25bootp_params *params);
+extern flash_err IS25bootp_isLocked(uint8_t *locked);
+#ifdef IS25BOOTP_ALLOW_LOCK
+extern flash_err IS25bootp_lock(uint32_t key);
+#endif
+
+#endif /* INC_IS25LQXXXB_BOOTP_H_ */
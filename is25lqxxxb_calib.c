@@ -0,0 +1,193 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB read calibration
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_calib.h"
+
+//Private variables
+static uint8_t		pattern[IS25CAL_PATTERN_SIZE];
+static uint8_t		readBack[IS25CAL_PATTERN_SIZE];
+
+
+/**
+ * IS25cal_makePattern(void)
+ *
+ * @Brief
+ * 		Non periodic pattern (LFSR) with all-0, all-1 and toggling bytes, so a wrong dummy cycle count or a late
+ * 		sample point can not read back the same data shifted by some bits.
+ */
+static void IS25cal_makePattern(void){
+	uint16_t lfsr = 0xACE1;
+
+	for(uint16_t i = 0; i < IS25CAL_PATTERN_SIZE; i++){
+		lfsr		= (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+		pattern[i]	= (uint8_t)lfsr;
+	}
+	pattern[0] = 0x00;	pattern[1] = 0xFF;	pattern[2] = 0xAA;	pattern[3] = 0x55;
+}
+
+/**
+ * IS25cal_verify(mem_address sector, const IS25mem_readConfig *cfg)
+ *
+ * @return
+ * 		uint8_t		- "1" if IS25CAL_VERIFY_READS reads in a row returned the pattern
+ */
+static uint8_t IS25cal_verify(mem_address sector, const IS25mem_readConfig *cfg){
+	for(uint8_t n = 0; n < IS25CAL_VERIFY_READS; n++){
+		memset(readBack, (n & 1) ? 0x00 : 0xFF, sizeof(readBack));
+		if(IS25mem_readDataCfg(readBack, sector, IS25CAL_PATTERN_SIZE, cfg) != MEMORY_OK){
+			return 0;
+		}
+		if(memcmp(readBack, pattern, IS25CAL_PATTERN_SIZE) != 0){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * IS25cal_estimateNs(const IS25mem_readConfig *cfg, uint32_t size)
+ *
+ * @Brief
+ * 		Estimated bus time of a read with the given configuration at the current HCLK.
+ *
+ * @Parameter
+ * 		const IS25mem_readConfig *	- configuration
+ * 		uint32_t					- bytes read
+ *
+ * @return
+ * 		uint32_t	- ns
+ */
+uint32_t IS25cal_estimateNs(const IS25mem_readConfig *cfg, uint32_t size){
+	static const uint8_t addrLines[] = {1, 1, 2, 1, 4};
+	static const uint8_t dataLines[] = {1, 2, 2, 4, 4};
+	uint32_t sclk		= HAL_RCC_GetHCLKFreq() / (cfg->prescaler + 1u);
+	uint8_t addrBits	= IS25mem_getMemorySpace()->addressBytes == 4 ? 32 : 24;
+	uint64_t cycles;
+
+	if(cfg->mode > IS25_READ_1_4_4 || sclk == 0){
+		return 0xFFFFFFFFu;
+	}
+
+	cycles	= 8 + addrBits / addrLines[cfg->mode] + cfg->dummyCycles + ((uint64_t)size * 8) / dataLines[cfg->mode];
+	if(cfg->mode == IS25_READ_1_2_2 || cfg->mode == IS25_READ_1_4_4){
+		cycles += 8 / addrLines[cfg->mode];
+	}
+
+	return (uint32_t)((cycles * 1000000000ULL) / sclk);
+}
+
+/**
+ * IS25cal_run(mem_address sector, IS25mem_readConfig *result, IS25cal_report *report)
+ *
+ * @Brief
+ * 		Erases the reserved sector, programs the pattern and sweeps all read configurations from the CubeMX prescaler
+ * 		down to IS25CAL_MIN_PRESCALER. Configurations whose estimated time can not beat the best one so far are
+ * 		skipped, and per mode the sweep stops at the first (smallest) passing dummy cycle count.
+ * 		Each tested configuration only clocks its own reads (IS25mem_readDataCfg), erase / program / status commands
+ * 		stay at the CubeMX clock. The fastest passing configuration is activated via IS25mem_setReadConfig.
+ * 		Quad modes set the QE bit.
+ *
+ * @Parameter
+ * 		mem_address				- any address inside the reserved sector, its content is destroyed
+ * 		IS25mem_readConfig *	- result, ready to be stored
+ * 		IS25cal_report *		- sweep statistics, may be 0
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the pattern can not be verified with the configuration before the sweep
+ */
+flash_err IS25cal_run(mem_address sector, IS25mem_readConfig *result, IS25cal_report *report){
+	IS25mem_readConfig baseline;
+	IS25mem_readConfig cfg;
+	IS25mem_readConfig best;
+	IS25cal_report stats = {0};
+	uint32_t bestNs = 0xFFFFFFFFu;
+	uint32_t ns;
+	uint8_t found = 0;
+
+	sector.sectorBytes = 0;
+	IS25mem_getReadConfig(&baseline);
+	baseline.mode			= IS25_READ_1_1_1;
+	baseline.dummyCycles	= 8;
+	baseline.prescaler		= (uint8_t)IS25mem_getQspiHandle()->Init.ClockPrescaler;
+	baseline.sampleShift	= (IS25mem_getQspiHandle()->Init.SampleShifting != QSPI_SAMPLE_SHIFTING_NONE);
+	baseline.check			= IS25mem_readConfigCheck(&baseline);
+	stats.baselineNs = IS25cal_estimateNs(&baseline, IS25CAL_PATTERN_SIZE);
+
+	//Program the pattern with the known good configuration
+	IS25cal_makePattern();
+	if(IS25mem_sectorEraseWait(sector) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	for(uint16_t offset = 0; offset < IS25CAL_PATTERN_SIZE; offset += 128){
+		mem_address address = sector;
+		address.sectorBytes = offset;
+		if(IS25mem_writeEnable() != MEMORY_OK || IS25mem_pageProgramm(&pattern[offset], address, 128) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+	if(!IS25cal_verify(sector, &baseline)){
+		return MEMORY_ERROR;
+	}
+
+	//Quad modes need QE, set it once before the sweep
+	cfg				= baseline;
+	cfg.mode		= IS25_READ_1_1_4;
+	cfg.check		= IS25mem_readConfigCheck(&cfg);
+	if(IS25mem_setReadConfig(&cfg) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	cfg.magic		= IS25_READCFG_MAGIC;
+	cfg.reserved	= 0;
+	for(int prescaler = baseline.prescaler; prescaler >= IS25CAL_MIN_PRESCALER; prescaler--){
+		for(uint8_t shift = 0; shift < 2; shift++){
+			cfg.prescaler	= (uint8_t)prescaler;
+			cfg.sampleShift	= shift;
+
+			for(uint8_t mode = IS25_READ_1_1_1; mode <= IS25_READ_1_4_4; mode++){
+				for(uint8_t dummy = 0; dummy <= IS25CAL_MAX_DUMMY; dummy++){
+					cfg.mode		= mode;
+					cfg.dummyCycles	= dummy;
+
+					ns = IS25cal_estimateNs(&cfg, IS25CAL_PATTERN_SIZE);
+					if(ns >= bestNs){
+						break;
+					}
+
+					stats.tested++;
+					if(IS25cal_verify(sector, &cfg)){
+						stats.passed++;
+						best	= cfg;
+						bestNs	= ns;
+						found	= 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	if(!found){
+		best = baseline;
+		bestNs = stats.baselineNs;
+	}
+	best.check = IS25mem_readConfigCheck(&best);
+
+	if(IS25mem_setReadConfig(&best) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	stats.bestNs = bestNs;
+	*result = best;
+	if(report != 0){
+		*report = stats;
+	}
+
+	return MEMORY_OK;
+}
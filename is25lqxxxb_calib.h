@@ -0,0 +1,44 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB read calibration
+ *
+ *      Writes a known pattern to a reserved sector and sweeps read mode, dummy cycles, QSPI prescaler and
+ *      sample shift. The fastest configuration which reads the pattern back correctly is activated and
+ *      returned, store it and pass it to IS25mem_setReadConfig on the next boot to skip the sweep.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_CALIB_H_
+#define INC_IS25LQXXXB_CALIB_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25CAL_MIN_PRESCALER
+#define IS25CAL_MIN_PRESCALER		0			// Fastest prescaler tried, the sweep starts at the CubeMX setting
+#endif
+
+#ifndef IS25CAL_MAX_DUMMY
+#define IS25CAL_MAX_DUMMY			10			// Dummy cycles are swept from 0 to this value
+#endif
+
+#ifndef IS25CAL_VERIFY_READS
+#define IS25CAL_VERIFY_READS		4			// Consecutive good reads a configuration needs to pass
+#endif
+
+#define IS25CAL_PATTERN_SIZE		256
+
+typedef struct{
+	uint16_t	tested;				// Configurations read
+	uint16_t	passed;				// Configurations which returned the pattern
+	uint32_t	bestNs;				// Estimated time of a IS25CAL_PATTERN_SIZE read with the result
+	uint32_t	baselineNs;			// Same estimate for the configuration before the sweep
+}IS25cal_report;
+
+
+//External function declaration
+
+extern flash_err IS25cal_run(mem_address sector, IS25mem_readConfig *result, IS25cal_report *report);
+extern uint32_t IS25cal_estimateNs(const IS25mem_readConfig *cfg, uint32_t size);
+
+#endif /* INC_IS25LQXXXB_CALIB_H_ */
@@ -0,0 +1,324 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB factory bulk programming
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_factory.h"
+
+#define FAC_SECTOR_SIZE			4096UL
+#define FAC_PAGE_SIZE			256UL
+#define FAC_BP_MASK				0x3C				// Status register BP3-BP0
+
+#if IS25FAC_CHUNK != FAC_SECTOR_SIZE
+#error "IS25FAC_CHUNK has to be one sector, the erase decision is made per chunk"
+#endif
+
+//Private variables
+static uint32_t		readBuf[IS25FAC_CHUNK / 4];			// Flash side, word aligned for the blank check
+static uint32_t		sourceBuf[IS25FAC_CHUNK / 4];		// Image side for IS25fac_source images
+static uint32_t		dirty[IS25FAC_CHIP_ERASE_SECTORS];	// Sectors to erase while no chip erase is needed
+
+
+/**
+ * IS25fac_chunk(const IS25fac_image *image, uint32_t offset, uint32_t size)
+ *
+ * @return
+ * 		const uint8_t *		- image data at offset, 0 if the source failed
+ */
+static const uint8_t *IS25fac_chunk(const IS25fac_image *image, uint32_t offset, uint32_t size){
+	if(image->data != 0){
+		return image->data + offset;
+	}
+	if(image->source == 0 || image->source(image->context, offset, (uint8_t *)sourceBuf, size) != size){
+		return 0;
+	}
+	return (const uint8_t *)sourceBuf;
+}
+
+static uint8_t IS25fac_isBlank(const uint8_t *data, uint32_t size){
+	uint32_t i = 0;
+
+	if(((uintptr_t)data & 3) == 0){
+		for(; i + 4 <= size; i += 4){
+			if(*(const uint32_t *)(data + i) != 0xFFFFFFFFUL){
+				return 0;
+			}
+		}
+	}
+	for(; i < size; i++){
+		if(data[i] != 0xFF){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static uint32_t IS25fac_perSec(uint32_t bytes, uint32_t us){
+	return us ? (uint32_t)((uint64_t)bytes * 1000000 / us) : 0;
+}
+
+/**
+ * IS25fac_limits(IS25fac_report *report)
+ *
+ * @Brief
+ * 		Throughput limits of the QSPI clock: quad page program (WREN, PPQ with address, 256 bytes on four lines, one
+ * 		RDSR poll) plus the typical program time per page, and quad output reads of IS25FAC_CHUNK bytes.
+ */
+static void IS25fac_limits(IS25fac_report *report){
+	QSPI_HandleTypeDef *qspi	= IS25mem_getQspiHandle();
+	uint32_t addrCycles			= IS25mem_getMemorySpace()->addressBytes * 8;
+	uint64_t pageCycles			= 8 + 8 + addrCycles + FAC_PAGE_SIZE * 2 + 16;
+	uint64_t chunkCycles		= 8 + addrCycles + 8 + IS25FAC_CHUNK * 2;
+	uint64_t pageNs;
+
+	report->sclkHz = qspi != 0 ? HAL_RCC_GetHCLKFreq() / (qspi->Init.ClockPrescaler + 1) : 0;
+	if(report->sclkHz == 0){
+		return;
+	}
+
+	pageNs = pageCycles * 1000000000ULL / report->sclkHz + IS25FAC_TPP_TYP_US * 1000ULL;
+	report->programLimitBytesPerSec	= (uint32_t)(FAC_PAGE_SIZE * 1000000000ULL / pageNs);
+	report->verifyLimitBytesPerSec	= (uint32_t)((uint64_t)IS25FAC_CHUNK * report->sclkHz / chunkCycles);
+}
+
+/**
+ * IS25fac_blankCheck(const IS25fac_image *image, IS25fac_report *report)
+ *
+ * @Brief
+ * 		Reads the image range and collects the sectors which are not blank, stops counting at
+ * 		IS25FAC_CHIP_ERASE_SECTORS.
+ */
+static flash_err IS25fac_blankCheck(const IS25fac_image *image, IS25fac_report *report){
+	mem_address address = image->address;
+	uint32_t size;
+
+	for(uint32_t offset = 0; offset < image->size; offset += size){
+		size = image->size - offset < IS25FAC_CHUNK ? image->size - offset : IS25FAC_CHUNK;
+
+		if(IS25mem_readDataFast((uint8_t *)readBuf, address, size) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		if(!IS25fac_isBlank((const uint8_t *)readBuf, size)){
+			dirty[report->dirtySectors++] = address.sector;
+			if(report->dirtySectors == IS25FAC_CHIP_ERASE_SECTORS){
+				break;
+			}
+		}
+		address.val += size;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25fac_programChunk(const uint8_t *data, mem_address address, uint32_t size, IS25fac_report *report)
+ *
+ * @Brief
+ * 		Quad page programs one sector of the image, page by page without further splitting. Blank pages are skipped.
+ */
+static flash_err IS25fac_programChunk(const uint8_t *data, mem_address address, uint32_t size, IS25fac_report *report){
+	uint32_t page;
+
+	for(uint32_t offset = 0; offset < size; offset += page){
+		page = size - offset < FAC_PAGE_SIZE ? size - offset : FAC_PAGE_SIZE;
+
+		if(IS25fac_isBlank(data + offset, page)){
+			report->pagesSkipped++;
+		}else{
+			if(IS25mem_writeEnable() != MEMORY_OK ||
+			   IS25mem_quadPageProgramm((uint8_t *)(data + offset), address, (uint16_t)page) != MEMORY_OK){
+				return MEMORY_ERROR;
+			}
+			report->pagesProgrammed++;
+		}
+		address.val += page;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25fac_run(const IS25fac_image *image, IS25fac_report *report)
+ *
+ * @Brief
+ * 		All steps with the quad read configuration active, see IS25fac_program.
+ */
+static flash_err IS25fac_run(const IS25fac_image *image, IS25fac_report *report){
+	IS25mem_busyTimer timer;
+	extFlash_stat status;
+	mem_address address;
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t next		= 0;				// Next entry of dirty
+	uint32_t crc		= 0;
+
+	//The device ignores a chip erase with any BP bit set and erases / programs of protected blocks, without an error
+	report->failedStep = IS25_FAC_ERASE;
+	if(IS25mem_readStatusReg(&status) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if((status & FAC_BP_MASK) != 0){
+		return MEMORY_PROTECTED_ERR;
+	}
+
+	//Blank check, erase decision
+	report->failedStep = IS25_FAC_BLANK_CHECK;
+	IS25mem_busyStart(&timer);
+	if(IS25fac_blankCheck(image, report) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	report->blankCheckUs = IS25mem_busyUs(&timer);
+
+	if(report->dirtySectors >= IS25FAC_CHIP_ERASE_SECTORS){
+		report->failedStep = IS25_FAC_ERASE;
+		IS25mem_busyStart(&timer);
+		if(IS25mem_chipEraseWait() != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		report->eraseUs		= IS25mem_busyUs(&timer);
+		report->chipErased	= 1;
+	}
+
+	//Erase the few dirty sectors right before programming them, then stream the pages
+	address = image->address;
+	for(uint32_t offset = 0; offset < image->size; offset += size){
+		size = image->size - offset < IS25FAC_CHUNK ? image->size - offset : IS25FAC_CHUNK;
+
+		if(!report->chipErased && next < report->dirtySectors && dirty[next] == address.sector){
+			report->failedStep = IS25_FAC_ERASE;
+			IS25mem_busyStart(&timer);
+			if(IS25mem_sectorEraseWait(address) != MEMORY_OK){
+				return MEMORY_ERROR;
+			}
+			report->eraseUs += IS25mem_busyUs(&timer);
+			report->sectorsErased++;
+			next++;
+		}
+
+		report->failedStep = IS25_FAC_PROGRAM;
+		data = IS25fac_chunk(image, offset, size);
+		if(data == 0){
+			return MEMORY_ERROR;
+		}
+		crc = IS25mem_crc32(crc, data, size);
+
+		IS25mem_busyStart(&timer);
+		if(IS25fac_programChunk(data, address, size, report) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		report->programUs += IS25mem_busyUs(&timer);
+		address.val += size;
+	}
+	report->imageCrc = crc;
+
+	//Verify
+	report->failedStep = IS25_FAC_VERIFY;
+	address	= image->address;
+	crc		= 0;
+	for(uint32_t offset = 0; offset < image->size; offset += size){
+		size = image->size - offset < IS25FAC_CHUNK ? image->size - offset : IS25FAC_CHUNK;
+
+		data = IS25fac_chunk(image, offset, size);
+		if(data == 0){
+			return MEMORY_ERROR;
+		}
+
+		IS25mem_busyStart(&timer);
+		if(IS25mem_readDataFast((uint8_t *)readBuf, address, size) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		report->verifyUs += IS25mem_busyUs(&timer);
+
+		crc = IS25mem_crc32(crc, (const uint8_t *)readBuf, size);
+		if(memcmp(readBuf, data, size) != 0){
+			for(uint32_t i = 0; i < size; i++){
+				if(((const uint8_t *)readBuf)[i] != data[i]){
+					if(report->mismatchBytes++ == 0){
+						report->firstMismatch = address.val + i;
+					}
+				}
+			}
+		}
+		address.val += size;
+	}
+	report->readbackCrc = crc;
+
+	if(report->mismatchBytes != 0){
+		return MEMORY_ERROR;
+	}
+	report->failedStep = IS25_FAC_DONE;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25fac_program(const IS25fac_image *image, IS25fac_report *report)
+ *
+ * @Brief
+ * 		Programs the image and fills the device report. Call after IS25mem_Init with the production QSPI clock. For
+ * 		the duration of the run a quad output read configuration is active (sets the non-volatile QE bit), the
+ * 		previous read configuration is restored afterwards. Phase times use IS25mem_busyUs (DWT cycle counter,
+ * 		started by IS25mem_Init).
+ *
+ * @Parameter
+ * 		const IS25fac_image *	- image and target address
+ * 		IS25fac_report *		- report, filled also on failure (failedStep)
+ *
+ * @return
+ * 		flash_err	- MEMORY_WRONG_CPACITY_ERR if the image does not fit, MEMORY_PROTECTED_ERR if block protection bits
+ * 					  are set (nothing erased, clear them with IS25prot_setProtection(0) first), MEMORY_ERROR on a failed step or
+ * 					  mismatch
+ */
+flash_err IS25fac_program(const IS25fac_image *image, IS25fac_report *report){
+	const IS25mem_MemorySpace *space = IS25mem_getMemorySpace();
+	IS25mem_readConfig previous;
+	IS25mem_readConfig quad;
+	IS25mem_busyTimer total;
+
+	memset(report, 0, sizeof(*report));
+	IS25mem_busyStart(&total);
+	report->imageSize	= image->size;
+	report->failedStep	= IS25_FAC_IDENTIFY;
+	report->result		= MEMORY_ERROR;
+
+	if(IS25mem_readProductId(&report->id) != MEMORY_OK || IS25mem_readUid(report->uid) != MEMORY_OK){
+		return report->result;
+	}
+	if(space->bytes == 0 || image->address.sectorBytes != 0 || image->address.val > space->bytes ||
+	   image->size > space->bytes - image->address.val){
+		report->result = MEMORY_WRONG_CPACITY_ERR;
+		return report->result;
+	}
+
+	IS25mem_getReadConfig(&previous);
+	quad = previous;
+	if(quad.mode != IS25_READ_1_1_4 && quad.mode != IS25_READ_1_4_4){
+		quad.mode			= IS25_READ_1_1_4;
+		quad.dummyCycles	= 8;
+		quad.check			= IS25mem_readConfigCheck(&quad);
+		if(IS25mem_setReadConfig(&quad) != MEMORY_OK){
+			return report->result;
+		}
+	}
+
+	IS25fac_limits(report);
+	report->result = IS25fac_run(image, report);
+
+	if(quad.mode != previous.mode && IS25mem_setReadConfig(&previous) != MEMORY_OK && report->result == MEMORY_OK){
+		report->result = MEMORY_ERROR;
+	}
+
+	report->totalUs					= IS25mem_busyUs(&total);
+	report->programBytesPerSec		= IS25fac_perSec(image->size, report->programUs);
+	report->verifyBytesPerSec		= IS25fac_perSec(image->size, report->verifyUs);
+	//Skipped pages cost no bus time, the program efficiency only counts programmed pages
+	report->programEfficiencyPct	= report->programLimitBytesPerSec ? (uint32_t)((uint64_t)IS25fac_perSec(
+			report->pagesProgrammed * FAC_PAGE_SIZE, report->programUs) * 100 / report->programLimitBytesPerSec) : 0;
+	report->verifyEfficiencyPct		= report->verifyLimitBytesPerSec ?
+			(uint32_t)((uint64_t)report->verifyBytesPerSec * 100 / report->verifyLimitBytesPerSec) : 0;
+
+	return report->result;
+}
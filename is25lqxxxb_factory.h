@@ -0,0 +1,90 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB factory bulk programming
+ *
+ *      Programs one image per device on the production line: identify, blank check the image range with quad reads,
+ *      erase only what is not blank (a chip erase once IS25FAC_CHIP_ERASE_SECTORS sectors are dirty), quad page
+ *      program every page which is not all 0xFF back to back, verify with quad reads and fill a per-device report
+ *      including the achieved throughput against the bus limit of the QSPI clock.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_FACTORY_H_
+#define INC_IS25LQXXXB_FACTORY_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25FAC_CHIP_ERASE_SECTORS
+#define IS25FAC_CHIP_ERASE_SECTORS	16			// Dirty sectors from which a chip erase is used instead of sector erases
+#endif
+
+#ifndef IS25FAC_TPP_TYP_US
+#define IS25FAC_TPP_TYP_US			200			// Typical page program time, for the program throughput limit
+#endif
+
+#define IS25FAC_CHUNK				4096		// Blank check / verify / source read size
+
+/**
+ * Image source for images which are not in addressable memory (e.g. received over UART or from a file system).
+ * Has to deliver the same data again for the verify pass.
+ *
+ * @return	bytes written to buffer, less than size ends the run with an error
+ */
+typedef uint32_t (*IS25fac_source)(void *context, uint32_t offset, uint8_t *buffer, uint32_t size);
+
+typedef struct{
+	const uint8_t		*data;				// Image in memory, or 0 to use source
+	IS25fac_source		source;
+	void				*context;			// Passed to source
+	uint32_t			size;				// Bytes
+	mem_address			address;			// Start in the flash, sector aligned
+}IS25fac_image;
+
+typedef enum{
+	IS25_FAC_DONE				= 0x00,
+	IS25_FAC_IDENTIFY			= 0x01,		// Step which failed
+	IS25_FAC_BLANK_CHECK		= 0x02,
+	IS25_FAC_ERASE				= 0x03,
+	IS25_FAC_PROGRAM			= 0x04,
+	IS25_FAC_VERIFY				= 0x05
+}IS25fac_step;
+
+typedef struct{
+	flash_err				result;
+	IS25fac_step			failedStep;				// IS25_FAC_DONE on success
+	IS25mem_Identification	id;
+	uint8_t					uid[16];
+
+	uint32_t				imageSize;
+	uint32_t				imageCrc;				// IS25mem_crc32 of the image
+	uint32_t				readbackCrc;			// Of the verify reads, equal to imageCrc on success
+	uint32_t				mismatchBytes;
+	uint32_t				firstMismatch;			// Flash address, valid if mismatchBytes > 0
+
+	uint32_t				dirtySectors;			// Not blank before programming (counted up to IS25FAC_CHIP_ERASE_SECTORS)
+	uint32_t				sectorsErased;
+	uint8_t					chipErased;
+	uint32_t				pagesProgrammed;
+	uint32_t				pagesSkipped;			// All 0xFF, nothing to program
+
+	uint32_t				sclkHz;
+	uint32_t				blankCheckUs;
+	uint32_t				eraseUs;
+	uint32_t				programUs;
+	uint32_t				verifyUs;
+	uint32_t				totalUs;
+	uint32_t				programBytesPerSec;		// Image bytes, blank pages included
+	uint32_t				verifyBytesPerSec;
+	uint32_t				programLimitBytesPerSec;	// Quad page program bus cycles + IS25FAC_TPP_TYP_US per page
+	uint32_t				verifyLimitBytesPerSec;		// Quad output read bus cycles
+	uint32_t				programEfficiencyPct;		// Programmed pages against the limit
+	uint32_t				verifyEfficiencyPct;
+}IS25fac_report;
+
+
+//External function declaration
+
+extern flash_err IS25fac_program(const IS25fac_image *image, IS25fac_report *report);
+
+#endif /* INC_IS25LQXXXB_FACTORY_H_ */
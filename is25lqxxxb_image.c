@@ -0,0 +1,495 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB A/B firmware image store
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_image.h"
+
+#define SECTOR_SIZE				4096UL
+#define BLOCK_SIZE				65536UL
+#define PAGE_SIZE				256UL
+
+#define REC_HEAD				0x494D4748			// "IMGH"	a = image size,	b = sequence
+#define REC_CKPT				0x494D4743			// "IMGC"	a = offset,		b = CRC-32 up to offset
+#define REC_DONE				0x494D4744			// "IMGD"	a = image size,	b = CRC-32 of the image
+#define REC_ERASED				0xFFFFFFFF
+#define REC_PER_SECTOR			(SECTOR_SIZE / sizeof(img_record))
+
+typedef struct{
+	uint32_t	magic;
+	uint32_t	a;
+	uint32_t	b;
+	uint32_t	check;				// CRC-32 of magic, a, b
+}img_record;
+
+typedef struct{
+	uint8_t		active;
+	uint8_t		slot;
+	uint32_t	size;
+	uint32_t	written;			// Bytes programmed
+	uint32_t	hash;				// CRC-32 of the programmed bytes
+	uint32_t	erasedEnd;			// Data area is erased up to this offset
+	uint32_t	interval;			// Checkpoint interval, multiple of the sector size
+	uint32_t	nextCheckpoint;
+	uint16_t	nextRecord;
+	uint16_t	pageFill;
+	uint32_t	startTick;
+}img_update;
+
+//Private variables
+static img_update		img			= {0};
+
+static uint8_t			pageBuf[PAGE_SIZE];			// Partial page of the running update
+static uint8_t			verifyBuf[PAGE_SIZE];		// IS25img_verify, may run during an update
+static IS25img_stats	stats		= {0};
+
+
+/**
+ * IS25img_slotSectors(void)
+ *
+ * @return
+ * 		uint32_t	- sectors per slot including the record sector
+ */
+static uint32_t IS25img_slotSectors(void){
+	return IS25mem_getMemorySpace()->sectors / IS25IMG_SLOTS;
+}
+
+static uint32_t IS25img_recordBase(uint8_t slot){
+	return slot * IS25img_slotSectors() * SECTOR_SIZE;
+}
+
+static uint32_t IS25img_dataBase(uint8_t slot){
+	return IS25img_recordBase(slot) + SECTOR_SIZE;
+}
+
+/**
+ * IS25img_interval(uint32_t size)
+ *
+ * @return
+ * 		uint32_t	- checkpoint interval, whole sectors, at most IS25IMG_MAX_CHECKPOINTS checkpoints per image
+ */
+static uint32_t IS25img_interval(uint32_t size){
+	uint32_t sectors = (size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+	return ((sectors + IS25IMG_MAX_CHECKPOINTS - 1) / IS25IMG_MAX_CHECKPOINTS) * SECTOR_SIZE;
+}
+
+/**
+ * IS25img_writeRecord(uint32_t magic, uint32_t a, uint32_t b)
+ *
+ * @Brief
+ * 		Appends a record to the record sector of the slot being updated.
+ */
+static flash_err IS25img_writeRecord(uint32_t magic, uint32_t a, uint32_t b){
+	img_record rec = {magic, a, b, 0};
+	mem_address address;
+
+	if(img.nextRecord >= REC_PER_SECTOR){
+		return MEMORY_ERROR;
+	}
+
+	rec.check	= IS25mem_crc32(0, (const uint8_t *)&rec, offsetof(img_record, check));
+	address.val	= IS25img_recordBase(img.slot) + img.nextRecord * sizeof(img_record);
+	img.nextRecord++;
+
+	return IS25mem_programData((uint8_t *)&rec, address, sizeof(rec));
+}
+
+/**
+ * IS25img_scan(uint8_t slot, IS25img_slotInfo *info, uint16_t *nextRecord)
+ *
+ * @Brief
+ * 		Reads the record sector up to the first erased record. Records with a broken check (power loss while
+ * 		programming the record) are skipped.
+ */
+static flash_err IS25img_scan(uint8_t slot, IS25img_slotInfo *info, uint16_t *nextRecord){
+	img_record recs[PAGE_SIZE / sizeof(img_record)];
+	mem_address address;
+	uint16_t idx = 0;
+
+	*info = (IS25img_slotInfo){0};
+
+	while(idx < REC_PER_SECTOR){
+		address.val = IS25img_recordBase(slot) + idx * sizeof(img_record);
+		if(IS25mem_readDataFast((uint8_t *)recs, address, sizeof(recs)) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+
+		for(uint8_t i = 0; i < PAGE_SIZE / sizeof(img_record); i++, idx++){
+			img_record *rec = &recs[i];
+
+			if(rec->magic == REC_ERASED){
+				*nextRecord = idx;
+				return MEMORY_OK;
+			}
+			if(rec->check != IS25mem_crc32(0, (const uint8_t *)rec, offsetof(img_record, check))){
+				continue;
+			}
+
+			switch(rec->magic){
+				case REC_HEAD:	if(idx == 0){
+									info->state		= IS25_IMG_PARTIAL;
+									info->size		= rec->a;
+									info->sequence	= rec->b;
+								}
+								break;
+				case REC_CKPT:	if(info->state == IS25_IMG_PARTIAL){
+									info->written	= rec->a;
+									info->hash		= rec->b;
+								}
+								break;
+				case REC_DONE:	if(info->state == IS25_IMG_PARTIAL && rec->a == info->size){
+									info->state		= IS25_IMG_VALID;
+									info->written	= rec->a;
+									info->hash		= rec->b;
+								}
+								break;
+				default:		break;
+			}
+		}
+	}
+
+	*nextRecord = idx;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_eraseAhead(void)
+ *
+ * @Brief
+ * 		Erases the next piece of the data area, a whole 64 kByte block where it is aligned and fits into the slot.
+ */
+static flash_err IS25img_eraseAhead(void){
+	mem_address address;
+	uint32_t tick = HAL_GetTick();
+	flash_err err;
+
+	address.val = IS25img_dataBase(img.slot) + img.erasedEnd;
+
+	if((address.val % BLOCK_SIZE) == 0 && img.erasedEnd + BLOCK_SIZE <= IS25img_slotCapacity()){
+		err = IS25mem_blockEraseWait(address);
+		img.erasedEnd += BLOCK_SIZE;
+	}else{
+		err = IS25mem_sectorEraseWait(address);
+		img.erasedEnd += SECTOR_SIZE;
+	}
+
+	stats.eraseMs += HAL_GetTick() - tick;
+	return err;
+}
+
+/**
+ * IS25img_flushPage(void)
+ *
+ * @Brief
+ * 		Programs the page buffer, updates the hash and writes a checkpoint when a checkpoint boundary is reached.
+ */
+static flash_err IS25img_flushPage(void){
+	mem_address address;
+	uint32_t tick;
+
+	if(img.pageFill == 0){
+		return MEMORY_OK;
+	}
+
+	while(img.written + img.pageFill > img.erasedEnd){
+		if(IS25img_eraseAhead() != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+
+	tick		= HAL_GetTick();
+	address.val	= IS25img_dataBase(img.slot) + img.written;
+	if(IS25mem_programData(pageBuf, address, img.pageFill) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	stats.programMs += HAL_GetTick() - tick;
+
+	img.hash		= IS25mem_crc32(img.hash, pageBuf, img.pageFill);
+	img.written		+= img.pageFill;
+	img.pageFill	= 0;
+
+	if(img.written >= img.nextCheckpoint && img.written < img.size){
+		if(IS25img_writeRecord(REC_CKPT, img.written, img.hash) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		img.nextCheckpoint += img.interval;
+		stats.checkpoints++;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_slotCapacity(void)
+ *
+ * @return
+ * 		uint32_t	- maximum image size in bytes, derived from the detected memory size
+ */
+uint32_t IS25img_slotCapacity(void){
+	uint32_t sectors = IS25img_slotSectors();
+
+	return (sectors > 1) ? (sectors - 1) * SECTOR_SIZE : 0;
+}
+
+/**
+ * IS25img_getSlotInfo(uint8_t slot, IS25img_slotInfo *info)
+ *
+ * @Brief
+ * 		State, size, hash and sequence of a slot.
+ */
+flash_err IS25img_getSlotInfo(uint8_t slot, IS25img_slotInfo *info){
+	uint16_t nextRecord;
+
+	if(slot >= IS25IMG_SLOTS || IS25img_slotCapacity() == 0){
+		return MEMORY_ERROR;
+	}
+	return IS25img_scan(slot, info, &nextRecord);
+}
+
+/**
+ * IS25img_getActive(uint8_t *slot)
+ *
+ * @Brief
+ * 		Newest valid slot, the one to boot from.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if no slot holds a valid image
+ */
+flash_err IS25img_getActive(uint8_t *slot){
+	IS25img_slotInfo info;
+	uint32_t bestSeq = 0;
+	uint8_t found = 0;
+
+	for(uint8_t s = 0; s < IS25IMG_SLOTS; s++){
+		if(IS25img_getSlotInfo(s, &info) != MEMORY_OK || info.state != IS25_IMG_VALID){
+			continue;
+		}
+		if(!found || (int32_t)(info.sequence - bestSeq) > 0){
+			bestSeq	= info.sequence;
+			*slot	= s;
+			found	= 1;
+		}
+	}
+
+	return found ? MEMORY_OK : MEMORY_ERROR;
+}
+
+/**
+ * IS25img_begin(uint8_t slot, uint32_t size)
+ *
+ * @Brief
+ * 		Starts a fresh update of a slot. The slot content is invalidated immediately, the other slot is untouched.
+ *
+ * @Parameter
+ * 		uint8_t		- slot (0 / 1), must not be the active slot while running from it
+ * 		uint32_t	- image size in bytes
+ *
+ * @return
+ * 		flash_err
+ */
+flash_err IS25img_begin(uint8_t slot, uint32_t size){
+	IS25img_slotInfo other;
+	mem_address address;
+	uint32_t sequence = 1;
+
+	if(img.active || slot >= IS25IMG_SLOTS || size == 0 || size > IS25img_slotCapacity()){
+		return MEMORY_ERROR;
+	}
+
+	if(IS25img_getSlotInfo(slot ^ 1, &other) == MEMORY_OK && other.state != IS25_IMG_EMPTY){
+		sequence = other.sequence + 1;
+	}
+
+	stats			= (IS25img_stats){0};
+	img				= (img_update){0};
+	img.slot		= slot;
+	img.size		= size;
+	img.interval	= IS25img_interval(size);
+	img.nextCheckpoint = img.interval;
+	img.startTick	= HAL_GetTick();
+
+	address.val = IS25img_recordBase(slot);
+	if(IS25mem_sectorEraseWait(address) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25img_writeRecord(REC_HEAD, size, sequence) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	img.active = 1;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_resume(uint8_t slot, uint32_t *offset)
+ *
+ * @Brief
+ * 		Continues an interrupted update from its last checkpoint. The range after the checkpoint may hold a partly
+ * 		programmed interval and is erased again.
+ *
+ * @Parameter
+ * 		uint8_t		- slot in state IS25_IMG_PARTIAL
+ * 		uint32_t *	- image offset the sender has to continue from
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the slot has no update to resume
+ */
+flash_err IS25img_resume(uint8_t slot, uint32_t *offset){
+	IS25img_slotInfo info;
+	mem_address address;
+	uint16_t nextRecord;
+	uint32_t end;
+
+	if(img.active || slot >= IS25IMG_SLOTS || IS25img_slotCapacity() == 0){
+		return MEMORY_ERROR;
+	}
+	if(IS25img_scan(slot, &info, &nextRecord) != MEMORY_OK || info.state != IS25_IMG_PARTIAL){
+		return MEMORY_ERROR;
+	}
+	if(info.size == 0 || info.size > IS25img_slotCapacity()){
+		return MEMORY_ERROR;
+	}
+
+	stats			= (IS25img_stats){0};
+	img				= (img_update){0};
+	img.slot		= slot;
+	img.size		= info.size;
+	img.written		= info.written;
+	img.hash		= info.hash;
+	img.interval	= IS25img_interval(info.size);
+	img.nextCheckpoint = info.written + img.interval;
+	img.nextRecord	= nextRecord;
+	img.startTick	= HAL_GetTick();
+	stats.resumedAt	= info.written;
+
+	//Only the interval after the checkpoint can hold data, everything after it is erased again on the way
+	img.erasedEnd	= info.written;
+	end				= info.written + img.interval;
+	if(end > IS25img_slotCapacity()){
+		end = IS25img_slotCapacity();
+	}
+	while(img.erasedEnd < end){
+		uint32_t tick = HAL_GetTick();
+
+		address.val = IS25img_dataBase(slot) + img.erasedEnd;
+		if(IS25mem_sectorEraseWait(address) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		img.erasedEnd	+= SECTOR_SIZE;
+		stats.eraseMs	+= HAL_GetTick() - tick;
+	}
+
+	*offset		= info.written;
+	img.active	= 1;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_write(const uint8_t *data, uint32_t size)
+ *
+ * @Brief
+ * 		Streams the next chunk of the image, chunks can have any size.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if no update is running or the chunk exceeds the announced image size
+ */
+flash_err IS25img_write(const uint8_t *data, uint32_t size){
+	uint32_t chunk;
+
+	if(!img.active || img.written + img.pageFill + size > img.size){
+		return MEMORY_ERROR;
+	}
+
+	while(size > 0){
+		chunk = PAGE_SIZE - img.pageFill;
+		if(chunk > size){
+			chunk = size;
+		}
+
+		memcpy(&pageBuf[img.pageFill], data, chunk);
+		img.pageFill	+= chunk;
+		data			+= chunk;
+		size			-= chunk;
+
+		if(img.pageFill == PAGE_SIZE && IS25img_flushPage() != MEMORY_OK){
+			img.active = 0;
+			return MEMORY_ERROR;
+		}
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_finish(void)
+ *
+ * @Brief
+ * 		Programs the last partial page and marks the slot valid.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if less than the announced size was written
+ */
+flash_err IS25img_finish(void){
+	if(!img.active){
+		return MEMORY_ERROR;
+	}
+	if(IS25img_flushPage() != MEMORY_OK || img.written != img.size){
+		img.active = 0;
+		return MEMORY_ERROR;
+	}
+
+	img.active = 0;
+	if(IS25img_writeRecord(REC_DONE, img.size, img.hash) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	stats.durationMs = HAL_GetTick() - img.startTick;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25img_verify(uint8_t slot)
+ *
+ * @Brief
+ * 		Reads the whole image and compares its CRC-32 with the done record. Uses its own buffer, so the slot which
+ * 		is not being updated can be verified while an update runs.
+ */
+flash_err IS25img_verify(uint8_t slot){
+	IS25img_slotInfo info;
+	mem_address address;
+	uint32_t hash = 0;
+	uint32_t chunk;
+
+	if(IS25img_getSlotInfo(slot, &info) != MEMORY_OK || info.state != IS25_IMG_VALID){
+		return MEMORY_ERROR;
+	}
+
+	for(uint32_t offset = 0; offset < info.size; offset += chunk){
+		chunk = info.size - offset;
+		if(chunk > PAGE_SIZE){
+			chunk = PAGE_SIZE;
+		}
+		address.val = IS25img_dataBase(slot) + offset;
+		if(IS25mem_readDataFast(verifyBuf, address, chunk) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		hash = IS25mem_crc32(hash, verifyBuf, chunk);
+	}
+
+	return (hash == info.hash) ? MEMORY_OK : MEMORY_ERROR;
+}
+
+/**
+ * IS25img_getStats(IS25img_stats *stats)
+ *
+ * @Brief
+ * 		Checkpoints and erase / program / total time of the last update.
+ */
+void IS25img_getStats(IS25img_stats *out){
+	*out = stats;
+}
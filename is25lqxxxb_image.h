@@ -0,0 +1,59 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB A/B firmware image store
+ *
+ *      The memory is split into two slots. Every slot starts with a record sector (header, checkpoints,
+ *      done record) followed by the image data. Images are streamed in chunks of any size, the data area
+ *      is erased block by block just before it is reached and a checkpoint with the running CRC-32 is
+ *      written at every checkpoint boundary, so an interrupted update resumes from the last checkpoint.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_IMAGE_H_
+#define INC_IS25LQXXXB_IMAGE_H_
+
+#include "is25lqxxxb.h"
+
+#define IS25IMG_SLOTS				2
+#define IS25IMG_MAX_CHECKPOINTS		240			// Checkpoint records per update, the interval grows for large slots
+
+/**
+ * Slot state
+ */
+typedef enum{
+	IS25_IMG_EMPTY				= 0x00,		// No header
+	IS25_IMG_PARTIAL			= 0x01,		// Update started but not finished, can be resumed
+	IS25_IMG_VALID				= 0x02		// Done record written, image complete
+}IS25img_state;
+
+typedef struct{
+	IS25img_state	state;
+	uint32_t		size;				// Image size given to IS25img_begin
+	uint32_t		written;			// Bytes programmed (PARTIAL: covered by the last checkpoint)
+	uint32_t		hash;				// CRC-32 of the written bytes
+	uint32_t		sequence;			// Update counter, the valid slot with the higher sequence is the newer one
+}IS25img_slotInfo;
+
+typedef struct{
+	uint32_t		checkpoints;		// Checkpoints written during this update
+	uint32_t		resumedAt;			// Offset the update was resumed from, 0 for a fresh update
+	uint32_t		eraseMs;			// Time spent erasing
+	uint32_t		programMs;			// Time spent programming
+	uint32_t		durationMs;			// IS25img_begin/resume ... IS25img_finish
+}IS25img_stats;
+
+
+//External function declaration
+
+extern uint32_t IS25img_slotCapacity(void);
+extern flash_err IS25img_getSlotInfo(uint8_t slot, IS25img_slotInfo *info);
+extern flash_err IS25img_getActive(uint8_t *slot);
+extern flash_err IS25img_begin(uint8_t slot, uint32_t size);
+extern flash_err IS25img_resume(uint8_t slot, uint32_t *offset);
+extern flash_err IS25img_write(const uint8_t *data, uint32_t size);
+extern flash_err IS25img_finish(void);
+extern flash_err IS25img_verify(uint8_t slot);
+extern void IS25img_getStats(IS25img_stats *stats);
+
+#endif /* INC_IS25LQXXXB_IMAGE_H_ */
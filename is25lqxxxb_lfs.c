@@ -0,0 +1,249 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB littlefs block device
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_lfs.h"
+
+#if (IS25LFS_LOOKAHEAD_SIZE % 8) != 0
+#error "IS25LFS_LOOKAHEAD_SIZE must be a multiple of 8"
+#endif
+
+//Private variables
+static uint32_t			baseAddress		= 0;
+static uint32_t			readBuffer[IS25LFS_CACHE_SIZE / 4];			// uint32_t for the alignment littlefs expects
+static uint32_t			progBuffer[IS25LFS_CACHE_SIZE / 4];
+static uint32_t			lookaheadBuffer[IS25LFS_LOOKAHEAD_SIZE / 4];
+static uint32_t			fileBuffer[IS25LFS_CACHE_SIZE / 4];			// Benchmark file cache
+static IS25lfs_stats	stats			= {0};
+
+
+static mem_address IS25lfs_address(lfs_block_t block, lfs_off_t off){
+	mem_address address;
+
+	address.val = baseAddress + block * IS25LFS_BLOCK_SIZE + off;
+	return address;
+}
+
+static int IS25lfs_read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size){
+	uint32_t tick = HAL_GetTick();
+	flash_err result = IS25mem_readDataFast((uint8_t *)buffer, IS25lfs_address(block, off), size);
+
+	(void)c;
+	stats.readMs	+= HAL_GetTick() - tick;
+	stats.bytesRead	+= size;
+	return result == MEMORY_OK ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int IS25lfs_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size){
+	uint32_t tick = HAL_GetTick();
+	flash_err result = IS25mem_programData((uint8_t *)buffer, IS25lfs_address(block, off), size);
+
+	(void)c;
+	stats.progMs			+= HAL_GetTick() - tick;
+	stats.bytesProgrammed	+= size;
+	return result == MEMORY_OK ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int IS25lfs_erase(const struct lfs_config *c, lfs_block_t block){
+	uint32_t tick = HAL_GetTick();
+	flash_err result = IS25mem_sectorEraseWait(IS25lfs_address(block, 0));
+
+	(void)c;
+	stats.eraseMs		+= HAL_GetTick() - tick;
+	stats.blocksErased++;
+	return result == MEMORY_OK ? LFS_ERR_OK : LFS_ERR_IO;
+}
+
+static int IS25lfs_sync(const struct lfs_config *c){
+	(void)c;
+	return LFS_ERR_OK;						// Every program waits for WIP, nothing is buffered
+}
+
+/**
+ * IS25lfs_init(struct lfs_config *cfg, uint32_t firstSector, uint32_t sectorCount)
+ *
+ * @Brief
+ * 		Fills cfg for the sectors firstSector ... firstSector + sectorCount - 1 of the detected memory, including the
+ * 		static read / program / lookahead buffers, so littlefs can run with LFS_NO_MALLOC. Call after IS25mem_Init
+ * 		(and IS25mem_setReadConfig), then lfs_mount / lfs_format as usual.
+ *
+ * @Parameter
+ * 		struct lfs_config *		- configuration to fill
+ * 		uint32_t				- first sector of the filesystem, sectors before it stay free for other users
+ * 		uint32_t				- sectors, 0 for the rest of the memory
+ *
+ * @return
+ * 		flash_err	- MEMORY_WRONG_CPACITY_ERR without detected memory or if the range does not fit
+ */
+flash_err IS25lfs_init(struct lfs_config *cfg, uint32_t firstSector, uint32_t sectorCount){
+	const IS25mem_MemorySpace *space = IS25mem_getMemorySpace();
+	uint32_t lookahead;
+
+	if(space->sectors == 0 || firstSector >= space->sectors){
+		return MEMORY_WRONG_CPACITY_ERR;
+	}
+	if(sectorCount == 0){
+		sectorCount = space->sectors - firstSector;
+	}
+	if(sectorCount < 2 || sectorCount > space->sectors - firstSector){
+		return MEMORY_WRONG_CPACITY_ERR;
+	}
+
+	//One bit per block, no need to scan more blocks than the filesystem has
+	lookahead = ((sectorCount + 63) / 64) * 8;
+	if(lookahead > IS25LFS_LOOKAHEAD_SIZE){
+		lookahead = IS25LFS_LOOKAHEAD_SIZE;
+	}
+
+	baseAddress = firstSector * IS25LFS_BLOCK_SIZE;
+	memset(cfg, 0, sizeof(*cfg));
+	memset(&stats, 0, sizeof(stats));
+
+	cfg->read				= IS25lfs_read;
+	cfg->prog				= IS25lfs_prog;
+	cfg->erase				= IS25lfs_erase;
+	cfg->sync				= IS25lfs_sync;
+
+	cfg->read_size			= IS25LFS_READ_SIZE;
+	cfg->prog_size			= IS25LFS_PROG_SIZE;
+	cfg->block_size			= IS25LFS_BLOCK_SIZE;
+	cfg->block_count		= sectorCount;
+	cfg->block_cycles		= IS25LFS_BLOCK_CYCLES;
+	cfg->cache_size			= IS25LFS_CACHE_SIZE;
+	cfg->lookahead_size		= lookahead;
+
+	cfg->read_buffer		= readBuffer;
+	cfg->prog_buffer		= progBuffer;
+	cfg->lookahead_buffer	= lookaheadBuffer;
+
+	return MEMORY_OK;
+}
+
+void IS25lfs_getStats(IS25lfs_stats *out){
+	*out = stats;
+}
+
+static void IS25lfs_benchName(char *name, uint8_t n){
+	memcpy(name, "is25bench", 9);
+	name[9]		= (char)('0' + n / 100);
+	name[10]	= (char)('0' + (n / 10) % 10);
+	name[11]	= (char)('0' + n % 10);
+	name[12]	= 0;
+}
+
+/**
+ * IS25lfs_benchmark(lfs_t *lfs, uint8_t files, uint32_t fileSize, uint8_t *chunk, uint32_t chunkSize,
+ * 					IS25lfs_bench *result)
+ *
+ * @Brief
+ * 		Measures on a mounted filesystem: creating "files" empty files, appending fileSize bytes to each in chunkSize
+ * 		writes and reading them back in chunkSize reads. The files are removed afterwards, a failed remove is reported
+ * 		like the other errors. Times are HAL_GetTick milliseconds, use enough data (e.g. 4 files of 32 kByte) for
+ * 		stable numbers.
+ *
+ * @return
+ * 		int		- LFS_ERR_OK or the first littlefs error
+ */
+int IS25lfs_benchmark(lfs_t *lfs, uint8_t files, uint32_t fileSize, uint8_t *chunk, uint32_t chunkSize,
+						IS25lfs_bench *result){
+	struct lfs_file_config fileCfg;
+	IS25lfs_stats before = stats;
+	lfs_file_t file;
+	char name[13];
+	uint32_t tick;
+	int err = LFS_ERR_OK;
+	int closeErr;
+	int removeErr;
+
+	memset(result, 0, sizeof(*result));
+	memset(&fileCfg, 0, sizeof(fileCfg));
+	fileCfg.buffer = fileBuffer;
+	if(chunkSize == 0 || files == 0){
+		return LFS_ERR_INVAL;
+	}
+	for(uint32_t i = 0; i < chunkSize; i++){
+		chunk[i] = (uint8_t)(i * 7 + 1);
+	}
+
+	//Create
+	tick = HAL_GetTick();
+	for(uint8_t n = 0; n < files && err == LFS_ERR_OK; n++){
+		IS25lfs_benchName(name, n);
+		err = lfs_file_opencfg(lfs, &file, name, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC, &fileCfg);
+		if(err == LFS_ERR_OK){
+			err = lfs_file_close(lfs, &file);
+		}
+	}
+	result->createMs = HAL_GetTick() - tick;
+
+	//Append
+	tick = HAL_GetTick();
+	for(uint8_t n = 0; n < files && err == LFS_ERR_OK; n++){
+		IS25lfs_benchName(name, n);
+		err = lfs_file_opencfg(lfs, &file, name, LFS_O_WRONLY | LFS_O_APPEND, &fileCfg);
+		if(err != LFS_ERR_OK){
+			break;
+		}
+		for(uint32_t done = 0; done < fileSize && err == LFS_ERR_OK; done += chunkSize){
+			lfs_size_t size = fileSize - done < chunkSize ? fileSize - done : chunkSize;
+			lfs_ssize_t written = lfs_file_write(lfs, &file, chunk, size);
+			if(written != (lfs_ssize_t)size){
+				err = written < 0 ? (int)written : LFS_ERR_NOSPC;
+			}
+		}
+		closeErr = lfs_file_close(lfs, &file);
+		if(err == LFS_ERR_OK){
+			err = closeErr;
+		}
+	}
+	result->appendMs = HAL_GetTick() - tick;
+
+	//Read
+	tick = HAL_GetTick();
+	for(uint8_t n = 0; n < files && err == LFS_ERR_OK; n++){
+		IS25lfs_benchName(name, n);
+		err = lfs_file_opencfg(lfs, &file, name, LFS_O_RDONLY, &fileCfg);
+		if(err != LFS_ERR_OK){
+			break;
+		}
+		for(uint32_t done = 0; done < fileSize && err == LFS_ERR_OK; done += chunkSize){
+			lfs_size_t size = fileSize - done < chunkSize ? fileSize - done : chunkSize;
+			lfs_ssize_t got = lfs_file_read(lfs, &file, chunk, size);
+			if(got != (lfs_ssize_t)size){
+				err = got < 0 ? (int)got : LFS_ERR_CORRUPT;
+			}
+		}
+		closeErr = lfs_file_close(lfs, &file);
+		if(err == LFS_ERR_OK){
+			err = closeErr;
+		}
+	}
+	result->readMs = HAL_GetTick() - tick;
+
+	//Remove all files, also after an error, a missing file is not one
+	for(uint8_t n = 0; n < files; n++){
+		IS25lfs_benchName(name, n);
+		removeErr = lfs_remove(lfs, name);
+		if(err == LFS_ERR_OK && removeErr != LFS_ERR_OK && removeErr != LFS_ERR_NOENT){
+			err = removeErr;
+		}
+	}
+
+	result->files				= files;
+	result->bytes				= (uint32_t)files * fileSize;
+	result->appendBytesPerSec	= result->appendMs ? (uint32_t)((uint64_t)result->bytes * 1000 / result->appendMs) : 0;
+	result->readBytesPerSec		= result->readMs ? (uint32_t)((uint64_t)result->bytes * 1000 / result->readMs) : 0;
+	result->device.bytesRead		= stats.bytesRead - before.bytesRead;
+	result->device.bytesProgrammed	= stats.bytesProgrammed - before.bytesProgrammed;
+	result->device.blocksErased		= stats.blocksErased - before.blocksErased;
+	result->device.readMs			= stats.readMs - before.readMs;
+	result->device.progMs			= stats.progMs - before.progMs;
+	result->device.eraseMs			= stats.eraseMs - before.eraseMs;
+
+	return err;
+}
@@ -0,0 +1,59 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB littlefs block device
+ *
+ *      Fills a littlefs (v2) lfs_config from the geometry detected by IS25mem_Init: one littlefs block per
+ *      4 kByte sector, page sized caches. Reads use the active read configuration (IS25mem_readDataFast, e.g. the
+ *      IS25cal_run result), programs are split into page programs with WIP polling (IS25mem_programData).
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_LFS_H_
+#define INC_IS25LQXXXB_LFS_H_
+
+#include "is25lqxxxb.h"
+#include "lfs.h"
+
+#define IS25LFS_BLOCK_SIZE			4096		// Sector
+#define IS25LFS_CACHE_SIZE			256			// Page, one program command per cache flush
+#define IS25LFS_READ_SIZE			16
+#define IS25LFS_PROG_SIZE			16			// NOR programs any size, small values keep metadata commits short
+
+#ifndef IS25LFS_LOOKAHEAD_SIZE
+#define IS25LFS_LOOKAHEAD_SIZE		64			// Bytes, 8 blocks each, must be a multiple of 8
+#endif
+
+#ifndef IS25LFS_BLOCK_CYCLES
+#define IS25LFS_BLOCK_CYCLES		500			// Metadata erase cycles before littlefs moves a block
+#endif
+
+typedef struct{
+	uint32_t	bytesRead;
+	uint32_t	bytesProgrammed;
+	uint32_t	blocksErased;
+	uint32_t	readMs;
+	uint32_t	progMs;
+	uint32_t	eraseMs;
+}IS25lfs_stats;
+
+typedef struct{
+	uint32_t	files;
+	uint32_t	bytes;					// Payload per phase (append / read)
+	uint32_t	createMs;				// Create and close all files
+	uint32_t	appendMs;
+	uint32_t	readMs;
+	uint32_t	appendBytesPerSec;
+	uint32_t	readBytesPerSec;
+	IS25lfs_stats	device;				// Block device traffic of the whole run
+}IS25lfs_bench;
+
+
+//External function declaration
+
+extern flash_err IS25lfs_init(struct lfs_config *cfg, uint32_t firstSector, uint32_t sectorCount);
+extern void IS25lfs_getStats(IS25lfs_stats *stats);
+extern int IS25lfs_benchmark(lfs_t *lfs, uint8_t files, uint32_t fileSize, uint8_t *chunk, uint32_t chunkSize,
+								IS25lfs_bench *result);
+
+#endif /* INC_IS25LQXXXB_LFS_H_ */
@@ -0,0 +1,430 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB LZ compression layer
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_lz.h"
+
+#define PAGE_SIZE				256UL
+
+#define LZ_MAGIC				0x5A4C				// "LZ"
+#define LZ_FLAG_RAW				0x0001
+#define LZ_MIN_MATCH			4
+#define LZ_LAST_LITERALS		5					// LZ4 end of block rules
+#define LZ_MATCH_GUARD			12
+#define LZ_MAX_OFFSET			65535
+
+/**
+ * Frame header, the payload follows directly. Frames start on a page boundary, an erased magic ends a log.
+ */
+typedef struct{
+	uint16_t	magic;
+	uint16_t	flags;
+	uint16_t	rawSize;
+	uint16_t	storedSize;			// Payload bytes following the header
+	uint32_t	crc;				// CRC-32 of the raw data
+}lz_header;
+
+//Private variables
+static uint16_t			*hashTable		= 0;
+static uint8_t			*frameBuf		= 0;
+static uint32_t			maxBlock		= 0;
+static IS25lz_stats		stats			= {0};
+
+
+static uint32_t IS25lz_read32(const uint8_t *p){
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t IS25lz_hash(uint32_t sequence){
+	return (uint32_t)(sequence * 2654435761u) >> (32 - IS25LZ_HASH_BITS);
+}
+
+static uint32_t IS25lz_frameSize(uint32_t storedSize){
+	return (IS25LZ_HEADER_SIZE + storedSize + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+}
+
+/**
+ * IS25lz_putLength(uint8_t *dst, uint32_t length)
+ *
+ * @Brief
+ * 		Writes the 255-byte continuation of a literal / match length which did not fit the token nibble.
+ *
+ * @return
+ * 		uint32_t	- bytes written
+ */
+static uint32_t IS25lz_putLength(uint8_t *dst, uint32_t length){
+	uint32_t n = 0;
+
+	for(; length >= 255; length -= 255){
+		dst[n++] = 255;
+	}
+	dst[n++] = (uint8_t)length;
+	return n;
+}
+
+/**
+ * IS25lz_emit(...)
+ *
+ * @Brief
+ * 		Appends one sequence (literals + optional match) to the output.
+ *
+ * @return
+ * 		uint32_t	- new output length, 0 if the capacity is exceeded
+ */
+static uint32_t IS25lz_emit(uint8_t *dst, uint32_t op, uint32_t capacity, const uint8_t *literals, uint32_t literalCount,
+							uint32_t offset, uint32_t matchLength){
+	uint32_t need	= 1 + literalCount;
+	uint32_t token	= op;
+
+	if(literalCount >= 15){
+		need += (literalCount - 15) / 255 + 1;
+	}
+	if(offset != 0){
+		need += 2;
+		if(matchLength - LZ_MIN_MATCH >= 15){
+			need += (matchLength - LZ_MIN_MATCH - 15) / 255 + 1;
+		}
+	}
+	if(op + need > capacity){
+		return 0;
+	}
+	op++;
+
+	dst[token] = (uint8_t)((literalCount >= 15 ? 15 : literalCount) << 4);
+	if(literalCount >= 15){
+		op += IS25lz_putLength(&dst[op], literalCount - 15);
+	}
+	memcpy(&dst[op], literals, literalCount);
+	op += literalCount;
+
+	if(offset == 0){
+		return op;
+	}
+
+	dst[op++]	= (uint8_t)offset;
+	dst[op++]	= (uint8_t)(offset >> 8);
+	matchLength	-= LZ_MIN_MATCH;
+	dst[token]	|= (uint8_t)(matchLength >= 15 ? 15 : matchLength);
+	if(matchLength >= 15){
+		op += IS25lz_putLength(&dst[op], matchLength - 15);
+	}
+
+	return op;
+}
+
+/**
+ * IS25lz_init(uint8_t *arena, uint32_t size)
+ *
+ * @Brief
+ * 		Takes the working memory for the codec. The arena holds the hash table and one frame, see IS25LZ_ARENA_SIZE.
+ * 		It must stay valid (and is not thread-safe) as long as the layer is used.
+ *
+ * @Parameter
+ * 		uint8_t *	- arena, 2 byte aligned
+ * 		uint32_t	- arena size
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the arena can not hold the table and a one page frame
+ */
+flash_err IS25lz_init(uint8_t *arena, uint32_t size){
+	if(arena == 0 || ((uintptr_t)arena & 1) || size < IS25LZ_ARENA_SIZE(PAGE_SIZE)){
+		return MEMORY_ERROR;
+	}
+
+	hashTable	= (uint16_t *)arena;
+	frameBuf	= arena + IS25LZ_TABLE_SIZE;
+	maxBlock	= size - IS25LZ_TABLE_SIZE - IS25LZ_HEADER_SIZE;
+	if(maxBlock > IS25LZ_MAX_BLOCK){
+		maxBlock = IS25LZ_MAX_BLOCK;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25lz_maxBlock(void)
+ *
+ * @return
+ * 		uint32_t	- largest block IS25lz_writeBlock / IS25lz_readBlock can handle with the given arena
+ */
+uint32_t IS25lz_maxBlock(void){
+	return maxBlock;
+}
+
+/**
+ * IS25lz_compress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity)
+ *
+ * @Brief
+ * 		Greedy single pass LZ4 block compressor, one hash probe per position. Needs IS25lz_init.
+ *
+ * @Parameter
+ * 		const uint8_t *	- input, up to IS25LZ_MAX_BLOCK bytes
+ * 		uint32_t		- input size
+ * 		uint8_t *		- output
+ * 		uint32_t		- output capacity
+ *
+ * @return
+ * 		uint32_t	- compressed size, 0 if it does not fit the capacity
+ */
+uint32_t IS25lz_compress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity){
+	uint32_t ip		= 0;
+	uint32_t anchor	= 0;
+	uint32_t op		= 0;
+
+	if(hashTable == 0 || size > IS25LZ_MAX_BLOCK){
+		return 0;
+	}
+	memset(hashTable, 0, IS25LZ_TABLE_SIZE);
+
+	if(size > LZ_MATCH_GUARD){
+		uint32_t matchStartLimit	= size - LZ_MATCH_GUARD;
+		uint32_t matchEndLimit		= size - LZ_LAST_LITERALS;
+
+		while(ip < matchStartLimit){
+			uint32_t sequence	= IS25lz_read32(&src[ip]);
+			uint32_t h			= IS25lz_hash(sequence);
+			uint32_t ref		= hashTable[h];
+			uint32_t length;
+
+			hashTable[h] = (uint16_t)ip;
+			if(ref >= ip || ip - ref > LZ_MAX_OFFSET || IS25lz_read32(&src[ref]) != sequence){
+				ip++;
+				continue;
+			}
+
+			length = LZ_MIN_MATCH;
+			while(ip + length < matchEndLimit && src[ref + length] == src[ip + length]){
+				length++;
+			}
+
+			op = IS25lz_emit(dst, op, capacity, &src[anchor], ip - anchor, ip - ref, length);
+			if(op == 0){
+				return 0;
+			}
+			ip		+= length;
+			anchor	= ip;
+		}
+	}
+
+	op = IS25lz_emit(dst, op, capacity, &src[anchor], size - anchor, 0, 0);
+	return op;
+}
+
+/**
+ * IS25lz_decompress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity)
+ *
+ * @Brief
+ * 		LZ4 block decoder, every length and offset is checked so corrupt input can not write outside dst.
+ *
+ * @return
+ * 		uint32_t	- decompressed size, 0 on corrupt input or too small capacity
+ */
+uint32_t IS25lz_decompress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity){
+	uint32_t ip = 0;
+	uint32_t op = 0;
+
+	while(ip < size){
+		uint8_t token		= src[ip++];
+		uint32_t length		= token >> 4;
+		uint32_t offset;
+
+		if(length == 15){
+			uint8_t b;
+			do{
+				if(ip >= size){
+					return 0;
+				}
+				b = src[ip++];
+				length += b;
+			}while(b == 255);
+		}
+		if(length > size - ip || length > capacity - op){
+			return 0;
+		}
+		memcpy(&dst[op], &src[ip], length);
+		ip += length;
+		op += length;
+
+		if(ip == size){
+			break;							// Last sequence has no match
+		}
+
+		if(size - ip < 2){
+			return 0;
+		}
+		offset	= src[ip] | ((uint32_t)src[ip + 1] << 8);
+		ip		+= 2;
+		if(offset == 0 || offset > op){
+			return 0;
+		}
+
+		length = token & 0x0F;
+		if(length == 15){
+			uint8_t b;
+			do{
+				if(ip >= size){
+					return 0;
+				}
+				b = src[ip++];
+				length += b;
+			}while(b == 255);
+		}
+		length += LZ_MIN_MATCH;
+		if(length > capacity - op){
+			return 0;
+		}
+		for(uint32_t i = 0; i < length; i++, op++){
+			dst[op] = dst[op - offset];		// Overlapping copy
+		}
+	}
+
+	return op;
+}
+
+/**
+ * IS25lz_writeBlock(const uint8_t *data, uint32_t size, mem_address address, uint32_t *used)
+ *
+ * @Brief
+ * 		Compresses one block and programs it as a frame. The frame area must be erased, the caller erases ahead
+ * 		(e.g. IS25pool) and places the next frame at address + used.
+ *
+ * @Parameter
+ * 		const uint8_t *	- block, 1 ... IS25lz_maxBlock() bytes
+ * 		uint32_t		- block size
+ * 		mem_address		- page aligned frame address
+ * 		uint32_t *		- flash used by the frame, multiple of the page size
+ *
+ * @return
+ * 		flash_err
+ */
+flash_err IS25lz_writeBlock(const uint8_t *data, uint32_t size, mem_address address, uint32_t *used){
+	lz_header header;
+	IS25mem_busyTimer timer;
+	uint32_t stored;
+
+	IS25mem_busyStart(&timer);
+
+	if(frameBuf == 0 || size == 0 || size > maxBlock || (address.val & (PAGE_SIZE - 1))){
+		return MEMORY_ERROR;
+	}
+
+	stored = IS25lz_compress(data, size, &frameBuf[IS25LZ_HEADER_SIZE], size - 1);
+	header.flags = 0;
+	if(stored == 0){
+		memcpy(&frameBuf[IS25LZ_HEADER_SIZE], data, size);
+		stored			= size;
+		header.flags	= LZ_FLAG_RAW;
+		stats.blocksRaw++;
+	}else{
+		stats.blocksCompressed++;
+	}
+	stats.encodeUs += IS25mem_busyUs(&timer);
+
+	header.magic		= LZ_MAGIC;
+	header.rawSize		= (uint16_t)size;
+	header.storedSize	= (uint16_t)stored;
+	header.crc			= IS25mem_crc32(0, data, size);
+	memcpy(frameBuf, &header, IS25LZ_HEADER_SIZE);
+
+	if(IS25mem_programData(frameBuf, address, IS25LZ_HEADER_SIZE + stored) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	*used				= IS25lz_frameSize(stored);
+	stats.rawBytes		+= size;
+	stats.storedBytes	+= *used;
+	stats.writeUs		+= IS25mem_busyUs(&timer);
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25lz_readBlock(uint8_t *data, uint32_t capacity, mem_address address, uint32_t *size, uint32_t *used)
+ *
+ * @Brief
+ * 		Reads and decodes the frame at address and checks its CRC-32.
+ *
+ * @Parameter
+ * 		uint8_t *		- output
+ * 		uint32_t		- output capacity
+ * 		mem_address		- page aligned frame address
+ * 		uint32_t *		- block size, 0 if the address is erased (end of a log)
+ * 		uint32_t *		- flash used by the frame, the next frame starts at address + used
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR on a corrupt frame or too small capacity
+ */
+flash_err IS25lz_readBlock(uint8_t *data, uint32_t capacity, mem_address address, uint32_t *size, uint32_t *used){
+	lz_header header;
+	mem_address payload = address;
+	IS25mem_busyTimer timer;
+	IS25mem_busyTimer decodeTimer;
+
+	IS25mem_busyStart(&timer);
+	*size	= 0;
+	*used	= 0;
+	if(frameBuf == 0 || (address.val & (PAGE_SIZE - 1))){
+		return MEMORY_ERROR;
+	}
+
+	if(IS25mem_readDataFast(frameBuf, address, IS25LZ_HEADER_SIZE) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	memcpy(&header, frameBuf, IS25LZ_HEADER_SIZE);
+	if(header.magic == 0xFFFF){
+		return MEMORY_OK;
+	}
+	if(header.magic != LZ_MAGIC || header.storedSize > maxBlock || header.rawSize > capacity){
+		return MEMORY_ERROR;
+	}
+
+	payload.val += IS25LZ_HEADER_SIZE;
+	if(IS25mem_readDataFast(frameBuf, payload, header.storedSize) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	IS25mem_busyStart(&decodeTimer);
+	if(header.flags & LZ_FLAG_RAW){
+		if(header.storedSize != header.rawSize){
+			return MEMORY_ERROR;
+		}
+		memcpy(data, frameBuf, header.rawSize);
+	}else if(IS25lz_decompress(frameBuf, header.storedSize, data, header.rawSize) != header.rawSize){
+		return MEMORY_ERROR;
+	}
+	stats.decodeUs += IS25mem_busyUs(&decodeTimer);
+
+	if(IS25mem_crc32(0, data, header.rawSize) != header.crc){
+		return MEMORY_ERROR;
+	}
+
+	*size				= header.rawSize;
+	*used				= IS25lz_frameSize(header.storedSize);
+	stats.decodedBytes	+= header.rawSize;
+	stats.readUs		+= IS25mem_busyUs(&timer);
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25lz_getStats(IS25lz_stats *stats)
+ *
+ * @Brief
+ * 		Ratio = rawBytes / storedBytes, write rate = rawBytes / writeUs, decode rate = decodedBytes / decodeUs.
+ * 		Times are taken per block with the cycle counter (IS25mem_busyUs), a block takes far less than a HAL tick.
+ */
+void IS25lz_getStats(IS25lz_stats *out){
+	*out = stats;
+}
+
+void IS25lz_resetStats(void){
+	memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,50 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB LZ compression layer
+ *
+ *      LZ4 block format codec for log and record payloads. Every block is stored as one frame (header + payload)
+ *      starting on a page boundary, so any frame can be read back on its own. Blocks which do not shrink are stored
+ *      raw. The hash table and the frame buffer live in a caller provided arena, the block size is bounded by it.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_LZ_H_
+#define INC_IS25LQXXXB_LZ_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25LZ_HASH_BITS
+#define IS25LZ_HASH_BITS			10			// 2^n uint16_t entries in the arena
+#endif
+
+#define IS25LZ_HEADER_SIZE			12
+#define IS25LZ_TABLE_SIZE			((1UL << IS25LZ_HASH_BITS) * 2)
+#define IS25LZ_ARENA_SIZE(block)	(IS25LZ_TABLE_SIZE + IS25LZ_HEADER_SIZE + (block))	// Arena for blocks up to "block" bytes
+#define IS25LZ_MAX_BLOCK			65535
+
+typedef struct{
+	uint32_t	blocksCompressed;
+	uint32_t	blocksRaw;				// Blocks which did not shrink
+	uint32_t	rawBytes;				// Payload given to IS25lz_writeBlock
+	uint32_t	storedBytes;			// Flash used including header and page padding
+	uint64_t	encodeUs;
+	uint64_t	writeUs;				// Encode + program
+	uint32_t	decodedBytes;
+	uint64_t	decodeUs;
+	uint64_t	readUs;					// Read + decode
+}IS25lz_stats;
+
+
+//External function declaration
+
+extern flash_err IS25lz_init(uint8_t *arena, uint32_t size);
+extern uint32_t IS25lz_maxBlock(void);
+extern uint32_t IS25lz_compress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity);
+extern uint32_t IS25lz_decompress(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t capacity);
+extern flash_err IS25lz_writeBlock(const uint8_t *data, uint32_t size, mem_address address, uint32_t *used);
+extern flash_err IS25lz_readBlock(uint8_t *data, uint32_t capacity, mem_address address, uint32_t *size, uint32_t *used);
+extern void IS25lz_getStats(IS25lz_stats *stats);
+extern void IS25lz_resetStats(void);
+
+#endif /* INC_IS25LQXXXB_LZ_H_ */
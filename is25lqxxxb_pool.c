@@ -0,0 +1,277 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB erase-ahead sector pool
+ *
+ */
+
+//Includes
+#include "is25lqxxxb_pool.h"
+
+#define POOL_MASK				(IS25POOL_MAX_ZONES - 1)
+#define POOL_BLOCK_SECTORS		16				// Sectors of a 64 kByte block
+
+#if (IS25POOL_MAX_ZONES & POOL_MASK) != 0
+#error "IS25POOL_MAX_ZONES must be a power of two"
+#endif
+
+//Private variables
+
+// Erased zones, filled by the erase done callback (interrupt) and emptied by IS25pool_alloc
+static volatile uint16_t	freeRing[IS25POOL_MAX_ZONES];
+static volatile uint16_t	freeHead			= 0;
+static volatile uint16_t	freeTail			= 0;
+
+// Released zones waiting for an erase, filled by IS25pool_release and emptied by IS25pool_idle
+static uint16_t				dirtyRing[IS25POOL_MAX_ZONES];
+static uint16_t				dirtyHead			= 0;
+static uint16_t				dirtyTail			= 0;
+
+// Zones owned by the pool (dirty, erasing or erased), guards against double release
+static uint8_t				owned[IS25POOL_MAX_ZONES / 8];
+
+static uint8_t				zoneShift			= 0;			// log2 of the sectors per zone
+static uint16_t				zoneCount			= 0;
+
+static volatile uint8_t		eraseActive			= 0;			// Erase command running
+static volatile uint8_t		zoneActive			= 0;			// Zone taken from the backlog, not completely erased
+static volatile uint16_t	erasingZone			= 0;
+static volatile uint16_t	eraseStep			= 0;			// Erase commands of erasingZone done
+static uint16_t				targetDepth			= IS25POOL_DEFAULT_DEPTH;
+static IS25pool_metrics		stats				= {0};
+static void					(*appEraseDone)		= 0;			// Erase done callback of the application, restored after each erase
+
+
+/**
+ * IS25pool_eraseSteps(void)
+ *
+ * @return
+ * 		uint16_t	- erase commands per zone, block erases from 16 sectors on
+ */
+static uint16_t IS25pool_eraseSteps(void){
+	uint16_t sectors = (uint16_t)(1u << zoneShift);
+
+	return (sectors >= POOL_BLOCK_SECTORS) ? sectors / POOL_BLOCK_SECTORS : sectors;
+}
+
+/**
+ * IS25pool_eraseDone(void)
+ *
+ * @Brief
+ * 		Erase done callback, called from HAL_QSPI_StatusMatchCallback when a background erase has finished. The zone
+ * 		is handed out once its last erase command is done. The callback of the application is restored, an erase the pool
+ * 		did not start is only passed on to it.
+ */
+static void IS25pool_eraseDone(void){
+	void (*previous)(void) = (void (*)(void))appEraseDone;
+
+	setEraseDoneCallbackFct(appEraseDone);
+	if(!eraseActive){
+		if(previous != 0){
+			previous();
+		}
+		return;
+	}
+
+	eraseStep++;
+	if(eraseStep >= IS25pool_eraseSteps()){
+		freeRing[freeHead & POOL_MASK] = erasingZone;
+		freeHead++;
+		stats.erasesDone++;
+		zoneActive = 0;
+	}
+	eraseActive = 0;
+}
+
+/**
+ * IS25pool_init(uint16_t targetDepth)
+ *
+ * @Brief
+ * 		Resets the pool and derives the zone size from the detected memory. The pool starts empty, hand the free
+ * 		zones found while mounting to IS25pool_release. IS25mem_Init must have been called before.
+ *
+ * @Parameter
+ * 		uint16_t	- number of erased zones to keep ready, 0 selects IS25POOL_DEFAULT_DEPTH
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if no memory was detected
+ */
+flash_err IS25pool_init(uint16_t depth){
+	const IS25mem_MemorySpace *space = IS25mem_getMemorySpace();
+
+	if(space->sectors == 0){
+		return MEMORY_ERROR;
+	}
+	if(eraseActive){
+		return MEMORY_BUSY;
+	}
+
+	zoneShift = 0;
+	while((space->sectors >> zoneShift) > IS25POOL_MAX_ZONES){
+		zoneShift++;
+	}
+	zoneCount = (uint16_t)(space->sectors >> zoneShift);
+
+	freeHead	= freeTail	= 0;
+	dirtyHead	= dirtyTail	= 0;
+	zoneActive	= 0;
+	for(uint16_t i = 0; i < sizeof(owned); i++){
+		owned[i] = 0;
+	}
+
+	targetDepth = (depth != 0) ? depth : IS25POOL_DEFAULT_DEPTH;
+	if(targetDepth > zoneCount){
+		targetDepth = zoneCount;
+	}
+
+	stats = (IS25pool_metrics){0};
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25pool_zoneSectors(void)
+ *
+ * @return
+ * 		uint32_t	- sectors of one zone, every IS25pool_alloc hands out this many consecutive sectors
+ */
+uint32_t IS25pool_zoneSectors(void){
+	return 1UL << zoneShift;
+}
+
+/**
+ * IS25pool_alloc(uint32_t *sector)
+ *
+ * @Brief
+ * 		Hands out an erased zone in O(1). The zone belongs to the caller until it is given back via IS25pool_release.
+ *
+ * @Parameter
+ * 		uint32_t *	- first sector of the erased zone, IS25pool_zoneSectors() sectors are erased
+ *
+ * @return
+ * 		flash_err	- MEMORY_BUSY if no erased zone is ready, the caller has to erase one itself or retry later
+ */
+flash_err IS25pool_alloc(uint32_t *sector){
+	uint16_t zone;
+
+	if(freeTail == freeHead){
+		stats.allocMisses++;
+		return MEMORY_BUSY;
+	}
+
+	zone = freeRing[freeTail & POOL_MASK];
+	freeTail++;
+	owned[zone >> 3] &= ~(1u << (zone & 7));
+	stats.allocHits++;
+
+	*sector = (uint32_t)zone << zoneShift;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25pool_release(uint32_t sector)
+ *
+ * @Brief
+ * 		Gives a zone whose content is no longer needed to the pool. It will be erased by IS25pool_idle in the background.
+ *
+ * @Parameter
+ * 		uint32_t	- first sector of the zone, a multiple of IS25pool_zoneSectors()
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the zone does not exist, is not aligned or is already owned by the pool
+ */
+flash_err IS25pool_release(uint32_t sector){
+	uint16_t zone = (uint16_t)(sector >> zoneShift);
+
+	if(sector >= IS25mem_getMemorySpace()->sectors || (sector & ((1UL << zoneShift) - 1)) != 0){
+		return MEMORY_ERROR;
+	}
+	if(owned[zone >> 3] & (1u << (zone & 7))){
+		return MEMORY_ERROR;
+	}
+
+	owned[zone >> 3] |= (1u << (zone & 7));
+	dirtyRing[dirtyHead & POOL_MASK] = zone;
+	dirtyHead++;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25pool_idle(void)
+ *
+ * @Brief
+ * 		Call from the idle loop / idle task. Starts one background erase command if the pool is below its target depth
+ * 		or a zone is partly erased, and no erase is running. The erase itself is finished by the auto polling
+ * 		interrupt, so this never blocks for tSE. No other memory command may be issued while IS25pool_busy() returns "1".
+ */
+void IS25pool_idle(void){
+	mem_address address = {0};
+	flash_err err;
+
+	if(eraseActive){
+		return;
+	}
+	if(!zoneActive){
+		if(dirtyTail == dirtyHead || (uint16_t)(freeHead - freeTail) >= targetDepth){
+			return;
+		}
+		erasingZone	= dirtyRing[dirtyTail & POOL_MASK];
+		eraseStep	= 0;
+		zoneActive	= 1;
+		dirtyTail++;
+	}
+
+	eraseActive = 1;
+	if(pEraseDoneCallback != (void *)&IS25pool_eraseDone){
+		appEraseDone = pEraseDoneCallback;
+	}
+	setEraseDoneCallbackFct(&IS25pool_eraseDone);
+
+	if((1u << zoneShift) >= POOL_BLOCK_SECTORS){
+		address.val = ((uint32_t)erasingZone << (zoneShift + 12)) + (uint32_t)eraseStep * 0x10000UL;
+		err = IS25mem_writeEnable();
+		if(err == MEMORY_OK){
+			err = IS25mem_blockErase(address);
+		}
+	}else{
+		address.sector = ((uint32_t)erasingZone << zoneShift) + eraseStep;
+		err = IS25mem_writeEnable();
+		if(err == MEMORY_OK){
+			err = IS25mem_sectorErase(address);
+		}
+	}
+
+	if(err != MEMORY_OK){
+		//Keep the zone and step, try again on the next idle call
+		eraseActive = 0;
+		setEraseDoneCallbackFct(appEraseDone);
+		stats.eraseErrors++;
+	}
+}
+
+/**
+ * IS25pool_busy(void)
+ *
+ * @return
+ * 		uint8_t		- "1" while a background erase is running and the memory will ignore other commands
+ */
+uint8_t IS25pool_busy(void){
+	return eraseActive;
+}
+
+/**
+ * IS25pool_getMetrics(IS25pool_metrics *metrics)
+ *
+ * @Brief
+ * 		Snapshot of pool depth, erase backlog and counters.
+ */
+void IS25pool_getMetrics(IS25pool_metrics *metrics){
+	*metrics				= stats;
+	metrics->poolDepth		= (uint16_t)(freeHead - freeTail);
+	metrics->targetDepth	= targetDepth;
+	metrics->eraseBacklog	= (uint16_t)(dirtyHead - dirtyTail) + (zoneActive ? 1 : 0);
+	metrics->zoneSectors	= (uint16_t)(1u << zoneShift);
+	metrics->eraseActive	= eraseActive;
+}
@@ -0,0 +1,54 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB erase-ahead sector pool
+ *
+ *      Keeps a number of already erased 4 kByte sectors ready, so a write never has to wait for tSE.
+ *      Erases run in the background from IS25pool_idle() and complete through the erase done callback.
+ *
+ *      The pool manages zones of 1, 2, 4 ... sectors, the smallest zone size which divides the detected memory into
+ *      at most IS25POOL_MAX_ZONES zones. Parts up to 512 kByte use single sectors, larger parts hand out zones of
+ *      IS25pool_zoneSectors() sectors. Zones of 16 sectors and more are erased with 64 kByte block erases.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_POOL_H_
+#define INC_IS25LQXXXB_POOL_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25POOL_MAX_ZONES
+#define IS25POOL_MAX_ZONES			128			// Zones the pool can track, must be a power of two
+#endif
+
+#ifndef IS25POOL_DEFAULT_DEPTH
+#define IS25POOL_DEFAULT_DEPTH		4			// Erased sectors kept ready when 0 is passed to IS25pool_init
+#endif
+
+/**
+ * Pool metrics
+ */
+typedef struct{
+	uint16_t	poolDepth;			// Erased zones ready to hand out
+	uint16_t	targetDepth;		// Erased zones the pool tries to keep ready
+	uint16_t	eraseBacklog;		// Released zones waiting for an erase
+	uint16_t	zoneSectors;		// Sectors per zone
+	uint8_t		eraseActive;		// "1" a background erase is in progress
+	uint32_t	erasesDone;			// Background zone erases completed
+	uint32_t	eraseErrors;		// Background erases which could not be started
+	uint32_t	allocHits;			// IS25pool_alloc calls served from the pool
+	uint32_t	allocMisses;		// IS25pool_alloc calls which found the pool empty
+}IS25pool_metrics;
+
+
+//External function declaration
+
+extern flash_err IS25pool_init(uint16_t targetDepth);
+extern flash_err IS25pool_alloc(uint32_t *sector);
+extern flash_err IS25pool_release(uint32_t sector);
+extern uint32_t IS25pool_zoneSectors(void);
+extern void IS25pool_idle(void);
+extern uint8_t IS25pool_busy(void);
+extern void IS25pool_getMetrics(IS25pool_metrics *metrics);
+
+#endif /* INC_IS25LQXXXB_POOL_H_ */
@@ -0,0 +1,348 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB sequential read-ahead
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_prefetch.h"
+
+typedef struct{
+	uint32_t			nextAddress;		// A read starting here continues the stream
+	uint32_t			bufStart;
+	uint32_t			bufLen;				// Bytes valid in the buffer, or requested while inFlight
+	uint32_t			consumed;			// End of the buffer part which was served
+	uint32_t			window;
+	uint32_t			lastUse;
+	uint8_t				active;
+	volatile uint8_t	inFlight;
+	volatile uint8_t	failed;
+	volatile uint8_t	stale;				// Range was programmed / erased, set from interrupt context
+	void				*wait;				// Released when the prefetch is done
+	uint8_t				buffer[IS25PF_MAX_WINDOW];
+}pf_stream;
+
+//Private variables
+static const IS25sched_osHooks	*os		= 0;
+static pf_stream		streams[IS25PF_STREAMS];
+static uint32_t			candidates[IS25PF_CANDIDATES];
+static uint8_t			nextCandidate	= 0;
+static uint32_t			useCounter		= 0;
+static IS25pf_stats		stats			= {0};
+
+
+/**
+ * IS25pf_done(flash_err result, void *context)
+ *
+ * @Brief
+ * 		Scheduler callback of a prefetch, interrupt context.
+ */
+static void IS25pf_done(flash_err result, void *context){
+	pf_stream *s = (pf_stream *)context;
+
+	s->failed	= (result != MEMORY_OK);
+	s->inFlight	= 0;
+	os->waitRelease(s->wait);
+}
+
+/**
+ * IS25pf_waitStream(pf_stream *s)
+ *
+ * @Brief
+ * 		Blocks the calling task until the prefetch of the stream is done. A release left over from an earlier
+ * 		prefetch only causes one more check of inFlight.
+ */
+static void IS25pf_waitStream(pf_stream *s){
+	while(s->inFlight){
+		os->waitBlock(s->wait);
+	}
+}
+
+/**
+ * IS25pf_valid(const pf_stream *s)
+ *
+ * @return
+ * 		uint8_t		- "1" if the buffer content can be served
+ */
+static uint8_t IS25pf_valid(const pf_stream *s){
+	return !s->failed && !s->stale;
+}
+
+/**
+ * IS25pf_drop(pf_stream *s)
+ *
+ * @Brief
+ * 		Forgets the buffer content, bytes which were prefetched but not served count as wasted.
+ */
+static void IS25pf_drop(pf_stream *s){
+	IS25pf_waitStream(s);
+	if(IS25pf_valid(s) && s->bufLen != 0 && s->consumed < s->bufStart + s->bufLen){
+		uint32_t from = s->consumed > s->bufStart ? s->consumed : s->bufStart;
+		stats.bytesWasted += s->bufStart + s->bufLen - from;
+	}
+	s->bufLen	= 0;
+	s->consumed	= 0;
+	s->failed	= 0;
+	s->stale	= 0;
+}
+
+/**
+ * IS25pf_find(uint32_t address, uint32_t size)
+ *
+ * @Brief
+ * 		Stream which continues at address or buffers it. A read which continues a candidate (an earlier unbuffered
+ * 		read) is the second read of a new sequential stream and takes over the least recently used stream, other
+ * 		reads only become candidates. Random reads therefore never evict a running stream.
+ *
+ * @return
+ * 		pf_stream *	- 0 for a read which belongs to no stream
+ */
+static pf_stream *IS25pf_find(uint32_t address, uint32_t size, uint8_t *sequential){
+	pf_stream *lru = &streams[0];
+
+	*sequential = 0;
+	for(uint8_t i = 0; i < IS25PF_STREAMS; i++){
+		pf_stream *s = &streams[i];
+		if(s->active && s->nextAddress == address){
+			*sequential = 1;
+			return s;
+		}
+		if(s->bufLen != 0 && address >= s->bufStart && address < s->bufStart + s->bufLen){
+			return s;
+		}
+		if(lru->active && (!s->active || s->lastUse < lru->lastUse)){
+			lru = s;
+		}
+	}
+
+	for(uint8_t i = 0; i < IS25PF_CANDIDATES; i++){
+		if(candidates[i] == address){
+			candidates[i]	= 0xFFFFFFFFu;
+			*sequential		= 1;
+			IS25pf_drop(lru);
+			lru->active		= 1;
+			lru->window		= IS25PF_MIN_WINDOW;
+			return lru;
+		}
+	}
+
+	candidates[nextCandidate]	= address + size;
+	nextCandidate				= (nextCandidate + 1) % IS25PF_CANDIDATES;
+	return 0;
+}
+
+/**
+ * IS25pf_issue(pf_stream *s)
+ *
+ * @Brief
+ * 		Queues the read of the next window into the stream buffer. Buffered bytes behind the stream position are
+ * 		moved to the buffer start first, so the next read does not straddle the old and the new window.
+ */
+static void IS25pf_issue(pf_stream *s){
+	IS25async_request req;
+	uint32_t end = IS25mem_getMemorySpace()->bytes;
+	uint32_t tail = 0;
+	uint32_t length;
+
+	if(IS25pf_valid(s) && s->nextAddress >= s->bufStart && s->nextAddress < s->bufStart + s->bufLen){
+		tail = s->bufStart + s->bufLen - s->nextAddress;
+	}
+	if(tail >= s->window || s->nextAddress + tail >= end){
+		return;
+	}
+	length = s->window - tail;
+	if(length > end - s->nextAddress - tail){
+		length = end - s->nextAddress - tail;
+	}
+
+	if(tail != 0){
+		memmove(s->buffer, &s->buffer[s->nextAddress - s->bufStart], tail);
+	}else{
+		IS25pf_drop(s);
+	}
+	s->bufStart	= s->nextAddress;
+	s->bufLen	= tail + length;
+	s->consumed	= s->nextAddress;
+	s->inFlight	= 1;
+
+	req.op				= IS25_REQ_READ;
+	req.address.val		= s->bufStart + tail;
+	req.buffer			= &s->buffer[tail];
+	req.size			= length;
+	req.callback		= IS25pf_done;
+	req.context			= s;
+	if(IS25sched_submit(&req) != MEMORY_OK){
+		s->inFlight	= 0;
+		s->bufLen	= tail;
+		return;
+	}
+
+	stats.prefetches++;
+	stats.bytesPrefetched += length;
+}
+
+/**
+ * IS25pf_init(const IS25sched_osHooks *hooks)
+ *
+ * @Brief
+ * 		Resets all streams and counters and registers IS25pf_invalidate as change callback of the driver. Prefetches
+ * 		and the reads which miss go through the scheduler, call IS25sched_init first.
+ *
+ * @Parameter
+ * 		const IS25sched_osHooks *	- wait objects for the prefetches, usually the hooks given to IS25sched_init
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if a wait object can not be created
+ */
+flash_err IS25pf_init(const IS25sched_osHooks *hooks){
+	if(os != 0){
+		IS25mem_setChangeCallback(0);
+		for(uint8_t i = 0; i < IS25PF_STREAMS; i++){
+			IS25pf_waitStream(&streams[i]);
+			os->waitDelete(streams[i].wait);
+		}
+		os = 0;
+	}
+
+	memset(streams, 0, sizeof(streams));
+	memset(candidates, 0xFF, sizeof(candidates));
+	nextCandidate = 0;
+	memset(&stats, 0, sizeof(stats));
+	useCounter = 0;
+
+	for(uint8_t i = 0; i < IS25PF_STREAMS; i++){
+		if((streams[i].wait = hooks->waitCreate()) == 0){
+			while(i-- > 0){
+				hooks->waitDelete(streams[i].wait);
+			}
+			return MEMORY_ERROR;
+		}
+	}
+	os = hooks;
+	IS25mem_setChangeCallback(IS25pf_invalidate);
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25pf_read(uint8_t *buffer, mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Blocking read, replaces IS25mem_fastReadData / IS25mem_readDataFast for streamed data. The part of the read
+ * 		which is not prefetched is read with IS25sched_read, so it queues behind the other producers. Streams are not
+ * 		locked, call it from one task.
+ *
+ * @Parameter
+ * 		uint8_t *		- destination
+ * 		mem_address		- address
+ * 		uint32_t		- size
+ *
+ * @return
+ * 		flash_err
+ */
+flash_err IS25pf_read(uint8_t *buffer, mem_address address, uint32_t size){
+	uint32_t start = IS25PF_TIMESTAMP();
+	uint32_t from = address.val;
+	uint32_t served = 0;
+	uint32_t remaining;
+	uint8_t sequential;
+	uint8_t late = 0;
+	pf_stream *s;
+
+	if(size == 0){
+		return MEMORY_OK;
+	}
+	stats.reads++;
+
+	s = IS25pf_find(from, size, &sequential);
+	if(s != 0 && !sequential){
+		s->window = IS25PF_MIN_WINDOW;
+	}
+
+	//Serve the head of the read from the buffer
+	if(s != 0 && s->bufLen != 0 && from >= s->bufStart && from < s->bufStart + s->bufLen){
+		if(s->inFlight){
+			IS25pf_waitStream(s);
+			late = 1;
+		}
+		if(IS25pf_valid(s)){
+			served = s->bufStart + s->bufLen - from;
+			if(served > size){
+				served = size;
+			}
+			memcpy(buffer, &s->buffer[from - s->bufStart], served);
+			if(from + served > s->consumed){
+				s->consumed = from + served;
+			}
+			stats.bytesHit += served;
+		}
+	}
+
+	if(served < size){
+		mem_address rest;
+		rest.val = from + served;
+		if(IS25sched_read(buffer + served, rest, size - served) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+
+	if(s == 0){
+		stats.misses++;
+		stats.missCycles += IS25PF_TIMESTAMP() - start;
+		return MEMORY_OK;
+	}
+
+	s->nextAddress	= from + size;
+	s->lastUse		= ++useCounter;
+
+	//Refill the buffer of a sequential stream when it is half consumed or the next read of the same size would
+	//run past it
+	remaining = 0;
+	if(s->nextAddress >= s->bufStart && s->nextAddress < s->bufStart + s->bufLen){
+		remaining = s->bufStart + s->bufLen - s->nextAddress;
+	}
+	if(sequential && !s->inFlight && (remaining < size || remaining < s->window / 2)){
+		if(served != 0 && s->window < IS25PF_MAX_WINDOW){
+			s->window <<= 1;
+		}
+		IS25pf_issue(s);
+	}
+
+	if(served == size){
+		if(late){
+			stats.lateHits++;
+			stats.lateHitCycles += IS25PF_TIMESTAMP() - start;
+		}else{
+			stats.hits++;
+			stats.hitCycles += IS25PF_TIMESTAMP() - start;
+		}
+	}else{
+		stats.misses++;
+		stats.missCycles += IS25PF_TIMESTAMP() - start;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25pf_invalidate(mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Drops prefetched data of a range which was programmed or erased. Registered as change callback of the driver
+ * 		by IS25pf_init, runs in interrupt context: the buffer is only marked, IS25pf_read and IS25pf_issue discard
+ * 		it. A prefetch which is still running was queued after the change and is marked as well.
+ */
+void IS25pf_invalidate(mem_address address, uint32_t size){
+	for(uint8_t i = 0; i < IS25PF_STREAMS; i++){
+		pf_stream *s = &streams[i];
+		if(s->bufLen != 0 && address.val < s->bufStart + s->bufLen && s->bufStart < address.val + size){
+			s->stale = 1;
+		}
+	}
+}
+
+void IS25pf_getStats(IS25pf_stats *out){
+	*out = stats;
+}
@@ -0,0 +1,61 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB sequential read-ahead
+ *
+ *      Reads are assigned to streams by their address: a read which starts where the last read of a stream ended
+ *      continues that stream. A stream which is read sequentially gets the following window prefetched through
+ *      the scheduler (is25lqxxxb_sched.c) while the caller processes its data. The window doubles every time
+ *      a prefetch is consumed completely, up to IS25PF_MAX_WINDOW, and drops back to IS25PF_MIN_WINDOW on a jump.
+ *      Programs and erases of the driver, the request queue and the scheduler invalidate overlapping buffers.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_PREFETCH_H_
+#define INC_IS25LQXXXB_PREFETCH_H_
+
+#include "is25lqxxxb_sched.h"
+
+#ifndef IS25PF_STREAMS
+#define IS25PF_STREAMS				2			// Concurrently tracked streams, each owns a IS25PF_MAX_WINDOW buffer
+#endif
+
+#ifndef IS25PF_CANDIDATES
+#define IS25PF_CANDIDATES			4			// Unbuffered reads remembered to detect the start of a stream
+#endif
+
+#ifndef IS25PF_MIN_WINDOW
+#define IS25PF_MIN_WINDOW			256
+#endif
+
+#ifndef IS25PF_MAX_WINDOW
+#define IS25PF_MAX_WINDOW			2048
+#endif
+
+#ifndef IS25PF_TIMESTAMP
+#define IS25PF_TIMESTAMP()			(DWT->CYCCNT)	// Started by IS25mem_Init (IS25_BUSY_CYCLES_ENABLE)
+#endif
+
+typedef struct{
+	uint32_t	reads;
+	uint32_t	hits;					// Served from a finished prefetch
+	uint32_t	lateHits;				// Served from a prefetch which was still running
+	uint32_t	misses;					// Read from the memory, also partial hits
+	uint32_t	prefetches;
+	uint32_t	bytesPrefetched;
+	uint32_t	bytesHit;				// Bytes served from prefetch buffers
+	uint32_t	bytesWasted;			// Prefetched bytes which were dropped unread
+	uint64_t	hitCycles;				// IS25PF_TIMESTAMP ticks spent in hits / late hits / misses,
+	uint64_t	lateHitCycles;			// average per class = cycles / count
+	uint64_t	missCycles;
+}IS25pf_stats;
+
+
+//External function declaration
+
+extern flash_err IS25pf_init(const IS25sched_osHooks *hooks);
+extern flash_err IS25pf_read(uint8_t *buffer, mem_address address, uint32_t size);
+extern void IS25pf_invalidate(mem_address address, uint32_t size);
+extern void IS25pf_getStats(IS25pf_stats *stats);
+
+#endif /* INC_IS25LQXXXB_PREFETCH_H_ */
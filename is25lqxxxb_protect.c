@@ -0,0 +1,348 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB block protection aware write planner
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_protect.h"
+
+typedef struct{
+	IS25prot_op		op;
+	const uint8_t	*data;
+	mem_address		address;
+	uint32_t		size;				// Bytes affected
+}prot_request;
+
+//Private variables
+static extFlash_stat		status			= 0;			// Cached status register
+static extFlash_func		function		= 0;			// Cached function register (TBS)
+static uint8_t				statusValid		= 0;
+static int32_t				unlockedSector	= -1;			// Opened by IS25prot_execute with SECUNLOCK
+static prot_request			batch[IS25PROT_OPS];
+static uint8_t				batchCount		= 0;
+static IS25prot_stats		stats			= {0};
+
+
+/**
+ * IS25prot_refresh(void)
+ *
+ * @Brief
+ * 		Reloads the cached status and function register. Call after the status register was written elsewhere, e.g.
+ * 		by IS25mem_setReadConfig (QE).
+ */
+flash_err IS25prot_refresh(void){
+	if(IS25mem_readStatusReg(&status) != MEMORY_OK || IS25mem_readFctReg(&function) != MEMORY_OK){
+		statusValid = 0;
+		return MEMORY_ERROR;
+	}
+	statusValid = 1;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25prot_guard(mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Protect callback of the driver: IS25prot_check, except for the sector IS25prot_execute opened with SECUNLOCK.
+ */
+static flash_err IS25prot_guard(mem_address address, uint32_t size){
+	if(unlockedSector >= 0 && size != 0 && (address.val >> 12) == (uint32_t)unlockedSector &&
+	   ((address.val + size - 1) >> 12) == (uint32_t)unlockedSector){
+		return MEMORY_OK;
+	}
+	return IS25prot_check(address, size);
+}
+
+/**
+ * IS25prot_init(void)
+ *
+ * @Brief
+ * 		Loads status and function register, clears batch and statistics and registers the protect callback of the
+ * 		driver, from then on programs and erases of the protected area return MEMORY_PROTECTED_ERR. Call after
+ * 		IS25mem_Init.
+ */
+flash_err IS25prot_init(void){
+	batchCount		= 0;
+	unlockedSector	= -1;
+	memset(&stats, 0, sizeof(stats));
+	if(IS25prot_refresh() != MEMORY_OK){
+		IS25mem_setProtectCallback(0);
+		return MEMORY_ERROR;
+	}
+	IS25mem_setProtectCallback(IS25prot_guard);
+	return MEMORY_OK;
+}
+
+/**
+ * IS25prot_writeStatus(extFlash_stat value)
+ *
+ * @Brief
+ * 		WRSR with write enable and wait for the write cycle, the result is read back into the cache.
+ *
+ * @return
+ * 		flash_err	- MEMORY_PROTECTED_ERR if the register did not take the BP bits (SRWD with WP# low)
+ */
+static flash_err IS25prot_writeStatus(extFlash_stat value){
+	value &= 0xFC;
+
+	stats.statusWrites++;
+	if(IS25mem_writeEnable() != MEMORY_OK || IS25mem_writeStatReg(&value) != MEMORY_OK ||
+	   IS25mem_waitMemReady(IS25_TW_MAX_MS) != MEMORY_OK || IS25prot_refresh() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if((status & IS25PROT_BP_MASK) != (value & IS25PROT_BP_MASK)){
+		return MEMORY_PROTECTED_ERR;
+	}
+	return MEMORY_OK;
+}
+
+/**
+ * IS25prot_range(extFlash_stat value, uint32_t *start, uint32_t *size)
+ *
+ * @Brief
+ * 		Protected area of a status register value.
+ */
+static void IS25prot_range(extFlash_stat value, uint32_t *start, uint32_t *size){
+	uint32_t bytes	= IS25mem_getMemorySpace()->bytes;
+	uint8_t bp		= IS25PROT_BP(value);
+
+	*size = 0;
+	if(bp != 0){
+		*size = (bp >= 15 || (65536UL << (bp - 1)) >= bytes) ? bytes : 65536UL << (bp - 1);
+	}
+	*start = (function & IS25PROT_TBS) ? 0 : bytes - *size;
+}
+
+/**
+ * IS25prot_getRange(uint32_t *start, uint32_t *size)
+ *
+ * @Brief
+ * 		Protected area of the cached status register, size 0 if nothing is protected.
+ */
+void IS25prot_getRange(uint32_t *start, uint32_t *size){
+	IS25prot_range(status, start, size);
+}
+
+/**
+ * IS25prot_check(mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Checks a program / erase range against the cached protection, no memory access.
+ *
+ * @return
+ * 		flash_err	- MEMORY_PROTECTED_ERR if any byte of the range is protected
+ */
+flash_err IS25prot_check(mem_address address, uint32_t size){
+	uint32_t start;
+	uint32_t length;
+
+	if(!statusValid){
+		return MEMORY_ERROR;
+	}
+
+	IS25prot_range(status, &start, &length);
+	if(length != 0 && size != 0 && address.val < start + length && address.val + size > start){
+		return MEMORY_PROTECTED_ERR;
+	}
+	return MEMORY_OK;
+}
+
+/**
+ * IS25prot_setProtection(uint8_t bp)
+ *
+ * @Brief
+ * 		Changes the protected area permanently (BP3-BP0), the other status bits are kept. Skips the WRSR if the value
+ * 		is already set.
+ */
+flash_err IS25prot_setProtection(uint8_t bp){
+	if(!statusValid && IS25prot_refresh() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25PROT_BP(status) == (bp & 0x0F)){
+		return MEMORY_OK;
+	}
+	return IS25prot_writeStatus((extFlash_stat)((status & ~IS25PROT_BP_MASK) | ((bp & 0x0F) << 2)));
+}
+
+/**
+ * IS25prot_begin(void)
+ *
+ * @Brief
+ * 		Starts a new batch, operations of an unexecuted batch are dropped.
+ */
+void IS25prot_begin(void){
+	batchCount = 0;
+}
+
+static flash_err IS25prot_add(IS25prot_op op, const uint8_t *data, mem_address address, uint32_t size){
+	if(batchCount >= IS25PROT_OPS){
+		return MEMORY_BUSY;
+	}
+	batch[batchCount].op		= op;
+	batch[batchCount].data		= data;
+	batch[batchCount].address	= address;
+	batch[batchCount].size		= size;
+	batchCount++;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25prot_addProgram(const uint8_t *data, mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Adds a program to the batch. The data has to stay valid until IS25prot_execute returns.
+ *
+ * @return
+ * 		flash_err	- MEMORY_BUSY if the batch is full (IS25PROT_OPS)
+ */
+flash_err IS25prot_addProgram(const uint8_t *data, mem_address address, uint32_t size){
+	return IS25prot_add(IS25_PROT_PROGRAM, data, address, size);
+}
+
+/**
+ * IS25prot_addErase(IS25prot_op op, mem_address address)
+ *
+ * @Brief
+ * 		Adds a sector (IS25_PROT_SECTOR_ERASE) or 64 kByte block erase (IS25_PROT_BLOCK_ERASE) to the batch.
+ */
+flash_err IS25prot_addErase(IS25prot_op op, mem_address address){
+	if(op == IS25_PROT_SECTOR_ERASE){
+		address.val &= ~0xFFFUL;
+		return IS25prot_add(op, 0, address, 4096UL);
+	}
+	if(op == IS25_PROT_BLOCK_ERASE){
+		address.val &= ~0xFFFFUL;
+		return IS25prot_add(op, 0, address, 65536UL);
+	}
+	return MEMORY_ERROR;
+}
+
+/**
+ * IS25prot_pages(const prot_request *req)
+ *
+ * @return
+ * 		uint32_t	- program / erase commands of a request, each would need its own WRSR pair without the planner
+ */
+static uint32_t IS25prot_pages(const prot_request *req){
+	if(req->op != IS25_PROT_PROGRAM || req->size == 0){
+		return 1;
+	}
+	return ((req->address.val + req->size - 1) >> 8) - (req->address.val >> 8) + 1;
+}
+
+static flash_err IS25prot_run(const prot_request *req){
+	switch(req->op){
+		case IS25_PROT_PROGRAM:			return IS25mem_programData((uint8_t *)req->data, req->address, req->size);
+		case IS25_PROT_SECTOR_ERASE:	return IS25mem_sectorEraseWait(req->address);
+		case IS25_PROT_BLOCK_ERASE:		return IS25mem_blockEraseWait(req->address);
+		default:						return MEMORY_ERROR;
+	}
+}
+
+/**
+ * IS25prot_execute(uint8_t unprotect)
+ *
+ * @Brief
+ * 		Runs the batch in order. Without unprotect, a batch touching the protected area is rejected as a whole before
+ * 		anything is sent. With unprotect, the protection is lifted right before the first protected operation and
+ * 		restored right after the last one, also if an operation fails:
+ * 			- all protected operations inside one sector:	SECUNLOCK ... SECLOCK, no WRSR
+ * 			- otherwise:									one WRSR clearing BP3-BP0, one WRSR restoring them
+ * 		The batch is empty afterwards.
+ *
+ * @Parameter
+ * 		uint8_t		- "1" allows writes into the protected area
+ *
+ * @return
+ * 		flash_err	- MEMORY_PROTECTED_ERR if rejected or the protection could not be lifted
+ */
+flash_err IS25prot_execute(uint8_t unprotect){
+	extFlash_stat saved;
+	uint8_t count		= batchCount;
+	uint8_t first		= count;			// First / last protected operation
+	uint8_t last		= 0;
+	uint8_t sameSector	= 1;
+	uint8_t unlocked	= 0;
+	uint32_t pages		= 0;
+	uint32_t sector		= 0;
+	flash_err err		= MEMORY_OK;
+	flash_err relock;
+
+	batchCount = 0;
+	if(!statusValid && IS25prot_refresh() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	saved = status;
+	stats.batches++;
+	stats.ops += count;
+
+	for(uint8_t i = 0; i < count; i++){
+		if(IS25prot_check(batch[i].address, batch[i].size) != MEMORY_PROTECTED_ERR){
+			continue;
+		}
+		if(first == count){
+			first	= i;
+			sector	= batch[i].address.sector;
+		}
+		last		= i;
+		pages	   += IS25prot_pages(&batch[i]);
+		sameSector &= batch[i].op != IS25_PROT_BLOCK_ERASE && batch[i].address.sector == sector &&
+					  ((batch[i].address.val + batch[i].size - 1) >> 12) == sector;
+		stats.protectedOps++;
+	}
+
+	if(first < count && !unprotect){
+		stats.rejected++;
+		return MEMORY_PROTECTED_ERR;
+	}
+	if(first < count && IS25mem_getMemorySpace()->addressBytes == 4){
+		sameSector = 0;						// SECUNLOCK has a 3 byte address only
+	}
+
+	for(uint8_t i = 0; i < count && err == MEMORY_OK; i++){
+		if(i == first){
+			if(sameSector){
+				err = IS25mem_sectorUnlock(batch[i].address);
+				stats.sectorUnlocks++;
+			}else{
+				err = IS25prot_writeStatus(saved & ~IS25PROT_BP_MASK);
+			}
+			if(err != MEMORY_OK){
+				//Nothing was written yet, bring back the protection if the WRSR went through partly
+				if(!sameSector && (status & IS25PROT_BP_MASK) != (saved & IS25PROT_BP_MASK)){
+					IS25prot_writeStatus(saved);
+				}
+				stats.rejected++;
+				return err == MEMORY_ERROR ? MEMORY_ERROR : MEMORY_PROTECTED_ERR;
+			}
+			unlocked		= 1;
+			unlockedSector	= sameSector ? (int32_t)sector : -1;
+		}
+
+		err = IS25prot_run(&batch[i]);
+
+		//Relock after the last protected operation, or right away if an operation failed
+		if(unlocked && (i == last || err != MEMORY_OK)){
+			relock			= sameSector ? IS25mem_sectorLock() : IS25prot_writeStatus(saved);
+			unlocked		= 0;
+			unlockedSector	= -1;
+			if(err == MEMORY_OK){
+				err = relock;
+			}
+		}
+	}
+
+	if(pages != 0){
+		uint32_t used = sameSector ? 0 : 2;
+		stats.statusWritesSaved += 2 * pages > used ? 2 * pages - used : 0;
+	}
+
+	return err;
+}
+
+void IS25prot_getStats(IS25prot_stats *out){
+	*out = stats;
+}
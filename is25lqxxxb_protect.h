@@ -0,0 +1,64 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB block protection aware write planner
+ *
+ *      Keeps a copy of the status and function register and checks program / erase ranges against the area protected
+ *      by BP3-BP0. The device ignores a write into a protected block without any error: the program or erase
+ *      completes at once and the data is not changed. IS25prot_init registers the check as protect callback of the
+ *      driver, so IS25mem_programData, the erase functions and IS25async_submit (and with them the scheduler,
+ *      transactions, image store, ...) return MEMORY_PROTECTED_ERR instead, before anything is sent. Writes which
+ *      have to go into the protected area are collected in a batch. IS25prot_execute lifts the protection once for the
+ *      whole batch: with SECUNLOCK / SECLOCK if all protected operations are inside one sector, otherwise with one
+ *      WRSR before the first and one after the last protected operation. Every avoided WRSR saves a non-volatile
+ *      write cycle (IS25_TW_MAX_MS).
+ *
+ *      BP = 0 protects nothing, BP = n the upper (TBS set in the function register: lower) 64 kByte << (n - 1), up to
+ *      the whole memory. On the IS25LQ040B this matches BU1 / BU2 / BU4 of flash_bwp_t.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_PROTECT_H_
+#define INC_IS25LQXXXB_PROTECT_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25PROT_OPS
+#define IS25PROT_OPS				16			// Operations per batch
+#endif
+
+#define IS25PROT_BP_MASK			0x3C		// BP3-BP0 in the status register
+#define IS25PROT_TBS				0x02		// Function register, "1": the protected area starts at address 0
+#define IS25PROT_BP(status)			(((status) & IS25PROT_BP_MASK) >> 2)
+
+typedef enum{
+	IS25_PROT_PROGRAM			= 0x00,		// Any size, split into page programs
+	IS25_PROT_SECTOR_ERASE		= 0x01,
+	IS25_PROT_BLOCK_ERASE		= 0x02		// 64 kByte
+}IS25prot_op;
+
+typedef struct{
+	uint32_t	batches;
+	uint32_t	ops;
+	uint32_t	protectedOps;			// Operations inside the protected area
+	uint32_t	rejected;				// MEMORY_PROTECTED_ERR returned
+	uint32_t	statusWrites;			// WRSR cycles
+	uint32_t	sectorUnlocks;			// SECUNLOCK used instead of two WRSR
+	uint32_t	statusWritesSaved;		// Against unprotect / reprotect per page program or erase
+}IS25prot_stats;
+
+
+//External function declaration
+
+extern flash_err IS25prot_init(void);
+extern flash_err IS25prot_refresh(void);
+extern flash_err IS25prot_setProtection(uint8_t bp);
+extern void IS25prot_getRange(uint32_t *start, uint32_t *size);
+extern flash_err IS25prot_check(mem_address address, uint32_t size);
+extern void IS25prot_begin(void);
+extern flash_err IS25prot_addProgram(const uint8_t *data, mem_address address, uint32_t size);
+extern flash_err IS25prot_addErase(IS25prot_op op, mem_address address);
+extern flash_err IS25prot_execute(uint8_t unprotect);
+extern void IS25prot_getStats(IS25prot_stats *stats);
+
+#endif /* INC_IS25LQXXXB_PROTECT_H_ */
@@ -0,0 +1,520 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB thread-safe front end with read priority
+ *
+ */
+
+//Includes
+#include <stdatomic.h>
+#include "is25lqxxxb_sched.h"
+
+#define SCHED_MASK				(IS25SCHED_QUEUE_DEPTH - 1)
+
+#if (IS25SCHED_QUEUE_DEPTH & SCHED_MASK) != 0
+#error "IS25SCHED_QUEUE_DEPTH must be a power of two"
+#endif
+
+#define CLASS_READ				0
+#define CLASS_PROGRAM			1
+#define CLASS_ERASE				2
+
+#define FLIGHT_RUNNING			0x01			// running is in the request queue
+#define FLIGHT_PREEMPT			0x02			// preempt is in the request queue, the running erase is suspended
+
+typedef struct{
+	atomic_uint			seq;
+	IS25async_request	request;
+}sched_slot;
+
+typedef struct{
+	IS25async_request	request;
+	uint8_t				bypassed;				// Pending: times overtaken, running erase: reads served while suspended
+}sched_job;
+
+typedef struct{
+	void				*wait;
+	flash_err			result;
+}sched_waiter;
+
+//Private variables
+
+// Bounded multi-producer queue (sequence number per slot), safe from tasks and interrupts
+static sched_slot			submitRing[IS25SCHED_QUEUE_DEPTH];
+static atomic_uint			enqueuePos;
+static atomic_uint			dequeuePos;
+
+// Pending requests in arrival order, only touched by the dispatcher
+static sched_job			pending[IS25SCHED_QUEUE_DEPTH];
+static uint8_t				pendingCnt			= 0;
+static sched_job			running;
+static sched_job			preempt;
+
+static atomic_flag			dispatching			= ATOMIC_FLAG_INIT;
+static atomic_uint			dispatchAgain;							// Work arrived while the dispatcher was taken
+static atomic_uint			inFlight;								// FLIGHT_xxx
+static IS25sched_osHooks	osHooks				= {0};
+
+static atomic_uint			statSubmitted;
+static atomic_uint			statRejected;
+static uint32_t				statReordered		= 0;
+static uint32_t				statForced			= 0;
+static uint32_t				statSuspended		= 0;
+
+//function prototypes
+static void IS25sched_dispatch(void);
+
+
+/**
+ * IS25sched_class(const IS25async_request *req)
+ *
+ * @return
+ * 		uint8_t		- scheduling class, lower value is served first
+ */
+static uint8_t IS25sched_class(const IS25async_request *req){
+	switch(req->op){
+		case IS25_REQ_PROGRAM:			return CLASS_PROGRAM;
+		case IS25_REQ_SECTOR_ERASE:
+		case IS25_REQ_BLOCK_ERASE:
+		case IS25_REQ_CHIP_ERASE:		return CLASS_ERASE;
+		default:						return CLASS_READ;
+	}
+}
+
+/**
+ * IS25sched_range(const IS25async_request *req, uint32_t *start, uint32_t *end)
+ *
+ * @Brief
+ * 		Memory range [start, end) touched by the request.
+ *
+ * @return
+ * 		uint8_t		- "0" for requests without a memory range (status, ID)
+ */
+static uint8_t IS25sched_range(const IS25async_request *req, uint32_t *start, uint32_t *end){
+	switch(req->op){
+		case IS25_REQ_READ:
+		case IS25_REQ_PROGRAM:			*start	= req->address.val;
+										*end	= req->address.val + req->size;
+										return 1;
+		case IS25_REQ_SECTOR_ERASE:		*start	= req->address.val & ~0xFFFu;
+										*end	= *start + 0x1000;
+										return 1;
+		case IS25_REQ_BLOCK_ERASE:		*start	= req->address.val & ~0xFFFFu;
+										*end	= *start + 0x10000;
+										return 1;
+		case IS25_REQ_CHIP_ERASE:		*start	= 0;
+										*end	= 0xFFFFFFFFu;
+										return 1;
+		default:						return 0;
+	}
+}
+
+/**
+ * IS25sched_conflicts(const IS25async_request *a, const IS25async_request *b)
+ *
+ * @return
+ * 		uint8_t		- "1" if the order of both requests matters (overlapping ranges and at least one writes)
+ */
+static uint8_t IS25sched_conflicts(const IS25async_request *a, const IS25async_request *b){
+	uint32_t aStart, aEnd, bStart, bEnd;
+
+	if(IS25sched_class(a) == CLASS_READ && IS25sched_class(b) == CLASS_READ){
+		return 0;
+	}
+	if(!IS25sched_range(a, &aStart, &aEnd) || !IS25sched_range(b, &bStart, &bEnd)){
+		return 0;
+	}
+
+	return (aStart < bEnd) && (bStart < aEnd);
+}
+
+/**
+ * IS25sched_dequeue(IS25async_request *request)
+ *
+ * @return
+ * 		uint8_t		- "1" if a request was taken out of the submission queue
+ */
+static uint8_t IS25sched_dequeue(IS25async_request *request){
+	unsigned pos = atomic_load_explicit(&dequeuePos, memory_order_relaxed);
+	sched_slot *slot = &submitRing[pos & SCHED_MASK];
+
+	if(atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1){
+		return 0;
+	}
+
+	*request = slot->request;
+	atomic_store_explicit(&dequeuePos, pos + 1, memory_order_relaxed);
+	atomic_store_explicit(&slot->seq, pos + IS25SCHED_QUEUE_DEPTH, memory_order_release);
+
+	return 1;
+}
+
+/**
+ * IS25sched_pick(void)
+ *
+ * @Brief
+ * 		Selects the next pending request: the oldest one if it was overtaken too often, otherwise the first
+ * 		request of the best class which does not conflict with an older pending request.
+ *
+ * @return
+ * 		int		- index into pending, -1 if nothing is pending
+ */
+static int IS25sched_pick(void){
+	if(pendingCnt == 0){
+		return -1;
+	}
+	if(pending[0].bypassed >= IS25SCHED_MAX_BYPASS){
+		statForced++;
+		return 0;
+	}
+
+	for(uint8_t cls = CLASS_READ; cls <= CLASS_ERASE; cls++){
+		for(uint8_t i = 0; i < pendingCnt; i++){
+			uint8_t blocked = 0;
+
+			if(IS25sched_class(&pending[i].request) != cls){
+				continue;
+			}
+			for(uint8_t j = 0; j < i && !blocked; j++){
+				blocked = IS25sched_conflicts(&pending[j].request, &pending[i].request);
+			}
+			if(!blocked){
+				return i;
+			}
+		}
+	}
+
+	//Unreachable, the oldest request never conflicts with an older one
+	return 0;
+}
+
+/**
+ * IS25sched_pickPreempt(void)
+ *
+ * @Brief
+ * 		Selects a read which may run while the running sector / block erase is suspended: it must not touch the
+ * 		erased range nor an older pending write. Every erase serves at most IS25SCHED_MAX_PREEMPT reads this way.
+ *
+ * @return
+ * 		int		- index into pending, -1 if no read qualifies
+ */
+static int IS25sched_pickPreempt(void){
+	if((running.request.op != IS25_REQ_SECTOR_ERASE && running.request.op != IS25_REQ_BLOCK_ERASE) ||
+	   running.bypassed >= IS25SCHED_MAX_PREEMPT){
+		return -1;
+	}
+
+	for(uint8_t i = 0; i < pendingCnt; i++){
+		uint8_t blocked;
+
+		if(IS25sched_class(&pending[i].request) != CLASS_READ){
+			continue;
+		}
+		blocked = IS25sched_conflicts(&running.request, &pending[i].request);
+		for(uint8_t j = 0; j < i && !blocked; j++){
+			blocked = IS25sched_conflicts(&pending[j].request, &pending[i].request);
+		}
+		if(!blocked){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * IS25sched_complete(flash_err result, void *context)
+ *
+ * @Brief
+ * 		Completion of a forwarded request (interrupt context), context is running or preempt. Forwards the result and
+ * 		dispatches the next request.
+ */
+static void IS25sched_complete(flash_err result, void *context){
+	sched_job *job	= context;
+	sched_job done	= *job;
+
+	atomic_fetch_and(&inFlight, (job == &preempt) ? ~FLIGHT_PREEMPT : ~FLIGHT_RUNNING);
+
+	if(done.request.callback != 0){
+		done.request.callback(result, done.request.context);
+	}
+
+	IS25sched_dispatch();
+}
+
+/**
+ * IS25sched_take(int idx)
+ *
+ * @Brief
+ * 		Removes pending[idx], the requests in front of it were overtaken once more.
+ */
+static sched_job IS25sched_take(int idx){
+	sched_job job = pending[idx];
+
+	for(int i = 0; i < idx; i++){
+		pending[i].bypassed++;
+	}
+	if(idx > 0){
+		statReordered++;
+	}
+	for(int i = idx; i < pendingCnt - 1; i++){
+		pending[i] = pending[i + 1];
+	}
+	pendingCnt--;
+
+	return job;
+}
+
+/**
+ * IS25sched_dispatch(void)
+ *
+ * @Brief
+ * 		Moves submitted requests into the pending list and starts the next one if the memory is idle. While a
+ * 		sector / block erase runs, a read which does not touch it suspends the erase and runs in between.
+ * 		Only one context dispatches at a time, a context which finds the dispatcher taken leaves the work to it
+ * 		(dispatchAgain). The dispatcher only repeats for such work, it never waits for a producer which has reserved
+ * 		a slot but not published it yet: that producer dispatches itself once it has published.
+ */
+static void IS25sched_dispatch(void){
+	IS25async_request request;
+	IS25async_request forward;
+	sched_job *job;
+	flash_err err;
+	unsigned flight;
+	int idx;
+
+	atomic_store(&dispatchAgain, 1);
+
+	while(atomic_load(&dispatchAgain)){
+		if(atomic_flag_test_and_set(&dispatching)){
+			//The dispatcher sees dispatchAgain when it leaves
+			return;
+		}
+		atomic_store(&dispatchAgain, 0);
+
+		while(pendingCnt < IS25SCHED_QUEUE_DEPTH && IS25sched_dequeue(&request)){
+			pending[pendingCnt].request		= request;
+			pending[pendingCnt].bypassed	= 0;
+			pendingCnt++;
+		}
+
+		job		= 0;
+		flight	= atomic_load(&inFlight);
+		if(!(flight & FLIGHT_RUNNING) && (idx = IS25sched_pick()) >= 0){
+			running				= IS25sched_take(idx);
+			running.bypassed	= 0;
+			job					= &running;
+			atomic_fetch_or(&inFlight, FLIGHT_RUNNING);
+		}else if(flight == FLIGHT_RUNNING && (idx = IS25sched_pickPreempt()) >= 0){
+			if(IS25async_suspend() == MEMORY_OK){
+				preempt	= IS25sched_take(idx);
+				job		= &preempt;
+				running.bypassed++;
+				statSuspended++;
+				atomic_fetch_or(&inFlight, FLIGHT_PREEMPT);
+			}else{
+				//Erase not suspendable (any more), no further attempts for it
+				running.bypassed = IS25SCHED_MAX_PREEMPT;
+			}
+		}
+
+		if(job != 0){
+			forward				= job->request;
+			forward.callback	= &IS25sched_complete;
+			forward.context		= job;
+			//Look again once the request is forwarded, a read may preempt it
+			atomic_store(&dispatchAgain, 1);
+
+			//May complete from inside the call, that dispatch is turned away and sets dispatchAgain
+			err = IS25async_submit(&forward);
+			if(err != MEMORY_OK){
+				IS25sched_complete(err, job);
+			}
+		}
+
+		atomic_flag_clear(&dispatching);
+	}
+}
+
+/**
+ * IS25sched_init(const IS25sched_osHooks *hooks)
+ *
+ * @Brief
+ * 		Resets the scheduler. Must be called before the first request and while nothing is queued.
+ *
+ * @Parameter
+ * 		const IS25sched_osHooks *	- RTOS hooks for the blocking calls, 0 if only IS25sched_submit is used
+ *
+ * @return
+ * 		flash_err
+ */
+flash_err IS25sched_init(const IS25sched_osHooks *hooks){
+	if(atomic_load(&inFlight) || IS25async_pending() != 0){
+		return MEMORY_BUSY;
+	}
+
+	for(unsigned i = 0; i < IS25SCHED_QUEUE_DEPTH; i++){
+		atomic_store(&submitRing[i].seq, i);
+	}
+	atomic_store(&enqueuePos, 0);
+	atomic_store(&dequeuePos, 0);
+	atomic_store(&statSubmitted, 0);
+	atomic_store(&statRejected, 0);
+	atomic_store(&dispatchAgain, 0);
+	pendingCnt		= 0;
+	statReordered	= 0;
+	statForced		= 0;
+	statSuspended	= 0;
+
+	if(hooks != 0){
+		osHooks = *hooks;
+	}else{
+		osHooks = (IS25sched_osHooks){0};
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25sched_submit(const IS25async_request *request)
+ *
+ * @Brief
+ * 		Lock-free, non-blocking submission from any task or interrupt. The callback of the request is called
+ * 		from interrupt context when it is finished.
+ *
+ * @Parameter
+ * 		const IS25async_request *	- request, the buffer must stay valid until the callback was called
+ *
+ * @return
+ * 		flash_err	- MEMORY_BUSY if the submission queue is full
+ */
+flash_err IS25sched_submit(const IS25async_request *request){
+	unsigned pos = atomic_load_explicit(&enqueuePos, memory_order_relaxed);
+	sched_slot *slot;
+
+	for(;;){
+		slot = &submitRing[pos & SCHED_MASK];
+		int diff = (int)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+
+		if(diff == 0){
+			if(atomic_compare_exchange_weak_explicit(&enqueuePos, &pos, pos + 1,
+					memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		}else if(diff < 0){
+			atomic_fetch_add(&statRejected, 1);
+			return MEMORY_BUSY;
+		}else{
+			pos = atomic_load_explicit(&enqueuePos, memory_order_relaxed);
+		}
+	}
+
+	slot->request = *request;
+	atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+	atomic_fetch_add(&statSubmitted, 1);
+
+	IS25sched_dispatch();
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25sched_wakeup(flash_err result, void *context)
+ *
+ * @Brief
+ * 		Completion callback of the blocking calls.
+ */
+static void IS25sched_wakeup(flash_err result, void *context){
+	sched_waiter *waiter = context;
+
+	waiter->result = result;
+	osHooks.waitRelease(waiter->wait);
+}
+
+/**
+ * IS25sched_transfer(IS25async_request *request)
+ *
+ * @Brief
+ * 		Blocking call for tasks, submits the request and waits until it is finished. Callback and context of the
+ * 		request are ignored. Needs the RTOS hooks, must not be called from interrupt context.
+ *
+ * @Parameter
+ * 		IS25async_request *	- request
+ *
+ * @return
+ * 		flash_err	- result of the request
+ */
+flash_err IS25sched_transfer(IS25async_request *request){
+	IS25async_request req = *request;
+	sched_waiter waiter;
+	flash_err err;
+
+	if(osHooks.waitCreate == 0 || (waiter.wait = osHooks.waitCreate()) == 0){
+		return MEMORY_ERROR;
+	}
+
+	waiter.result	= MEMORY_ERROR;
+	req.callback	= &IS25sched_wakeup;
+	req.context		= &waiter;
+
+	err = IS25sched_submit(&req);
+	if(err == MEMORY_OK){
+		osHooks.waitBlock(waiter.wait);
+		err = waiter.result;
+	}
+
+	osHooks.waitDelete(waiter.wait);
+
+	return err;
+}
+
+/**
+ * IS25sched_read(uint8_t *readBuffer, mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Blocking read, served before queued programs and erases.
+ */
+flash_err IS25sched_read(uint8_t *readBuffer, mem_address address, uint32_t size){
+	IS25async_request req = {.op = IS25_REQ_READ, .address = address, .buffer = readBuffer, .size = size};
+
+	return IS25sched_transfer(&req);
+}
+
+/**
+ * IS25sched_program(uint8_t *writeBuffer, mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Blocking program, may cross page boundaries.
+ */
+flash_err IS25sched_program(uint8_t *writeBuffer, mem_address address, uint32_t size){
+	IS25async_request req = {.op = IS25_REQ_PROGRAM, .address = address, .buffer = writeBuffer, .size = size};
+
+	return IS25sched_transfer(&req);
+}
+
+/**
+ * IS25sched_erase(IS25async_op op, mem_address address)
+ *
+ * @Brief
+ * 		Blocking sector, block or chip erase.
+ */
+flash_err IS25sched_erase(IS25async_op op, mem_address address){
+	IS25async_request req = {.op = op, .address = address};
+
+	if(op != IS25_REQ_SECTOR_ERASE && op != IS25_REQ_BLOCK_ERASE && op != IS25_REQ_CHIP_ERASE){
+		return MEMORY_ERROR;
+	}
+
+	return IS25sched_transfer(&req);
+}
+
+/**
+ * IS25sched_getStats(IS25sched_stats *stats)
+ */
+void IS25sched_getStats(IS25sched_stats *stats){
+	stats->submitted	= atomic_load(&statSubmitted);
+	stats->rejected		= atomic_load(&statRejected);
+	stats->reordered	= statReordered;
+	stats->forced		= statForced;
+	stats->suspended	= statSuspended;
+}
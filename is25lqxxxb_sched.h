@@ -0,0 +1,60 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB thread-safe front end with read priority
+ *
+ *      Tasks and interrupts enqueue requests into a lock-free submission queue. A dispatcher feeds the
+ *      non-blocking request queue one request at a time and prefers reads over programs over erases,
+ *      without reordering requests which touch the same address range. A read which arrives while a sector /
+ *      block erase runs suspends the erase (PERSUS / PERRSM), unless it reads the erased range.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_SCHED_H_
+#define INC_IS25LQXXXB_SCHED_H_
+
+#include "is25lqxxxb_async.h"
+
+#ifndef IS25SCHED_QUEUE_DEPTH
+#define IS25SCHED_QUEUE_DEPTH		16			// Submission queue and pending list size, must be a power of two
+#endif
+
+#ifndef IS25SCHED_MAX_BYPASS
+#define IS25SCHED_MAX_BYPASS		8			// Times the oldest request may be overtaken before it is forced
+#endif
+
+#ifndef IS25SCHED_MAX_PREEMPT
+#define IS25SCHED_MAX_PREEMPT		16			// Reads served while one erase is suspended, bounds the erase delay
+#endif
+
+/**
+ * RTOS hooks for the blocking calls. A wait object is a binary semaphore, e.g. xSemaphoreCreateBinary
+ * on FreeRTOS or a mutex/condition pair with pthreads.
+ */
+typedef struct{
+	void	*(*waitCreate)(void);
+	void	(*waitDelete)(void *wait);
+	void	(*waitBlock)(void *wait);			// Blocks the calling task until waitRelease
+	void	(*waitRelease)(void *wait);			// Called from interrupt context
+}IS25sched_osHooks;
+
+typedef struct{
+	uint32_t	submitted;
+	uint32_t	rejected;				// Submission queue full
+	uint32_t	reordered;				// Requests dispatched ahead of an older request
+	uint32_t	forced;					// Old requests dispatched because of IS25SCHED_MAX_BYPASS
+	uint32_t	suspended;				// Reads served while a running erase was suspended
+}IS25sched_stats;
+
+
+//External function declaration
+
+extern flash_err IS25sched_init(const IS25sched_osHooks *hooks);
+extern flash_err IS25sched_submit(const IS25async_request *request);
+extern flash_err IS25sched_transfer(IS25async_request *request);
+extern flash_err IS25sched_read(uint8_t *readBuffer, mem_address address, uint32_t size);
+extern flash_err IS25sched_program(uint8_t *writeBuffer, mem_address address, uint32_t size);
+extern flash_err IS25sched_erase(IS25async_op op, mem_address address);
+extern void IS25sched_getStats(IS25sched_stats *stats);
+
+#endif /* INC_IS25LQXXXB_SCHED_H_ */
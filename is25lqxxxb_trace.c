@@ -0,0 +1,208 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB QSPI command trace
+ *
+ */
+
+//Includes
+#include <stdatomic.h>
+#include "is25lqxxxb_trace.h"
+
+#define TRACE_MASK				(IS25TRACE_DEPTH - 1)
+
+#if (IS25TRACE_DEPTH & TRACE_MASK) != 0
+#error "IS25TRACE_DEPTH must be a power of two"
+#endif
+
+typedef char trace_record_size_check[(sizeof(IS25trace_record) == 20) ? 1 : -1];
+
+//Private variables
+static IS25trace_record		ring[IS25TRACE_DEPTH];
+static atomic_uint			head;
+static volatile uint8_t		enabled			= 1;
+
+static uint32_t				lastAddress		= 0;			// Command context of the following data phase
+static uint32_t				lastLength		= 0;
+static uint8_t				lastOpcode		= 0;
+static uint8_t				lastDataLines	= 0;
+
+
+static uint8_t IS25trace_addressLines(uint32_t mode){
+	switch(mode){
+		case QSPI_ADDRESS_1_LINE:	return 1;
+		case QSPI_ADDRESS_2_LINES:	return 2;
+		case QSPI_ADDRESS_4_LINES:	return 3;
+		default:					return 0;
+	}
+}
+
+static uint8_t IS25trace_dataLines(uint32_t mode){
+	switch(mode){
+		case QSPI_DATA_1_LINE:		return 1;
+		case QSPI_DATA_2_LINES:		return 2;
+		case QSPI_DATA_4_LINES:		return 3;
+		default:					return 0;
+	}
+}
+
+/**
+ * IS25trace_put(...)
+ *
+ * @Brief
+ * 		Reserves the next slot and fills it. Lock free, the oldest record is overwritten.
+ */
+static void IS25trace_put(uint32_t start, uint32_t address, uint32_t length, uint8_t opcode, uint8_t info){
+	IS25trace_record *rec;
+
+	if(!enabled){
+		return;
+	}
+
+	rec				= &ring[atomic_fetch_add_explicit(&head, 1, memory_order_relaxed) & TRACE_MASK];
+	rec->timestamp	= start;
+	rec->duration	= IS25TRACE_TIMESTAMP() - start;
+	rec->address	= address;
+	rec->length		= length;
+	rec->opcode		= opcode;
+	rec->info		= info;
+	rec->reserved	= 0;
+}
+
+/**
+ * IS25trace_enable(uint8_t enable)
+ *
+ * @Brief
+ * 		Enabling clears the ring. Disable tracing before IS25trace_export to get consistent records.
+ */
+void IS25trace_enable(uint8_t enable){
+	if(enable){
+		atomic_store(&head, 0);
+	}
+	enabled = enable;
+}
+
+/**
+ * IS25trace_export(IS25trace_header *header, IS25trace_record *records, uint32_t max)
+ *
+ * @Brief
+ * 		Copies the newest records, oldest first, and fills the header of the export format read by
+ * 		tools/is25trace_replay.c (header followed by the records).
+ *
+ * @Parameter
+ * 		IS25trace_header *	- header
+ * 		IS25trace_record *	- destination, may be 0 to only fill the header
+ * 		uint32_t			- destination size in records
+ *
+ * @return
+ * 		uint32_t	- records copied
+ */
+uint32_t IS25trace_export(IS25trace_header *header, IS25trace_record *records, uint32_t max){
+	QSPI_HandleTypeDef *qspi	= IS25mem_getQspiHandle();
+	uint32_t total				= atomic_load(&head);
+	uint32_t count				= total < IS25TRACE_DEPTH ? total : IS25TRACE_DEPTH;
+
+	if(records == 0){
+		max = 0;
+	}
+	if(count > max){
+		count = max;
+	}
+	for(uint32_t i = 0; i < count; i++){
+		records[i] = ring[(total - count + i) & TRACE_MASK];
+	}
+
+	header->magic		= IS25TRACE_MAGIC;
+	header->version		= IS25TRACE_VERSION;
+	header->recordSize	= sizeof(IS25trace_record);
+	header->ticksPerUs	= HAL_RCC_GetHCLKFreq() / 1000000UL;
+	header->sclkHz		= qspi != 0 ? HAL_RCC_GetHCLKFreq() / (qspi->Init.ClockPrescaler + 1) : 0;
+	header->count		= count;
+	header->total		= total;
+
+	return count;
+}
+
+/**
+ * IS25trace_latch(QSPI_CommandTypeDef *cmd, uint32_t start, HAL_StatusTypeDef result)
+ *
+ * @Brief
+ * 		Records a command and keeps its context for the following data phase.
+ */
+static void IS25trace_latch(QSPI_CommandTypeDef *cmd, uint32_t start, HAL_StatusTypeDef result){
+	uint8_t addrLines = IS25trace_addressLines(cmd->AddressMode);
+
+	lastOpcode		= (uint8_t)cmd->Instruction;
+	lastAddress		= addrLines ? cmd->Address : 0;
+	lastLength		= cmd->NbData;
+	lastDataLines	= IS25trace_dataLines(cmd->DataMode);
+
+	IS25trace_put(start, lastAddress, lastLength, lastOpcode,
+			IS25TRACE_INFO(IS25_TRACE_CMD, result, addrLines, lastDataLines));
+}
+
+HAL_StatusTypeDef IS25trace_command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t timeout){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Command(hqspi, cmd, timeout);
+
+	IS25trace_latch(cmd, start, result);
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_commandIT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Command_IT(hqspi, cmd);
+
+	IS25trace_latch(cmd, start, result);
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_transmit(QSPI_HandleTypeDef *hqspi, uint8_t *data, uint32_t timeout){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Transmit(hqspi, data, timeout);
+
+	IS25trace_put(start, lastAddress, lastLength, lastOpcode, IS25TRACE_INFO(IS25_TRACE_TX, result, 0, lastDataLines));
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_transmitIT(QSPI_HandleTypeDef *hqspi, uint8_t *data){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Transmit_IT(hqspi, data);
+
+	IS25trace_put(start, lastAddress, lastLength, lastOpcode, IS25TRACE_INFO(IS25_TRACE_TX, result, 0, lastDataLines));
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_receive(QSPI_HandleTypeDef *hqspi, uint8_t *data, uint32_t timeout){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Receive(hqspi, data, timeout);
+
+	IS25trace_put(start, lastAddress, lastLength, lastOpcode, IS25TRACE_INFO(IS25_TRACE_RX, result, 0, lastDataLines));
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_receiveIT(QSPI_HandleTypeDef *hqspi, uint8_t *data){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_Receive_IT(hqspi, data);
+
+	IS25trace_put(start, lastAddress, lastLength, lastOpcode, IS25TRACE_INFO(IS25_TRACE_RX, result, 0, lastDataLines));
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_autoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+										QSPI_AutoPollingTypeDef *cfg, uint32_t timeout){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_AutoPolling(hqspi, cmd, cfg, timeout);
+
+	IS25trace_put(start, 0, 0, (uint8_t)cmd->Instruction, IS25TRACE_INFO(IS25_TRACE_POLL, result, 0, 1));
+	return result;
+}
+
+HAL_StatusTypeDef IS25trace_autoPollingIT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+										QSPI_AutoPollingTypeDef *cfg){
+	uint32_t start = IS25TRACE_TIMESTAMP();
+	HAL_StatusTypeDef result = HAL_QSPI_AutoPolling_IT(hqspi, cmd, cfg);
+
+	IS25trace_put(start, 0, 0, (uint8_t)cmd->Instruction, IS25TRACE_INFO(IS25_TRACE_POLL, result, 0, 1));
+	return result;
+}
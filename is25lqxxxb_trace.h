@@ -0,0 +1,114 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB QSPI command trace
+ *
+ *      With IS25_TRACE defined, every HAL_QSPI_Command / Transmit / Receive / AutoPolling call of is25lqxxxb.c and
+ *      of the request queue (is25lqxxxb_async.c, so also the scheduler and the read-ahead), blocking and interrupt
+ *      driven, goes through the wrappers below, which store a 20 byte record in a RAM ring. The ring is a flight recorder:
+ *      the newest IS25TRACE_DEPTH records are kept. Producers reserve slots with an atomic counter, so calls from
+ *      tasks and interrupts can be traced without locks. Export the ring with IS25trace_export and analyse it on the
+ *      host with tools/is25trace_replay.c.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_TRACE_H_
+#define INC_IS25LQXXXB_TRACE_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25TRACE_DEPTH
+#define IS25TRACE_DEPTH				256			// Records, must be a power of two
+#endif
+
+#ifndef IS25TRACE_TIMESTAMP
+#define IS25TRACE_TIMESTAMP()		(DWT->CYCCNT)	// Started by IS25mem_Init (IS25_BUSY_CYCLES_ENABLE)
+#endif
+
+#define IS25TRACE_MAGIC				0x43525449	// "ITRC"
+#define IS25TRACE_VERSION			2			// 2: 32 bit length, 20 byte records
+
+/**
+ * Record kind, info bits 0-1
+ */
+typedef enum{
+	IS25_TRACE_CMD				= 0x00,		// HAL_QSPI_Command(_IT), length = NbData of the command
+	IS25_TRACE_TX				= 0x01,		// HAL_QSPI_Transmit(_IT) of the last command
+	IS25_TRACE_RX				= 0x02,		// HAL_QSPI_Receive(_IT) of the last command
+	IS25_TRACE_POLL				= 0x03		// HAL_QSPI_AutoPolling(_IT)
+	//The duration of the interrupt driven calls only covers the start of the transfer
+}IS25trace_kind;
+
+/**
+ * info:	bit 0-1 kind, bit 2-3 HAL result, bit 4-5 address lines, bit 6-7 data lines (0 = none, 1, 2, 3 = 4 lines)
+ */
+#define IS25TRACE_INFO(kind, result, addrLines, dataLines)	\
+	((uint8_t)(((kind) & 3) | (((result) & 3) << 2) | (((addrLines) & 3) << 4) | (((dataLines) & 3) << 6)))
+#define IS25TRACE_KIND(info)			((info) & 3)
+#define IS25TRACE_RESULT(info)			(((info) >> 2) & 3)
+#define IS25TRACE_ADDR_LINES(info)		(((info) >> 4) & 3)
+#define IS25TRACE_DATA_LINES(info)		(((info) >> 6) & 3)
+
+typedef struct{
+	uint32_t	timestamp;			// IS25TRACE_TIMESTAMP at the call
+	uint32_t	duration;			// Timestamp ticks spent in the call
+	uint32_t	address;
+	uint32_t	length;				// Data bytes
+	uint8_t		opcode;				// Instruction of the command (TX / RX: of the last command)
+	uint8_t		info;
+	uint16_t	reserved;
+}IS25trace_record;
+
+/**
+ * Export header, followed by count records, oldest first.
+ */
+typedef struct{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	recordSize;
+	uint32_t	ticksPerUs;			// Timestamp ticks per microsecond (HCLK for the DWT cycle counter)
+	uint32_t	sclkHz;				// QSPI clock at export
+	uint32_t	count;				// Records following
+	uint32_t	total;				// Records written since IS25trace_enable, total - count were overwritten
+}IS25trace_header;
+
+
+//External function declaration
+
+extern void IS25trace_enable(uint8_t enable);
+extern uint32_t IS25trace_export(IS25trace_header *header, IS25trace_record *records, uint32_t max);
+
+//Wrappers used by is25lqxxxb.c and is25lqxxxb_async.c when IS25_TRACE is defined
+extern HAL_StatusTypeDef IS25trace_command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t timeout);
+extern HAL_StatusTypeDef IS25trace_commandIT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd);
+extern HAL_StatusTypeDef IS25trace_transmit(QSPI_HandleTypeDef *hqspi, uint8_t *data, uint32_t timeout);
+extern HAL_StatusTypeDef IS25trace_transmitIT(QSPI_HandleTypeDef *hqspi, uint8_t *data);
+extern HAL_StatusTypeDef IS25trace_receive(QSPI_HandleTypeDef *hqspi, uint8_t *data, uint32_t timeout);
+extern HAL_StatusTypeDef IS25trace_receiveIT(QSPI_HandleTypeDef *hqspi, uint8_t *data);
+extern HAL_StatusTypeDef IS25trace_autoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+												QSPI_AutoPollingTypeDef *cfg, uint32_t timeout);
+extern HAL_StatusTypeDef IS25trace_autoPollingIT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd,
+												QSPI_AutoPollingTypeDef *cfg);
+
+//QSPI calls of the driver and the request queue, routed through the trace recorder with IS25_TRACE
+#ifdef IS25_TRACE
+#define QSPI_COMMAND				IS25trace_command
+#define QSPI_COMMAND_IT				IS25trace_commandIT
+#define QSPI_TRANSMIT				IS25trace_transmit
+#define QSPI_TRANSMIT_IT			IS25trace_transmitIT
+#define QSPI_RECEIVE				IS25trace_receive
+#define QSPI_RECEIVE_IT				IS25trace_receiveIT
+#define QSPI_AUTOPOLLING			IS25trace_autoPolling
+#define QSPI_AUTOPOLLING_IT			IS25trace_autoPollingIT
+#else
+#define QSPI_COMMAND				HAL_QSPI_Command
+#define QSPI_COMMAND_IT				HAL_QSPI_Command_IT
+#define QSPI_TRANSMIT				HAL_QSPI_Transmit
+#define QSPI_TRANSMIT_IT			HAL_QSPI_Transmit_IT
+#define QSPI_RECEIVE				HAL_QSPI_Receive
+#define QSPI_RECEIVE_IT				HAL_QSPI_Receive_IT
+#define QSPI_AUTOPOLLING			HAL_QSPI_AutoPolling
+#define QSPI_AUTOPOLLING_IT			HAL_QSPI_AutoPolling_IT
+#endif
+
+#endif /* INC_IS25LQXXXB_TRACE_H_ */
@@ -0,0 +1,456 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB atomic multi-sector transactions
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_txn.h"
+
+#define SECTOR_SIZE				4096UL
+#define PAGE_SIZE				256UL
+#define PAGES_PER_SECTOR		(SECTOR_SIZE / PAGE_SIZE)
+
+#define TXN_MAGIC				0x54584E43			// "TXNC"
+#define TXN_NOT_APPLIED			0xFFFFFFFF
+#define TXN_WORDS				((PAGE_SIZE - 20) / 4)
+
+#if IS25TXN_JOURNAL_SECTORS > 16
+#error "IS25TXN_JOURNAL_SECTORS too large, journal page index is 8 bit"
+#endif
+
+/**
+ * Commit record, journal page 0. The words hold entryCount page entries (target page << 8 | journal page)
+ * followed by eraseCount sector numbers. Once the commit record is programmed the transaction is durable.
+ */
+typedef struct{
+	uint32_t	magic;
+	uint32_t	sequence;
+	uint16_t	entryCount;
+	uint16_t	eraseCount;
+	uint32_t	words[TXN_WORDS];
+	uint32_t	crc;				// CRC-32 of all fields above
+	uint32_t	applied;			// Programmed to 0 when the targets are written
+}txn_record;
+
+typedef struct{
+	uint32_t	page;				// Target page number (address / 256)
+	uint8_t		journalPage;
+}txn_entry;
+
+//Private variables
+static mem_address		journalBase		= {0};
+static uint8_t			recovered		= 0;
+static uint8_t			active			= 0;
+static uint32_t			sequence		= 0;
+
+static txn_entry		entries[IS25TXN_JOURNAL_PAGES];
+static uint8_t			entryCount		= 0;
+static uint32_t			eraseList[IS25TXN_JOURNAL_PAGES];
+static uint8_t			eraseCount		= 0;
+static uint32_t			touched[IS25TXN_JOURNAL_PAGES];		// Sectors touched, for the copy-twice comparison
+static uint8_t			touchedCount	= 0;
+static uint8_t			nextJournalPage	= 1;
+static uint16_t			journalReady	= 0;				// Bit n: journal sector n is erased for this transaction
+
+static txn_record		record;
+static uint8_t			pageBuf[PAGE_SIZE];
+static uint8_t			origBuf[PAGE_SIZE];
+static IS25txn_stats	stats			= {0};
+
+
+static mem_address IS25txn_journalPageAddress(uint8_t journalPage){
+	mem_address address;
+
+	address.val = journalBase.val + journalPage * PAGE_SIZE;
+	return address;
+}
+
+static mem_address IS25txn_pageAddress(uint32_t page){
+	mem_address address;
+
+	address.val = page * PAGE_SIZE;
+	return address;
+}
+
+/**
+ * IS25txn_program(const uint8_t *data, mem_address address, uint32_t size)
+ *
+ * @Brief
+ * 		Program with accounting of the written bytes.
+ */
+static flash_err IS25txn_program(const uint8_t *data, mem_address address, uint32_t size){
+	stats.bytesProgrammed += size;
+	return IS25mem_programData((uint8_t *)data, address, size);
+}
+
+static flash_err IS25txn_erase(mem_address address){
+	stats.sectorsErased++;
+	return IS25mem_sectorEraseWait(address);
+}
+
+/**
+ * IS25txn_isBlank(const uint8_t *data, uint32_t size)
+ */
+static uint8_t IS25txn_isBlank(const uint8_t *data, uint32_t size){
+	while(size--){
+		if(*data++ != 0xFF){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * IS25txn_prepareJournalSector(uint8_t sector)
+ *
+ * @Brief
+ * 		Makes a journal sector usable for this transaction, it is only erased if it is not blank.
+ */
+static flash_err IS25txn_prepareJournalSector(uint8_t sector){
+	uint8_t scan[32];			// pageBuf may hold the page being staged
+	mem_address address;
+
+	if(journalReady & (1u << sector)){
+		return MEMORY_OK;
+	}
+
+	address.val = journalBase.val + sector * SECTOR_SIZE;
+	for(uint32_t offset = 0; offset < SECTOR_SIZE; offset += sizeof(scan)){
+		mem_address chunk = address;
+		chunk.val += offset;
+		if(IS25mem_readDataFast(scan, chunk, sizeof(scan)) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		if(!IS25txn_isBlank(scan, sizeof(scan))){
+			if(IS25txn_erase(address) != MEMORY_OK){
+				return MEMORY_ERROR;
+			}
+			break;
+		}
+	}
+
+	journalReady |= (1u << sector);
+	return MEMORY_OK;
+}
+
+/**
+ * IS25txn_stage(uint32_t page, const uint8_t *data)
+ *
+ * @Brief
+ * 		Programs a page image into the next journal page and points the entry of the target page to it.
+ */
+static flash_err IS25txn_stage(uint32_t page, const uint8_t *data){
+	uint8_t jp = nextJournalPage;
+	uint8_t i;
+
+	if(jp > IS25TXN_JOURNAL_PAGES){
+		return MEMORY_ERROR;
+	}
+	if(IS25txn_prepareJournalSector(jp / PAGES_PER_SECTOR) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(IS25txn_program(data, IS25txn_journalPageAddress(jp), PAGE_SIZE) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	nextJournalPage++;
+
+	for(i = 0; i < entryCount && entries[i].page != page; i++);
+	if(i == entryCount){
+		entries[entryCount].page = page;
+		entryCount++;
+	}
+	entries[i].journalPage = jp;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25txn_addSector(uint32_t *list, uint8_t *count, uint32_t sector)
+ */
+static void IS25txn_addSector(uint32_t *list, uint8_t *count, uint32_t sector){
+	for(uint8_t i = 0; i < *count; i++){
+		if(list[i] == sector){
+			return;
+		}
+	}
+	if(*count < IS25TXN_JOURNAL_PAGES){
+		list[(*count)++] = sector;
+	}
+}
+
+/**
+ * IS25txn_apply(const txn_record *rec)
+ *
+ * @Brief
+ * 		Writes a committed transaction to its targets and marks it applied. Idempotent, a second run after a power
+ * 		loss erases the same sectors and programs the same page images again.
+ */
+static flash_err IS25txn_apply(const txn_record *rec){
+	mem_address address;
+	uint32_t applied = 0;
+
+	for(uint16_t i = 0; i < rec->eraseCount; i++){
+		address.val = rec->words[rec->entryCount + i] * SECTOR_SIZE;
+		if(IS25txn_erase(address) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+
+	for(uint16_t i = 0; i < rec->entryCount; i++){
+		if(IS25mem_readDataFast(pageBuf, IS25txn_journalPageAddress(rec->words[i] & 0xFF), PAGE_SIZE) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		if(IS25txn_program(pageBuf, IS25txn_pageAddress(rec->words[i] >> 8), PAGE_SIZE) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+
+	address = journalBase;
+	address.val += offsetof(txn_record, applied);
+	return IS25txn_program((const uint8_t *)&applied, address, sizeof(applied));
+}
+
+/**
+ * IS25txn_init(mem_address journal)
+ *
+ * @Brief
+ * 		Sets the journal area, IS25TXN_JOURNAL_SECTORS sectors starting at the given sector. The journal must not be
+ * 		used for anything else.
+ */
+flash_err IS25txn_init(mem_address journal){
+	if(active){
+		return MEMORY_BUSY;
+	}
+
+	journal.sectorBytes	= 0;
+	journalBase			= journal;
+	recovered			= 0;
+	stats				= (IS25txn_stats){0};
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25txn_recover(void)
+ *
+ * @Brief
+ * 		Completes a transaction which was committed but not applied before a reset. Must be called once after
+ * 		IS25txn_init before the first IS25txn_begin, and again after IS25txn_commit failed to write the targets.
+ */
+flash_err IS25txn_recover(void){
+	if(IS25mem_readDataFast((uint8_t *)&record, journalBase, sizeof(record)) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	if(record.magic == TXN_MAGIC &&
+			record.entryCount + record.eraseCount <= TXN_WORDS &&
+			record.crc == IS25mem_crc32(0, (const uint8_t *)&record, offsetof(txn_record, crc))){
+		sequence = record.sequence;
+		if(record.applied == TXN_NOT_APPLIED && IS25txn_apply(&record) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+
+	recovered = 1;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25txn_begin(void)
+ *
+ * @Brief
+ * 		Starts a transaction. Nothing is written to the targets before IS25txn_commit.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if IS25txn_recover has not run since IS25txn_init or a failed commit
+ */
+flash_err IS25txn_begin(void){
+	if(!recovered){
+		return MEMORY_ERROR;
+	}
+	if(active){
+		return MEMORY_BUSY;
+	}
+
+	entryCount		= 0;
+	eraseCount		= 0;
+	touchedCount	= 0;
+	nextJournalPage	= 1;
+	journalReady	= 0;
+	active			= 1;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25txn_write(mem_address address, const uint8_t *data, uint32_t size)
+ *
+ * @Brief
+ * 		Stages a write. Unchanged bytes are not staged, a page written twice uses the newest image.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the journal is full, the transaction is aborted then
+ */
+flash_err IS25txn_write(mem_address address, const uint8_t *data, uint32_t size){
+	uint32_t page, offset, chunk, changed;
+	uint8_t i;
+
+	if(!active){
+		return MEMORY_ERROR;
+	}
+	stats.bytesRequested += size;
+
+	while(size > 0){
+		page	= address.val / PAGE_SIZE;
+		offset	= address.val % PAGE_SIZE;
+		chunk	= PAGE_SIZE - offset;
+		if(chunk > size){
+			chunk = size;
+		}
+
+		//Current image: staged one if the page was written before, the memory content otherwise
+		if(IS25mem_readDataFast(origBuf, IS25txn_pageAddress(page), PAGE_SIZE) != MEMORY_OK){
+			goto fail;
+		}
+		for(i = 0; i < entryCount && entries[i].page != page; i++);
+		if(i < entryCount){
+			if(IS25mem_readDataFast(pageBuf, IS25txn_journalPageAddress(entries[i].journalPage), PAGE_SIZE) != MEMORY_OK){
+				goto fail;
+			}
+		}else{
+			memcpy(pageBuf, origBuf, PAGE_SIZE);
+		}
+
+		changed = 0;
+		for(uint32_t n = 0; n < chunk; n++){
+			changed += (pageBuf[offset + n] != data[n]);
+		}
+
+		if(changed != 0){
+			memcpy(&pageBuf[offset], data, chunk);
+			stats.bytesChanged += changed;
+
+			if(IS25txn_stage(page, pageBuf) != MEMORY_OK){
+				goto fail;
+			}
+			IS25txn_addSector(touched, &touchedCount, page / PAGES_PER_SECTOR);
+
+			//A bit going from 0 to 1 needs an erase of the whole sector
+			for(uint32_t n = 0; n < PAGE_SIZE; n++){
+				if(pageBuf[n] & ~origBuf[n]){
+					IS25txn_addSector(eraseList, &eraseCount, page / PAGES_PER_SECTOR);
+					break;
+				}
+			}
+		}
+
+		address.val	+= chunk;
+		data		+= chunk;
+		size		-= chunk;
+	}
+
+	return MEMORY_OK;
+
+fail:
+	active = 0;
+	return MEMORY_ERROR;
+}
+
+/**
+ * IS25txn_commit(void)
+ *
+ * @Brief
+ * 		Backs up the non-blank pages of the sectors which need an erase, programs the commit record (the atomic
+ * 		step) and writes the targets. If writing the targets fails after the commit record is programmed, the
+ * 		transaction stays durable in the journal: IS25txn_begin is refused until IS25txn_recover applied it, so the
+ * 		journal can not be erased under the committed record.
+ *
+ * @return
+ * 		flash_err	- MEMORY_ERROR if the journal or the commit record is too small, nothing was written then, or if
+ * 					  the targets could not be written, call IS25txn_recover then
+ */
+flash_err IS25txn_commit(void){
+	uint8_t i;
+
+	if(!active){
+		return MEMORY_ERROR;
+	}
+
+	//Pages of an erased sector which are not part of the transaction have to be restored from the journal
+	for(uint8_t s = 0; s < eraseCount; s++){
+		for(uint32_t page = eraseList[s] * PAGES_PER_SECTOR; page < (eraseList[s] + 1) * PAGES_PER_SECTOR; page++){
+			for(i = 0; i < entryCount && entries[i].page != page; i++);
+			if(i < entryCount){
+				continue;
+			}
+			if(IS25mem_readDataFast(pageBuf, IS25txn_pageAddress(page), PAGE_SIZE) != MEMORY_OK){
+				goto fail;
+			}
+			if(!IS25txn_isBlank(pageBuf, PAGE_SIZE) && IS25txn_stage(page, pageBuf) != MEMORY_OK){
+				goto fail;
+			}
+		}
+	}
+
+	if(entryCount == 0){
+		active = 0;
+		return MEMORY_OK;
+	}
+	if(entryCount + eraseCount > TXN_WORDS || IS25txn_prepareJournalSector(0) != MEMORY_OK){
+		goto fail;
+	}
+
+	memset(&record, 0xFF, sizeof(record));
+	record.magic		= TXN_MAGIC;
+	record.sequence		= ++sequence;
+	record.entryCount	= entryCount;
+	record.eraseCount	= eraseCount;
+	for(i = 0; i < entryCount; i++){
+		record.words[i] = (entries[i].page << 8) | entries[i].journalPage;
+	}
+	for(i = 0; i < eraseCount; i++){
+		record.words[entryCount + i] = eraseList[i];
+	}
+	record.crc = IS25mem_crc32(0, (const uint8_t *)&record, offsetof(txn_record, crc));
+
+	if(IS25txn_program((const uint8_t *)&record, journalBase, sizeof(record)) != MEMORY_OK){
+		goto fail;
+	}
+	active = 0;
+
+	stats.commits++;
+	stats.copyTwiceBytes += touchedCount * SECTOR_SIZE * 2;
+
+	if(IS25txn_apply(&record) != MEMORY_OK){
+		recovered = 0;
+		return MEMORY_ERROR;
+	}
+	return MEMORY_OK;
+
+fail:
+	active = 0;
+	return MEMORY_ERROR;
+}
+
+/**
+ * IS25txn_abort(void)
+ *
+ * @Brief
+ * 		Drops a running transaction, the targets are untouched.
+ */
+void IS25txn_abort(void){
+	active = 0;
+}
+
+/**
+ * IS25txn_getStats(IS25txn_stats *stats)
+ *
+ * @Brief
+ * 		Write amplification counters: bytesProgrammed / bytesChanged against copyTwiceBytes / bytesChanged.
+ */
+void IS25txn_getStats(IS25txn_stats *out){
+	*out = stats;
+}
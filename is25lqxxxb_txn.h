@@ -0,0 +1,44 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB atomic multi-sector transactions
+ *
+ *      Changed pages are staged in a small journal area, the commit is a single page write of the commit
+ *      record. Pages which only clear bits are programmed in place, only sectors which really need an erase
+ *      get their remaining non-blank pages backed up. IS25txn_recover replays a committed but not yet
+ *      applied transaction after a power loss, call it once after IS25mem_Init.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_TXN_H_
+#define INC_IS25LQXXXB_TXN_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25TXN_JOURNAL_SECTORS
+#define IS25TXN_JOURNAL_SECTORS		2			// Sector 0 page 0 holds the commit record, the rest stages pages
+#endif
+
+#define IS25TXN_JOURNAL_PAGES		(IS25TXN_JOURNAL_SECTORS * 16 - 1)	// Staged pages per transaction (changed + backup)
+
+typedef struct{
+	uint32_t	commits;
+	uint32_t	bytesRequested;			// Payload bytes given to IS25txn_write
+	uint32_t	bytesChanged;			// Payload bytes which differed from the memory content
+	uint32_t	bytesProgrammed;		// Journal, commit record and target programs
+	uint32_t	sectorsErased;			// Journal and target erases
+	uint32_t	copyTwiceBytes;			// What copying every touched sector twice would have programmed
+}IS25txn_stats;
+
+
+//External function declaration
+
+extern flash_err IS25txn_init(mem_address journal);
+extern flash_err IS25txn_recover(void);
+extern flash_err IS25txn_begin(void);
+extern flash_err IS25txn_write(mem_address address, const uint8_t *data, uint32_t size);
+extern flash_err IS25txn_commit(void);
+extern void IS25txn_abort(void);
+extern void IS25txn_getStats(IS25txn_stats *stats);
+
+#endif /* INC_IS25LQXXXB_TXN_H_ */
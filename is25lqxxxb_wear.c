@@ -0,0 +1,639 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB erase counters and health telemetry
+ *
+ */
+
+//Includes
+#include <string.h>
+#include "is25lqxxxb_wear.h"
+
+#define WEAR_MAGIC				0x41455749UL		// "IWEA"
+#define WEAR_VERSION			1
+#define WEAR_RECORD_MAGIC		0xD17A
+#define WEAR_RECORD_ENTRIES		64					// Zones per delta record
+#define WEAR_SECTOR_SIZE		4096UL
+#define WEAR_SNAPSHOT_SIZE		(sizeof(wear_snapshot) + IS25WEAR_ZONES * 4 + 4)
+#define WEAR_LOG_START			((WEAR_SNAPSHOT_SIZE + 255) & ~255UL)		// Delta records start on a page
+#define WEAR_RECORD_MAX			(sizeof(wear_record) + WEAR_RECORD_ENTRIES * 4 + 4)
+
+#if (IS25WEAR_ZONES * 4 + 36) > 2048
+#error "IS25WEAR_ZONES too large, the snapshot has to leave half of the sector for delta records"
+#endif
+
+/**
+ * Start of a reserved sector, followed by the counters and the CRC. Programmed last, it marks a complete snapshot.
+ */
+typedef struct{
+	uint32_t	magic;
+	uint32_t	generation;				// The valid snapshot with the highest generation is used
+	uint16_t	zones;
+	uint8_t		zoneShift;				// Sectors per zone = 1 << zoneShift
+	uint8_t		version;
+	uint32_t	poweredSec;
+	uint32_t	eraseBaselineUs;
+	uint32_t	programBaselineUs;
+	uint32_t	eraseAvgUs;
+	uint32_t	programAvgUs;
+}wear_snapshot;
+
+/**
+ * Delta record, followed by entries {uint16_t zone, uint16_t erases} and the CRC of header and entries.
+ */
+typedef struct{
+	uint16_t	magic;					// WEAR_RECORD_MAGIC
+	uint8_t		entries;
+	uint8_t		reserved;
+	uint32_t	seconds;				// Powered time since the previous record
+	uint32_t	eraseBaselineUs;		// Health values at the time of the record, the last one wins
+	uint32_t	programBaselineUs;
+	uint32_t	eraseAvgUs;
+	uint32_t	programAvgUs;
+}wear_record;
+
+typedef struct{
+	uint32_t	avgUs;
+	uint32_t	maxUs;
+	uint32_t	baselineUs;
+	uint32_t	sum;					// Baseline collection
+	uint32_t	samples;
+}wear_timing;
+
+//Private variables
+static uint32_t				counts[IS25WEAR_ZONES];			// Persisted + pending
+static uint32_t				pending[IS25WEAR_ZONES];		// Not yet in a delta record
+static uint32_t				sessionBase[IS25WEAR_ZONES];	// counts at IS25wear_init
+static volatile uint32_t	pendingErases	= 0;
+static uint32_t				recordWords[(WEAR_RECORD_MAX + 3) / 4];	// Record / chunk buffer, word aligned for the structs
+static uint8_t *const		recordBuf		= (uint8_t *)recordWords;
+
+static uint32_t				zoneCount		= 0;			// Zones used by the detected memory
+static uint8_t				zoneShift		= 0;
+static uint32_t				wearSector		= 0;			// First reserved sector
+static uint8_t				activeSector	= 0;			// 0 / 1, holds the newest snapshot
+static uint32_t				generation		= 0;
+static uint32_t				writeOffset		= 0;			// Next delta record in the active sector
+static volatile uint8_t		logFull			= 0;			// Compact on the next flush, also set by the report
+
+static uint32_t				poweredSec		= 0;
+static uint32_t				lastTick		= 0;			// Powered time counted up to here
+static uint32_t				sessionTick		= 0;
+static uint32_t				recordsWritten	= 0;
+static uint32_t				snapshotsWritten = 0;
+
+static wear_timing			eraseTiming		= {0};
+static wear_timing			programTiming	= {0};
+
+
+static mem_address IS25wear_address(uint8_t sector, uint32_t offset){
+	mem_address address;
+
+	address.val = (wearSector + sector) * WEAR_SECTOR_SIZE + offset;
+	return address;
+}
+
+/**
+ * IS25wear_sample(wear_timing *timing, uint32_t busyUs)
+ *
+ * @Brief
+ * 		Moving average (1/8 weight), maximum and baseline of a busy time.
+ */
+static void IS25wear_sample(wear_timing *timing, uint32_t busyUs){
+	if(timing->avgUs == 0){
+		timing->avgUs = busyUs;
+	}else{
+		timing->avgUs = (uint32_t)((int32_t)timing->avgUs + ((int32_t)busyUs - (int32_t)timing->avgUs) / 8);
+	}
+	if(busyUs > timing->maxUs){
+		timing->maxUs = busyUs;
+	}
+	if(timing->baselineUs == 0){
+		timing->sum += busyUs;
+		if(++timing->samples >= IS25WEAR_BASELINE_SAMPLES){
+			timing->baselineUs = timing->sum / timing->samples;
+		}
+	}
+}
+
+/**
+ * IS25wear_report(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs)
+ *
+ * @Brief
+ * 		Wear callback registered by IS25wear_init. Only updates RAM, may be called from the status match interrupt.
+ * 		An erase covering the active table sector (chip erase, block erase over the reserved sectors) wiped the
+ * 		snapshot the log belongs to: the next IS25wear_process writes a new snapshot to the other sector. Up to then
+ * 		the table is only in RAM, after a power loss IS25wear_init finds the older snapshot or none.
+ */
+void IS25wear_report(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs){
+	uint32_t first;
+	uint32_t last;
+
+	switch(op){
+		case IS25_WEAR_SECTOR_ERASE:
+			first	= address.sector;
+			last	= first;
+			IS25wear_sample(&eraseTiming, busyUs);
+			break;
+		case IS25_WEAR_BLOCK_ERASE:
+			first	= address.sector & ~15UL;
+			last	= first + 15;
+			break;
+		case IS25_WEAR_CHIP_ERASE:
+			first	= 0;
+			last	= (zoneCount << zoneShift) - 1;
+			break;
+		default:
+			//tPP is specified for a full page, shorter programs would only add noise
+			if(size == 256){
+				IS25wear_sample(&programTiming, busyUs);
+			}
+			return;
+	}
+
+	for(uint32_t zone = first >> zoneShift; zone <= (last >> zoneShift) && zone < zoneCount; zone++){
+		counts[zone]++;
+		pending[zone]++;
+	}
+	pendingErases++;
+
+	if(zoneCount != 0 && first <= wearSector + activeSector && last >= wearSector + activeSector){
+		logFull = 1;
+		if(pendingErases < IS25WEAR_BATCH){
+			pendingErases = IS25WEAR_BATCH;
+		}
+	}
+}
+
+/**
+ * IS25wear_elapsed(void)
+ *
+ * @Brief
+ * 		Whole seconds since the last call, the remainder is kept for the next one.
+ */
+static uint32_t IS25wear_elapsed(void){
+	uint32_t seconds = (HAL_GetTick() - lastTick) / 1000;
+
+	lastTick += seconds * 1000;
+	return seconds;
+}
+
+/**
+ * IS25wear_writeSnapshot(void)
+ *
+ * @Brief
+ * 		Writes all counters to the other reserved sector and makes it the active one. Counters are taken zone by zone
+ * 		together with their pending erases, erases reported meanwhile stay pending for the next record.
+ */
+static flash_err IS25wear_writeSnapshot(void){
+	uint8_t target		= activeSector ^ 1;
+	wear_snapshot snap	= {0};
+	uint32_t *chunk		= recordWords;
+	uint32_t offset		= sizeof(snap);
+	uint32_t crc;
+	uint32_t n;
+
+	snap.magic				= WEAR_MAGIC;
+	snap.generation			= generation + 1;
+	snap.zones				= IS25WEAR_ZONES;
+	snap.zoneShift			= zoneShift;
+	snap.version			= WEAR_VERSION;
+	snap.poweredSec			= poweredSec + IS25wear_elapsed();
+	snap.eraseBaselineUs	= eraseTiming.baselineUs;
+	snap.programBaselineUs	= programTiming.baselineUs;
+	snap.eraseAvgUs			= eraseTiming.avgUs;
+	snap.programAvgUs		= programTiming.avgUs;
+	crc = IS25mem_crc32(0, (const uint8_t *)&snap, sizeof(snap));
+
+	if(IS25mem_sectorEraseWait(IS25wear_address(target, 0)) != MEMORY_OK){
+		lastTick -= (snap.poweredSec - poweredSec) * 1000;
+		return MEMORY_ERROR;
+	}
+
+	pendingErases = 0;
+	for(uint32_t zone = 0; zone < IS25WEAR_ZONES; zone += n){
+		n = IS25WEAR_ZONES - zone < WEAR_RECORD_ENTRIES ? IS25WEAR_ZONES - zone : WEAR_RECORD_ENTRIES;
+
+		IS25WEAR_ENTER_CRITICAL();
+		for(uint32_t i = 0; i < n; i++){
+			chunk[i]			= counts[zone + i];
+			pending[zone + i]	= 0;
+		}
+		IS25WEAR_EXIT_CRITICAL();
+
+		crc = IS25mem_crc32(crc, recordBuf, n * 4);
+		if(IS25mem_programData(recordBuf, IS25wear_address(target, offset), n * 4) != MEMORY_OK){
+			//The old snapshot stays valid, the next flush writes a complete snapshot from counts again
+			lastTick -= (snap.poweredSec - poweredSec) * 1000;
+			logFull = 1;
+			return MEMORY_ERROR;
+		}
+		offset += n * 4;
+	}
+
+	if(IS25mem_programData((uint8_t *)&crc, IS25wear_address(target, offset), 4) != MEMORY_OK ||
+	   IS25mem_programData((uint8_t *)&snap, IS25wear_address(target, 0), sizeof(snap)) != MEMORY_OK){
+		lastTick -= (snap.poweredSec - poweredSec) * 1000;
+		logFull = 1;
+		return MEMORY_ERROR;
+	}
+
+	poweredSec		= snap.poweredSec;
+	generation		= snap.generation;
+	activeSector	= target;
+	writeOffset		= WEAR_LOG_START;
+	logFull			= 0;
+	snapshotsWritten++;
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25wear_writeRecord(void)
+ *
+ * @Brief
+ * 		Appends one delta record with up to WEAR_RECORD_ENTRIES zones erased since the previous record.
+ *
+ * @return
+ * 		flash_err	- MEMORY_BUSY if more pending zones are left
+ */
+static flash_err IS25wear_writeRecord(void){
+	wear_record *rec	= (wear_record *)recordBuf;
+	uint16_t *entry		= (uint16_t *)(recordBuf + sizeof(wear_record));
+	uint32_t size;
+	uint32_t crc;
+	uint8_t n			= 0;
+	uint8_t more		= 0;
+
+	IS25WEAR_ENTER_CRITICAL();
+	pendingErases = 0;
+	for(uint32_t zone = 0; zone < zoneCount; zone++){
+		if(pending[zone] == 0){
+			continue;
+		}
+		if(n == WEAR_RECORD_ENTRIES){
+			more = 1;
+			break;
+		}
+		entry[2 * n]		= (uint16_t)zone;
+		entry[2 * n + 1]	= pending[zone] > 0xFFFF ? 0xFFFF : (uint16_t)pending[zone];
+		pending[zone]	   -= entry[2 * n + 1];
+		more			   |= pending[zone] != 0;
+		n++;
+	}
+	IS25WEAR_EXIT_CRITICAL();
+
+	rec->magic				= WEAR_RECORD_MAGIC;
+	rec->entries			= n;
+	rec->reserved			= 0xFF;
+	rec->seconds			= IS25wear_elapsed();
+	rec->eraseBaselineUs	= eraseTiming.baselineUs;
+	rec->programBaselineUs	= programTiming.baselineUs;
+	rec->eraseAvgUs			= eraseTiming.avgUs;
+	rec->programAvgUs		= programTiming.avgUs;
+
+	size	= sizeof(wear_record) + n * 4;
+	crc		= IS25mem_crc32(0, recordBuf, size);
+	memcpy(recordBuf + size, &crc, 4);
+
+	if(IS25mem_programData(recordBuf, IS25wear_address(activeSector, writeOffset), size + 4) != MEMORY_OK){
+		//A torn record ends the log, the erases go into the next snapshot
+		lastTick -= rec->seconds * 1000;
+		logFull = 1;
+		return MEMORY_ERROR;
+	}
+
+	poweredSec	+= rec->seconds;
+	writeOffset	+= size + 4;
+	recordsWritten++;
+
+	return more ? MEMORY_BUSY : MEMORY_OK;
+}
+
+/**
+ * IS25wear_flush(void)
+ *
+ * @Brief
+ * 		Persists all pending erases and the health values, also without new erases (e.g. before a shutdown). Writes a
+ * 		new snapshot instead of a record when the active sector is full. Blocking, call from task context while no
+ * 		other flash operation is running.
+ *
+ * @return
+ * 		flash_err
+ */
+flash_err IS25wear_flush(void){
+	flash_err err;
+
+	if(zoneCount == 0){
+		return MEMORY_ERROR;
+	}
+
+	do{
+		if(logFull || writeOffset + WEAR_RECORD_MAX > WEAR_SECTOR_SIZE){
+			return IS25wear_writeSnapshot();
+		}
+		err = IS25wear_writeRecord();
+	}while(err == MEMORY_BUSY);
+
+	return err;
+}
+
+/**
+ * IS25wear_process(void)
+ *
+ * @Brief
+ * 		Call periodically from task context. Flushes once IS25WEAR_BATCH erases are pending.
+ *
+ * @return
+ * 		flash_err	- MEMORY_OK if nothing had to be written
+ */
+flash_err IS25wear_process(void){
+	if(pendingErases < IS25WEAR_BATCH){
+		return MEMORY_OK;
+	}
+	return IS25wear_flush();
+}
+
+/**
+ * IS25wear_loadSnapshot(uint8_t sector, wear_snapshot *snap)
+ *
+ * @Brief
+ * 		Reads the snapshot header of a reserved sector and checks it, including the CRC over all counters.
+ */
+static flash_err IS25wear_loadSnapshot(uint8_t sector, wear_snapshot *snap){
+	uint32_t offset = sizeof(*snap);
+	uint32_t crc;
+	uint32_t stored;
+	uint32_t n;
+
+	if(IS25mem_readDataFast((uint8_t *)snap, IS25wear_address(sector, 0), sizeof(*snap)) != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+	if(snap->magic != WEAR_MAGIC || snap->version != WEAR_VERSION || snap->zones != IS25WEAR_ZONES ||
+	   snap->zoneShift != zoneShift){
+		return MEMORY_ERROR;
+	}
+
+	crc = IS25mem_crc32(0, (const uint8_t *)snap, sizeof(*snap));
+	for(uint32_t left = IS25WEAR_ZONES * 4; left > 0; left -= n){
+		n = left < WEAR_RECORD_MAX ? left : WEAR_RECORD_MAX;
+		if(IS25mem_readDataFast(recordBuf, IS25wear_address(sector, offset), n) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		crc		= IS25mem_crc32(crc, recordBuf, n);
+		offset += n;
+	}
+	if(IS25mem_readDataFast((uint8_t *)&stored, IS25wear_address(sector, offset), 4) != MEMORY_OK || stored != crc){
+		return MEMORY_ERROR;
+	}
+
+	return MEMORY_OK;
+}
+
+/**
+ * IS25wear_replay(void)
+ *
+ * @Brief
+ * 		Applies the delta records of the active sector. Stops at the erased end, a damaged record marks the log full.
+ */
+static flash_err IS25wear_replay(void){
+	wear_record *rec	= (wear_record *)recordBuf;
+	uint16_t *entry		= (uint16_t *)(recordBuf + sizeof(wear_record));
+	uint32_t size;
+	uint32_t crc;
+
+	writeOffset = WEAR_LOG_START;
+	while(writeOffset + sizeof(wear_record) + 4 <= WEAR_SECTOR_SIZE){
+		if(IS25mem_readDataFast(recordBuf, IS25wear_address(activeSector, writeOffset), sizeof(wear_record)) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		if(rec->magic == 0xFFFF){
+			return MEMORY_OK;
+		}
+
+		size = sizeof(wear_record) + rec->entries * 4;
+		if(rec->magic != WEAR_RECORD_MAGIC || rec->entries > WEAR_RECORD_ENTRIES ||
+		   writeOffset + size + 4 > WEAR_SECTOR_SIZE){
+			break;
+		}
+		if(IS25mem_readDataFast(recordBuf + sizeof(wear_record), IS25wear_address(activeSector,
+				writeOffset + sizeof(wear_record)), size + 4 - sizeof(wear_record)) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+		memcpy(&crc, recordBuf + size, 4);
+		if(crc != IS25mem_crc32(0, recordBuf, size)){
+			break;
+		}
+
+		for(uint8_t i = 0; i < rec->entries; i++){
+			if(entry[2 * i] < IS25WEAR_ZONES){
+				counts[entry[2 * i]] += entry[2 * i + 1];
+			}
+		}
+		poweredSec					+= rec->seconds;
+		eraseTiming.baselineUs		= rec->eraseBaselineUs;
+		programTiming.baselineUs	= rec->programBaselineUs;
+		eraseTiming.avgUs			= rec->eraseAvgUs;
+		programTiming.avgUs			= rec->programAvgUs;
+		writeOffset					+= size + 4;
+	}
+
+	logFull = 1;
+	return MEMORY_OK;
+}
+
+/**
+ * IS25wear_init(uint32_t firstSector)
+ *
+ * @Brief
+ * 		Loads the table from the sectors firstSector and firstSector + 1 (reserved for the table, IS25WEAR_SECTORS)
+ * 		and registers the wear callback of the driver. Without a valid table all counters start at 0 and a first
+ * 		snapshot is written. Call after IS25mem_Init.
+ *
+ * @Parameter
+ * 		uint32_t	- first reserved sector
+ *
+ * @return
+ * 		flash_err	- MEMORY_WRONG_CPACITY_ERR without detected memory or if the sectors do not exist
+ */
+flash_err IS25wear_init(uint32_t firstSector){
+	const IS25mem_MemorySpace *space = IS25mem_getMemorySpace();
+	wear_snapshot snap[IS25WEAR_SECTORS];
+	flash_err valid[IS25WEAR_SECTORS];
+
+	if(space->sectors == 0 || firstSector + IS25WEAR_SECTORS > space->sectors){
+		return MEMORY_WRONG_CPACITY_ERR;
+	}
+
+	IS25mem_setWearCallback(0);
+	memset(counts, 0, sizeof(counts));
+	memset(pending, 0, sizeof(pending));
+	memset(&eraseTiming, 0, sizeof(eraseTiming));
+	memset(&programTiming, 0, sizeof(programTiming));
+
+	zoneShift = 0;
+	while((space->sectors >> zoneShift) > IS25WEAR_ZONES){
+		zoneShift++;
+	}
+	zoneCount			= (space->sectors + (1UL << zoneShift) - 1) >> zoneShift;
+	wearSector			= firstSector;
+	pendingErases		= 0;
+	poweredSec			= 0;
+	generation			= 0;
+	recordsWritten		= 0;
+	snapshotsWritten	= 0;
+	logFull				= 0;
+	lastTick			= HAL_GetTick();
+	sessionTick			= lastTick;
+
+	for(uint8_t i = 0; i < IS25WEAR_SECTORS; i++){
+		valid[i] = IS25wear_loadSnapshot(i, &snap[i]);
+	}
+
+	if(valid[0] != MEMORY_OK && valid[1] != MEMORY_OK){
+		activeSector = 1;							// The first snapshot goes to sector 0
+		memset(sessionBase, 0, sizeof(sessionBase));
+		IS25mem_setWearCallback(IS25wear_report);
+		return IS25wear_writeSnapshot();
+	}
+
+	activeSector = (valid[1] == MEMORY_OK && (valid[0] != MEMORY_OK || snap[1].generation > snap[0].generation));
+	generation					= snap[activeSector].generation;
+	poweredSec					= snap[activeSector].poweredSec;
+	eraseTiming.baselineUs		= snap[activeSector].eraseBaselineUs;
+	programTiming.baselineUs	= snap[activeSector].programBaselineUs;
+	eraseTiming.avgUs			= snap[activeSector].eraseAvgUs;
+	programTiming.avgUs			= snap[activeSector].programAvgUs;
+
+	if(IS25mem_readDataFast((uint8_t *)counts, IS25wear_address(activeSector, sizeof(wear_snapshot)),
+			sizeof(counts)) != MEMORY_OK || IS25wear_replay() != MEMORY_OK){
+		return MEMORY_ERROR;
+	}
+
+	memcpy(sessionBase, counts, sizeof(counts));
+	IS25mem_setWearCallback(IS25wear_report);
+	return MEMORY_OK;
+}
+
+/**
+ * IS25wear_getCount(uint32_t sector)
+ *
+ * @return
+ * 		uint32_t	- erases of the zone holding the sector
+ */
+uint32_t IS25wear_getCount(uint32_t sector){
+	uint32_t zone = sector >> zoneShift;
+
+	return zone < zoneCount ? counts[zone] : 0;
+}
+
+/**
+ * IS25wear_project(uint32_t zone, IS25wear_zone *out)
+ *
+ * @Brief
+ * 		Erase rate and remaining life of a zone. The rate is measured over this session once it is
+ * 		IS25WEAR_RATE_MIN_S long, before that over the whole powered time of the table.
+ */
+static void IS25wear_project(uint32_t zone, IS25wear_zone *out){
+	uint32_t sessionSec	= (HAL_GetTick() - sessionTick) / 1000;
+	uint32_t count		= counts[zone];
+	uint32_t erases;
+	uint32_t seconds;
+
+	if(sessionSec >= IS25WEAR_RATE_MIN_S){
+		erases	= count - sessionBase[zone];
+		seconds	= sessionSec;
+	}else{
+		erases	= count;
+		seconds	= poweredSec + (HAL_GetTick() - lastTick) / 1000;
+	}
+
+	out->firstSector	= zone << zoneShift;
+	out->sectors		= 1UL << zoneShift;
+	out->count			= count;
+	out->perDay			= seconds ? (uint32_t)((uint64_t)erases * 86400 / seconds) : 0;
+
+	if(count >= IS25WEAR_ENDURANCE){
+		out->remainingDays = 0;
+	}else if(erases == 0 || seconds == 0){
+		out->remainingDays = IS25WEAR_NO_LIMIT;
+	}else{
+		uint64_t days = (uint64_t)(IS25WEAR_ENDURANCE - count) * seconds / ((uint64_t)erases * 86400);
+		out->remainingDays = days < IS25WEAR_NO_LIMIT ? (uint32_t)days : IS25WEAR_NO_LIMIT - 1;
+	}
+}
+
+/**
+ * IS25wear_getHottest(IS25wear_zone *zones, uint8_t max)
+ *
+ * @Brief
+ * 		The most erased zones, highest count first, with their current erase rate and projected remaining life.
+ *
+ * @Parameter
+ * 		IS25wear_zone *	- result
+ * 		uint8_t			- result size
+ *
+ * @return
+ * 		uint8_t		- zones returned
+ */
+uint8_t IS25wear_getHottest(IS25wear_zone *zones, uint8_t max){
+	uint8_t n = 0;
+
+	while(n < max && n < zoneCount){
+		uint32_t best = zoneCount;
+
+		//Selection by count, ties by zone index, each round picks the next one below the previous result
+		for(uint32_t zone = 0; zone < zoneCount; zone++){
+			uint8_t taken = 0;
+			for(uint8_t i = 0; i < n && !taken; i++){
+				taken = (zones[i].firstSector >> zoneShift) == zone;
+			}
+			if(!taken && (best == zoneCount || counts[zone] > counts[best])){
+				best = zone;
+			}
+		}
+		IS25wear_project(best, &zones[n++]);
+	}
+
+	return n;
+}
+
+/**
+ * IS25wear_getHealth(IS25wear_health *health)
+ *
+ * @Brief
+ * 		Summary of the table and the busy time trend. Slowdowns are 0 until the baseline is complete.
+ */
+void IS25wear_getHealth(IS25wear_health *health){
+	IS25wear_zone zone;
+	uint64_t sum = 0;
+
+	memset(health, 0, sizeof(*health));
+	health->remainingDays = IS25WEAR_NO_LIMIT;
+
+	for(uint32_t i = 0; i < zoneCount; i++){
+		sum += counts[i];
+		if(counts[i] > health->maxCount){
+			health->maxCount = counts[i];
+		}
+		IS25wear_project(i, &zone);
+		if(zone.remainingDays < health->remainingDays){
+			health->remainingDays = zone.remainingDays;
+		}
+	}
+
+	health->totalErases			= (uint32_t)sum;
+	health->meanCount			= zoneCount ? (uint32_t)(sum / zoneCount) : 0;
+	health->lifeUsedPermille	= (uint32_t)((uint64_t)health->maxCount * 1000 / IS25WEAR_ENDURANCE);
+	health->poweredHours		= (poweredSec + (HAL_GetTick() - lastTick) / 1000) / 3600;
+	health->eraseAvgUs			= eraseTiming.avgUs;
+	health->eraseMaxUs			= eraseTiming.maxUs;
+	health->eraseBaselineUs		= eraseTiming.baselineUs;
+	health->programAvgUs		= programTiming.avgUs;
+	health->programMaxUs		= programTiming.maxUs;
+	health->programBaselineUs	= programTiming.baselineUs;
+	health->eraseSlowdownPct	= eraseTiming.baselineUs ? eraseTiming.avgUs * 100 / eraseTiming.baselineUs : 0;
+	health->programSlowdownPct	= programTiming.baselineUs ? programTiming.avgUs * 100 / programTiming.baselineUs : 0;
+	health->recordsWritten		= recordsWritten;
+	health->snapshotsWritten	= snapshotsWritten;
+}
@@ -0,0 +1,86 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB erase counters and health telemetry
+ *
+ *      Counts erases per zone (a power of two number of sectors, one sector per zone on parts with up to
+ *      IS25WEAR_ZONES sectors) from the wear reports of the driver, and follows the busy time of sector erases and
+ *      page programs against the first measurements as a degradation signal. A zone counter is incremented once per
+ *      erase touching the zone, so it is an upper bound for every sector of the zone.
+ *
+ *      The table lives in two reserved sectors: a snapshot of all counters followed by a log of delta records. The
+ *      counters are only updated in RAM by the report (interrupt context is fine). IS25wear_process writes one delta
+ *      record per IS25WEAR_BATCH erases, holding only the zones erased since the last record. When a sector is full,
+ *      a new snapshot is written to the other one, so tracking costs about one erase per few hundred batches.
+ *
+ */
+
+#ifndef INC_IS25LQXXXB_WEAR_H_
+#define INC_IS25LQXXXB_WEAR_H_
+
+#include "is25lqxxxb.h"
+
+#ifndef IS25WEAR_ZONES
+#define IS25WEAR_ZONES				128			// Counters in RAM and in the snapshot
+#endif
+
+#ifndef IS25WEAR_BATCH
+#define IS25WEAR_BATCH				32			// Erases per delta record written by IS25wear_process
+#endif
+
+#ifndef IS25WEAR_ENDURANCE
+#define IS25WEAR_ENDURANCE			100000		// Rated program / erase cycles per sector
+#endif
+
+#ifndef IS25WEAR_RATE_MIN_S
+#define IS25WEAR_RATE_MIN_S			3600		// Shorter sessions project with the lifetime erase rate
+#endif
+
+#ifndef IS25WEAR_ENTER_CRITICAL
+#define IS25WEAR_ENTER_CRITICAL()	uint32_t primask_ = __get_PRIMASK(); __disable_irq()
+#define IS25WEAR_EXIT_CRITICAL()	__set_PRIMASK(primask_)
+#endif
+
+#define IS25WEAR_SECTORS			2			// Reserved sectors, snapshot + delta log each
+#define IS25WEAR_BASELINE_SAMPLES	16			// Busy time measurements averaged into the baseline
+#define IS25WEAR_NO_LIMIT			0xFFFFFFFFUL
+
+typedef struct{
+	uint32_t	firstSector;
+	uint32_t	sectors;				// Sectors of the zone
+	uint32_t	count;					// Erases
+	uint32_t	perDay;					// Erases per day at the current rate
+	uint32_t	remainingDays;			// Until IS25WEAR_ENDURANCE, IS25WEAR_NO_LIMIT without erases
+}IS25wear_zone;
+
+typedef struct{
+	uint32_t	totalErases;			// Sum of all zone counters
+	uint32_t	maxCount;
+	uint32_t	meanCount;
+	uint32_t	lifeUsedPermille;		// maxCount against IS25WEAR_ENDURANCE
+	uint32_t	poweredHours;			// Time covered by the table, counted between flushes
+	uint32_t	remainingDays;			// Shortest projection of all zones
+	uint32_t	eraseAvgUs;				// Sector erase busy time, moving average
+	uint32_t	eraseMaxUs;				// Since IS25wear_init
+	uint32_t	eraseBaselineUs;		// Average of the first IS25WEAR_BASELINE_SAMPLES erases, 0 until complete
+	uint32_t	programAvgUs;			// Full page program busy time, moving average
+	uint32_t	programMaxUs;
+	uint32_t	programBaselineUs;
+	uint32_t	eraseSlowdownPct;		// eraseAvgUs against the baseline, 100 = unchanged
+	uint32_t	programSlowdownPct;
+	uint32_t	recordsWritten;			// Delta records and snapshots since IS25wear_init
+	uint32_t	snapshotsWritten;
+}IS25wear_health;
+
+
+//External function declaration
+
+extern flash_err IS25wear_init(uint32_t firstSector);
+extern flash_err IS25wear_process(void);
+extern flash_err IS25wear_flush(void);
+extern uint32_t IS25wear_getCount(uint32_t sector);
+extern uint8_t IS25wear_getHottest(IS25wear_zone *zones, uint8_t max);
+extern void IS25wear_getHealth(IS25wear_health *health);
+extern void IS25wear_report(IS25mem_wearOp op, mem_address address, uint32_t size, uint32_t busyUs);
+
+#endif /* INC_IS25LQXXXB_WEAR_H_ */
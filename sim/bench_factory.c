@@ -0,0 +1,63 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Factory programming benchmark: a 256 kByte image on a dirty device, program and verify throughput of
+ *      IS25fac_program on the simulated flash against the bus limits of the report. A device with block protection
+ *      bits set is rejected before the erase.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_factory.h"
+#include "is25lqxxxb_protect.h"
+
+#define IMAGE_SIZE			0x40000
+
+static uint8_t		firmware[IMAGE_SIZE];
+
+int main(void){
+	IS25fac_image image = {firmware, 0, 0, IMAGE_SIZE, {{0}}};
+	IS25fac_report report;
+	IS25sim_stats sim;
+
+	//Every 8th page blank, the rest pattern
+	for(uint32_t i = 0; i < IMAGE_SIZE; i++){
+		firmware[i] = ((i >> 8) & 7) == 7 ? 0xFF : (uint8_t)(i * 13 + (i >> 9));
+	}
+
+	IS25sim_init(0);
+	memset(IS25sim_memory(), 0x00, IS25sim_size());
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+
+	//Protected upper block, the chip erase would be ignored
+	CHECK_EQ(IS25prot_init(), MEMORY_OK);
+	CHECK_EQ(IS25prot_setProtection(1), MEMORY_OK);
+	IS25sim_resetStats();
+	CHECK_EQ(IS25fac_program(&image, &report), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(report.failedStep, IS25_FAC_ERASE);
+	IS25sim_getStats(&sim);
+	CHECK_EQ(sim.chipErases + sim.sectorErases + sim.pagePrograms, 0);
+	CHECK_EQ(IS25sim_memory()[0], 0x00);
+
+	CHECK_EQ(IS25prot_setProtection(0), MEMORY_OK);
+	CHECK_EQ(IS25fac_program(&image, &report), MEMORY_OK);
+	CHECK_EQ(report.chipErased, 1);
+	CHECK_EQ(report.pagesProgrammed, IMAGE_SIZE / 256 * 7 / 8);
+	CHECK_EQ(report.pagesSkipped, IMAGE_SIZE / 256 / 8);
+	CHECK_EQ(report.readbackCrc, report.imageCrc);
+	CHECK(memcmp(IS25sim_memory(), firmware, IMAGE_SIZE) == 0);
+
+	printf("factory: %u kByte at %u MHz, erase %u ms, program %u byte/s (limit %u, %u %%), verify %u byte/s "
+			"(limit %u, %u %%), total %u ms\n", (unsigned)(IMAGE_SIZE / 1024), (unsigned)(report.sclkHz / 1000000),
+			(unsigned)(report.eraseUs / 1000), (unsigned)report.programBytesPerSec,
+			(unsigned)report.programLimitBytesPerSec, (unsigned)report.programEfficiencyPct,
+			(unsigned)report.verifyBytesPerSec, (unsigned)report.verifyLimitBytesPerSec,
+			(unsigned)report.verifyEfficiencyPct, (unsigned)(report.totalUs / 1000));
+	CHECK(report.programEfficiencyPct >= 90 && report.programEfficiencyPct <= 100);
+	CHECK(report.verifyEfficiencyPct >= 90 && report.verifyEfficiencyPct <= 100);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,91 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      A/B image store benchmark: time of a full slot update on the simulated flash against the device limit
+ *      (page programs plus erases at their typical times), verify of the other slot during the update.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_image.h"
+
+#define CHUNK_SIZE			4096
+
+static uint8_t		chunk[CHUNK_SIZE];
+
+static flash_err writeRange(uint32_t offset, uint32_t end, uint8_t seed){
+	uint32_t part;
+
+	for(; offset < end; offset += part){
+		part = (end - offset) > CHUNK_SIZE ? CHUNK_SIZE : end - offset;
+		for(uint32_t i = 0; i < part; i++){
+			chunk[i] = (uint8_t)((offset + i) * 31 + seed);
+		}
+		if(IS25img_write(chunk, part) != MEMORY_OK){
+			return MEMORY_ERROR;
+		}
+	}
+	return MEMORY_OK;
+}
+
+int main(void){
+	IS25sim_config cfg;
+	IS25sim_stats sim;
+	IS25img_stats stats;
+	IS25img_slotInfo info;
+	uint32_t size;
+	uint64_t start;
+	uint64_t limitUs;
+	uint64_t elapsedUs;
+	uint8_t slot;
+
+	IS25sim_defaults(&cfg);
+	IS25sim_init(&cfg);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	size = IS25img_slotCapacity();
+
+	//Full slot update
+	IS25sim_resetStats();
+	start = IS25sim_nowNs();
+	CHECK_EQ(IS25img_begin(0, size), MEMORY_OK);
+	CHECK_EQ(writeRange(0, size, 1), MEMORY_OK);
+	CHECK_EQ(IS25img_finish(), MEMORY_OK);
+	elapsedUs = (IS25sim_nowNs() - start) / 1000;
+	IS25sim_getStats(&sim);
+	IS25img_getStats(&stats);
+
+	limitUs = (uint64_t)sim.pagePrograms * cfg.tppUs + (uint64_t)sim.sectorErases * cfg.tseUs
+			+ (uint64_t)sim.blockErases * cfg.tbeUs;
+	printf("full slot update: %u kByte in %llu ms, device limit %llu ms (%u pages, %u sector / %u block erases), "
+			"%u checkpoints, erase %u ms, program %u ms\n", (unsigned)(size / 1024), (unsigned long long)elapsedUs / 1000,
+			(unsigned long long)limitUs / 1000, (unsigned)sim.pagePrograms, (unsigned)sim.sectorErases,
+			(unsigned)sim.blockErases, (unsigned)stats.checkpoints, (unsigned)stats.eraseMs, (unsigned)stats.programMs);
+	CHECK(elapsedUs >= limitUs);
+	CHECK(elapsedUs < limitUs + limitUs / 4);
+	CHECK_EQ(IS25img_verify(0), MEMORY_OK);
+	CHECK_EQ(IS25img_getActive(&slot), MEMORY_OK);
+	CHECK_EQ(slot, 0);
+
+	//Verify of slot 0 while the update of slot 1 holds a partial page
+	CHECK_EQ(IS25img_begin(1, size), MEMORY_OK);
+	CHECK_EQ(writeRange(0, CHUNK_SIZE + 100, 2), MEMORY_OK);
+	CHECK_EQ(IS25img_verify(0), MEMORY_OK);
+	CHECK_EQ(writeRange(CHUNK_SIZE + 100, size, 2), MEMORY_OK);
+	CHECK_EQ(IS25img_finish(), MEMORY_OK);
+	CHECK_EQ(IS25img_getSlotInfo(1, &info), MEMORY_OK);
+	CHECK_EQ(info.state, IS25_IMG_VALID);
+	CHECK_EQ(IS25img_verify(1), MEMORY_OK);
+	for(uint32_t i = 0; i < size; i++){
+		if(IS25sim_memory()[(IS25sim_size() / 2) + 4096 + i] != (uint8_t)(i * 31 + 2)){
+			CHECK(!"slot 1 content");
+			break;
+		}
+	}
+	CHECK_EQ(IS25img_getActive(&slot), MEMORY_OK);
+	CHECK_EQ(slot, 1);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
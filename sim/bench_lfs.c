@@ -0,0 +1,64 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      littlefs benchmark on the simulated flash: IS25lfs_benchmark on a freshly formatted filesystem over the
+ *      whole memory, total time against the device limit (page programs plus sector erases at their typical times).
+ *      Needs littlefs, see the lfs target of the Makefile.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_lfs.h"
+
+#define FILES				4
+#define FILE_SIZE			32768
+#define CHUNK_SIZE			256
+
+static uint8_t		chunk[CHUNK_SIZE];
+
+int main(void){
+	IS25sim_config cfg;
+	IS25sim_stats sim;
+	struct lfs_config lfsCfg;
+	struct lfs_info info;
+	IS25lfs_bench bench;
+	lfs_t lfs;
+	uint64_t start;
+	uint64_t limitUs;
+	uint64_t elapsedUs;
+
+	IS25sim_defaults(&cfg);
+	IS25sim_init(&cfg);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK_EQ(IS25lfs_init(&lfsCfg, 0, 0), MEMORY_OK);
+	CHECK_EQ(lfs_format(&lfs, &lfsCfg), LFS_ERR_OK);
+	CHECK_EQ(lfs_mount(&lfs, &lfsCfg), LFS_ERR_OK);
+
+	IS25sim_resetStats();
+	start = IS25sim_nowNs();
+	CHECK_EQ(IS25lfs_benchmark(&lfs, FILES, FILE_SIZE, chunk, CHUNK_SIZE, &bench), LFS_ERR_OK);
+	elapsedUs = (IS25sim_nowNs() - start) / 1000;
+	IS25sim_getStats(&sim);
+
+	limitUs = (uint64_t)sim.pagePrograms * cfg.tppUs + (uint64_t)sim.sectorErases * cfg.tseUs;
+	printf("littlefs: %u files of %u byte, create %u ms, append %u ms (%u byte/s), read %u ms (%u byte/s)\n",
+			(unsigned)bench.files, (unsigned)FILE_SIZE, (unsigned)bench.createMs, (unsigned)bench.appendMs,
+			(unsigned)bench.appendBytesPerSec, (unsigned)bench.readMs, (unsigned)bench.readBytesPerSec);
+	printf("device: %u byte read, %u byte programmed, %u blocks erased, %llu ms total, device limit %llu ms "
+			"(%u pages, %u sector erases)\n", (unsigned)bench.device.bytesRead, (unsigned)bench.device.bytesProgrammed,
+			(unsigned)bench.device.blocksErased, (unsigned long long)elapsedUs / 1000,
+			(unsigned long long)limitUs / 1000, (unsigned)sim.pagePrograms, (unsigned)sim.sectorErases);
+	CHECK_EQ(bench.bytes, FILES * FILE_SIZE);
+	CHECK(bench.device.bytesProgrammed >= FILES * FILE_SIZE);
+	CHECK(elapsedUs >= limitUs);
+	CHECK(bench.appendBytesPerSec > 0 && bench.readBytesPerSec > bench.appendBytesPerSec);
+
+	//The benchmark files are gone
+	CHECK_EQ(lfs_stat(&lfs, "is25bench000", &info), LFS_ERR_NOENT);
+	CHECK_EQ(lfs_unmount(&lfs), LFS_ERR_OK);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
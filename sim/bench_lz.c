@@ -0,0 +1,147 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Compressed frame log benchmark: telemetry records and random data written as frames on the simulated flash,
+ *      read back at random frames and compared. Prints the ratio, the write rate (encode + program) from
+ *      IS25lz_getStats and the decode rate. The simulation does not count CPU time, so the decode rate is taken on
+ *      the host with IS25lz_decompress.
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+#include "simtest.h"
+#include "is25lqxxxb_lz.h"
+
+#define LOG_START			0x10000
+#define BLOCK_SIZE			1024
+#define BLOCKS				128				// Even: telemetry, odd: random
+#define READS				512
+#define DECODE_ROUNDS		2000
+
+typedef struct{
+	uint32_t	timestamp;
+	uint32_t	deviceId;
+	int16_t		temperature;
+	uint16_t	pressure;
+	uint16_t	humidity;
+	uint16_t	voltage;
+	uint16_t	current;
+	uint16_t	speed;
+	uint8_t		state;
+	uint8_t		flags;
+	uint16_t	errors;
+	uint32_t	sequence;
+}telemetry;
+
+static uint8_t		arena[IS25LZ_ARENA_SIZE(BLOCK_SIZE)] __attribute__((aligned(4)));
+static uint8_t		blocks[BLOCKS][BLOCK_SIZE];
+static uint32_t		frames[BLOCKS + 1];
+static uint32_t		rng = 0x2545F491;
+
+static uint32_t nextRandom(void){
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static void fillTelemetry(uint8_t *block, uint32_t n){
+	telemetry record = {0};
+
+	for(uint32_t i = 0; i < BLOCK_SIZE / sizeof(record); i++){
+		uint32_t t = n * (BLOCK_SIZE / sizeof(record)) + i;
+
+		record.timestamp	= t * 100;
+		record.deviceId		= 0x00C0FFEE;
+		record.temperature	= (int16_t)(2150 + (t / 16) % 8);
+		record.pressure		= (uint16_t)(10132 + (t / 8) % 3);
+		record.humidity		= 450;
+		record.voltage		= (uint16_t)(3300 - (t / 64) % 4);
+		record.current		= (uint16_t)(120 + (nextRandom() & 1));
+		record.state		= (t / 64) & 1;
+		record.sequence		= t;
+		memcpy(&block[i * sizeof(record)], &record, sizeof(record));
+	}
+}
+
+static double hostUs(void){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(void){
+	IS25lz_stats stats;
+	mem_address address = {.val = LOG_START};
+	uint8_t back[BLOCK_SIZE];
+	uint8_t packed[BLOCK_SIZE];
+	uint32_t storedKind[2] = {0};
+	uint32_t packedSize;
+	uint32_t size, used;
+	double start, decodeUs;
+
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK_EQ(IS25lz_init(arena, sizeof(arena)), MEMORY_OK);
+	CHECK(IS25lz_maxBlock() >= BLOCK_SIZE);
+
+	for(uint32_t n = 0; n < BLOCKS; n++){
+		if(n & 1){
+			for(uint32_t i = 0; i < BLOCK_SIZE; i++){
+				blocks[n][i] = (uint8_t)nextRandom();
+			}
+		}else{
+			fillTelemetry(blocks[n], n / 2);
+		}
+		frames[n] = address.val;
+		CHECK_EQ(IS25lz_writeBlock(blocks[n], BLOCK_SIZE, address, &used), MEMORY_OK);
+		storedKind[n & 1] += used;
+		address.val += used;
+	}
+	frames[BLOCKS] = address.val;
+	IS25lz_getStats(&stats);
+	CHECK_EQ(stats.blocksCompressed, BLOCKS / 2);
+	CHECK_EQ(stats.blocksRaw, BLOCKS / 2);
+	CHECK_EQ(stats.rawBytes, BLOCKS * BLOCK_SIZE);
+	CHECK_EQ(stats.storedBytes, frames[BLOCKS] - LOG_START);
+	CHECK(stats.writeUs > 0);
+
+	//Random frames, the end of the log reads as erased
+	for(uint32_t i = 0; i < READS; i++){
+		uint32_t n = nextRandom() % BLOCKS;
+
+		address.val = frames[n];
+		CHECK_EQ(IS25lz_readBlock(back, sizeof(back), address, &size, &used), MEMORY_OK);
+		CHECK_EQ(size, BLOCK_SIZE);
+		CHECK_EQ(used, frames[n + 1] - frames[n]);
+		CHECK(memcmp(back, blocks[n], BLOCK_SIZE) == 0);
+	}
+	address.val = frames[BLOCKS];
+	CHECK_EQ(IS25lz_readBlock(back, sizeof(back), address, &size, &used), MEMORY_OK);
+	CHECK_EQ(size, 0);
+	IS25lz_getStats(&stats);
+	CHECK_EQ(stats.decodedBytes, READS * BLOCK_SIZE);
+
+	packedSize = IS25lz_compress(blocks[0], BLOCK_SIZE, packed, sizeof(packed));
+	CHECK(packedSize > 0);
+	start = hostUs();
+	for(uint32_t i = 0; i < DECODE_ROUNDS; i++){
+		CHECK_EQ(IS25lz_decompress(packed, packedSize, back, sizeof(back)), BLOCK_SIZE);
+	}
+	decodeUs = hostUs() - start;
+	CHECK(memcmp(back, blocks[0], BLOCK_SIZE) == 0);
+
+	printf("lz: %u blocks of %u byte, ratio %.2f (telemetry %.2f, random %.2f), write %.2f MB/s, "
+			"read %.2f MB/s, decode %.1f MB/s (host)\n", (unsigned)BLOCKS, (unsigned)BLOCK_SIZE,
+			(double)stats.rawBytes / stats.storedBytes, (double)(BLOCKS / 2 * BLOCK_SIZE) / storedKind[0],
+			(double)(BLOCKS / 2 * BLOCK_SIZE) / storedKind[1], (double)stats.rawBytes / stats.writeUs,
+			(double)stats.decodedBytes / stats.readUs, (double)DECODE_ROUNDS * BLOCK_SIZE / decodeUs);
+	CHECK(storedKind[0] * 2 <= BLOCKS / 2 * BLOCK_SIZE);
+	CHECK(storedKind[1] >= BLOCKS / 2 * BLOCK_SIZE);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
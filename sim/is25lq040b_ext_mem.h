@@ -0,0 +1,8 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      is25lqxxxb.c includes the driver header by its original name, the host build maps it to is25lqxxxb.h
+ *
+ */
+
+#include "is25lqxxxb.h"
@@ -0,0 +1,1047 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Host model of the QSPI peripheral and an IS25LQ / IS25LP flash
+ *
+ */
+
+//Includes
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "is25sim.h"
+#include "is25lqxxxb_async.h"
+
+#define SIM_WIP					0x01
+#define SIM_WEL					0x02
+#define SIM_BP_MASK				0x3C
+#define SIM_FR_TBS				0x02
+#define SIM_FR_PSUS				0x04
+#define SIM_FR_ESUS				0x08
+
+typedef enum{
+	BUSY_NONE		= 0,
+	BUSY_PROGRAM	= 1,
+	BUSY_ERASE		= 2,			// Sector / block erase, can be suspended
+	BUSY_CHIP		= 3,
+	BUSY_REGISTER	= 4
+}sim_busy;
+
+typedef enum{
+	EVENT_NONE		= 0,
+	EVENT_CMD		= 1,
+	EVENT_TX		= 2,
+	EVENT_RX		= 3,
+	EVENT_MATCH		= 4
+}sim_event;
+
+//Private variables
+static IS25sim_config		cfg;
+static IS25sim_stats		stats;
+static QSPI_HandleTypeDef	handle;
+static QUADSPI_TypeDef		quadspi;
+static uint8_t				*memory			= 0;
+static uint32_t				memorySize		= 0;
+static uint32_t				*eraseCounts	= 0;
+static uint8_t				infoRows[4][256];
+
+static uint64_t				now				= 0;			// ns
+static uint8_t				status			= 0;			// SRWD QE BP3-0 WEL, WIP is derived from busyUntil
+static uint8_t				function		= 0;
+static sim_busy				busy			= BUSY_NONE;
+static uint64_t				busyUntil		= 0;
+static uint64_t				commandEnd		= 0;			// CS# high of the executed command, programs / erases start here
+static uint8_t				suspended		= 0;
+static uint64_t				suspendRemain	= 0;
+static uint32_t				eraseStart		= 0;			// Range of the running / suspended erase
+static uint32_t				eraseEnd		= 0;
+static int32_t				unlockedSector	= -1;			// SECUNLOCK
+static uint8_t				resetEnabled	= 0;
+static uint8_t				powerDown		= 0;
+static uint32_t				powerFailIn		= 0;			// Write commands until the power fails, 0 never
+static uint8_t				powerFailed		= 0;
+
+static QSPI_CommandTypeDef	latched;						// Command with data phase, waiting for its data
+static uint8_t				latchedValid	= 0;
+static sim_event			event			= EVENT_NONE;
+static uint64_t				eventAt			= 0;
+
+static pthread_mutex_t		simLock;
+static pthread_mutex_t		irqLock;
+static pthread_cond_t		eventCond		= PTHREAD_COND_INITIALIZER;
+static pthread_once_t		lockOnce		= PTHREAD_ONCE_INIT;
+static pthread_t			irqThread;
+static volatile uint8_t		irqRunning		= 0;
+static __thread uint32_t	maskDepth		= 0;			// PRIMASK / interrupt handler nesting of the calling thread
+
+static DWT_Type				dwt				= {0};
+static CoreDebug_Type		coreDebug		= {0};
+DWT_Type			*const DWT			= &dwt;
+CoreDebug_Type		*const CoreDebug	= &coreDebug;
+
+
+static void IS25sim_initLocks(void){
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&simLock, &attr);
+	pthread_mutex_init(&irqLock, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+static void IS25sim_lock(void){
+	pthread_once(&lockOnce, IS25sim_initLocks);
+	pthread_mutex_lock(&simLock);
+}
+
+static void IS25sim_unlock(void){
+	pthread_mutex_unlock(&simLock);
+}
+
+/**
+ * IS25sim_advance(uint64_t ns)
+ *
+ * @Brief
+ * 		Moves the simulated time, the cycle counter follows once it is enabled like on the target.
+ */
+static void IS25sim_advance(uint64_t ns){
+	now += ns;
+	if((coreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk)){
+		dwt.CYCCNT = (uint32_t)(now * cfg.hclkHz / 1000000000ULL);
+	}
+}
+
+/**
+ * IS25sim_settle(void)
+ *
+ * @Brief
+ * 		Ends a program / erase / register write whose time is over. A suspended operation stays pending.
+ */
+static void IS25sim_settle(void){
+	if(busy != BUSY_NONE && !suspended && now >= busyUntil){
+		busy	= BUSY_NONE;
+		status &= (uint8_t)~SIM_WEL;
+	}
+}
+
+static uint8_t IS25sim_status(void){
+	IS25sim_settle();
+	return (uint8_t)(status | ((busy != BUSY_NONE && now < busyUntil) ? SIM_WIP : 0));
+}
+
+static void IS25sim_startBusy(sim_busy kind, uint32_t us){
+	busy		= kind;
+	busyUntil	= commandEnd + (uint64_t)us * 1000;
+}
+
+static uint32_t IS25sim_lines(uint32_t mode){
+	return mode == 3 ? 4 : mode;
+}
+
+static uint32_t IS25sim_sclk(void){
+	return cfg.hclkHz / (((quadspi.CR & QUADSPI_CR_PRESCALER) >> QUADSPI_CR_PRESCALER_Pos) + 1);
+}
+
+/**
+ * IS25sim_busNs(const QSPI_CommandTypeDef *cmd, uint32_t bytes)
+ *
+ * @return
+ * 		uint64_t	- bus time of the command with bytes in the data phase at the current clock
+ */
+static uint64_t IS25sim_busNs(const QSPI_CommandTypeDef *cmd, uint32_t bytes){
+	uint64_t cycles = 0;
+
+	if(cmd->InstructionMode != QSPI_INSTRUCTION_NONE){
+		cycles += 8 / IS25sim_lines(cmd->InstructionMode);
+	}
+	if(cmd->AddressMode != QSPI_ADDRESS_NONE){
+		cycles += (cmd->AddressSize + 1) * 8 / IS25sim_lines(cmd->AddressMode);
+	}
+	if(cmd->AlternateByteMode != QSPI_ALTERNATE_BYTES_NONE){
+		cycles += (cmd->AlternateBytesSize + 1) * 8 / IS25sim_lines(cmd->AlternateByteMode);
+	}
+	cycles += cmd->DummyCycles;
+	if(cmd->DataMode != QSPI_DATA_NONE){
+		cycles += (uint64_t)bytes * 8 / IS25sim_lines(cmd->DataMode);
+	}
+
+	return cycles * 1000000000ULL / IS25sim_sclk();
+}
+
+/**
+ * IS25sim_bus(const QSPI_CommandTypeDef *cmd, uint32_t bytes)
+ *
+ * @Brief
+ * 		Accounts the bus time of a command and checks the clock against the maximum of the instruction.
+ */
+static uint64_t IS25sim_bus(const QSPI_CommandTypeDef *cmd, uint32_t bytes){
+	uint32_t limit	= (cmd->Instruction == 0x03 || cmd->Instruction == 0x13) ? cfg.maxReadHz : cfg.maxFastHz;
+	uint64_t ns		= IS25sim_busNs(cmd, bytes);
+
+	if(IS25sim_sclk() > limit){
+		stats.clockViolations++;
+	}
+	stats.busNs += ns;
+	return ns + cfg.callNs;
+}
+
+static uint32_t IS25sim_address(const QSPI_CommandTypeDef *cmd){
+	uint32_t address = cmd->Address;
+
+	if(cmd->AddressSize == QSPI_ADDRESS_24_BITS){
+		address &= 0xFFFFFFUL;
+	}
+	return address % memorySize;
+}
+
+/**
+ * IS25sim_protected(uint32_t address, uint32_t size)
+ *
+ * @return
+ * 		uint8_t		- "1" if the range touches the block protected area and is not the unlocked sector
+ */
+static uint8_t IS25sim_protected(uint32_t address, uint32_t size){
+	uint8_t bp = (status & SIM_BP_MASK) >> 2;
+	uint32_t length;
+	uint32_t start;
+
+	if(bp == 0){
+		return 0;
+	}
+	length	= (bp >= 15 || (65536UL << (bp - 1)) >= memorySize) ? memorySize : 65536UL << (bp - 1);
+	start	= (function & SIM_FR_TBS) ? 0 : memorySize - length;
+
+	if(unlockedSector >= 0 && (address >> 12) == (uint32_t)unlockedSector && ((address + size - 1) >> 12) == (uint32_t)unlockedSector){
+		return 0;
+	}
+	return address < start + length && address + size > start;
+}
+
+/**
+ * IS25sim_write(void)
+ *
+ * @Brief
+ * 		Common checks of program / erase / register writes.
+ *
+ * @return
+ * 		int		- 1 accepted, 0 ignored by the memory, -1 power failed
+ */
+static int IS25sim_write(void){
+	if(powerFailIn != 0 && --powerFailIn == 0){
+		powerFailed = 1;
+		return -1;
+	}
+	if(suspended){
+		stats.suspendViolations++;
+		return 0;
+	}
+	if(!(status & SIM_WEL)){
+		stats.ignored++;
+		return 0;
+	}
+	return 1;
+}
+
+static void IS25sim_erase(uint32_t start, uint32_t size, sim_busy kind, uint32_t us){
+	memset(memory + start, 0xFF, size);
+	for(uint32_t sector = start >> 12; sector < (start + size) >> 12; sector++){
+		eraseCounts[sector]++;
+	}
+	eraseStart	= start;
+	eraseEnd	= start + size;
+	IS25sim_startBusy(kind, us);
+}
+
+/**
+ * IS25sim_readWait(uint32_t instruction)
+ *
+ * @return
+ * 		int		- cycles between address and data (mode bits + dummy) the read instruction needs, -1 if no array read
+ */
+static int IS25sim_readWait(uint32_t instruction){
+	switch(instruction){
+		case 0x03: case 0x13:	return 0;
+		case 0x0B: case 0x0C:	return 8;
+		case 0x3B: case 0x3C:	return 8;
+		case 0xBB: case 0xBC:	return 4;
+		case 0x6B: case 0x6C:	return 8;
+		case 0xEB: case 0xEC:	return 6;
+		default:				return -1;
+	}
+}
+
+/**
+ * IS25sim_read(const QSPI_CommandTypeDef *cmd, uint8_t *data, uint32_t size)
+ *
+ * @Brief
+ * 		Array read. A wrong number of wait cycles, a missing sample shift above 60 MHz or quad data without QE return
+ * 		corrupted data like a real bus would.
+ */
+static void IS25sim_read(const QSPI_CommandTypeDef *cmd, uint8_t *data, uint32_t size){
+	uint32_t address	= IS25sim_address(cmd);
+	uint32_t wait		= cmd->DummyCycles;
+	uint8_t corrupt		= 0;
+
+	if(cmd->AlternateByteMode != QSPI_ALTERNATE_BYTES_NONE){
+		wait += (cmd->AlternateBytesSize + 1) * 8 / IS25sim_lines(cmd->AlternateByteMode);
+	}
+	corrupt |= wait != (uint32_t)IS25sim_readWait(cmd->Instruction);
+	corrupt |= IS25sim_sclk() > 60000000UL && !(quadspi.CR & QUADSPI_CR_SSHIFT) && cmd->Instruction != 0x03;
+	corrupt |= cmd->DataMode == QSPI_DATA_4_LINES && !(status & 0x40);
+
+	if(suspended && address < eraseEnd && address + size > eraseStart){
+		stats.suspendViolations++;
+	}
+
+	for(uint32_t i = 0; i < size; i++){
+		data[i] = memory[(address + i) % memorySize];
+		if(corrupt){
+			data[i] = (uint8_t)((data[i] << 1) | (i & 1));
+		}
+	}
+	stats.reads++;
+	stats.readBytes += size;
+}
+
+/**
+ * IS25sim_execute(const QSPI_CommandTypeDef *cmd, uint8_t *data, uint32_t size)
+ *
+ * @Brief
+ * 		Executes a command, data is the transmitted or received data phase.
+ *
+ * @return
+ * 		HAL_StatusTypeDef	- HAL_ERROR once the power failed
+ */
+static HAL_StatusTypeDef IS25sim_execute(const QSPI_CommandTypeDef *cmd, uint8_t *data, uint32_t size){
+	uint8_t instruction	= (uint8_t)cmd->Instruction;
+	uint32_t address	= cmd->AddressMode != QSPI_ADDRESS_NONE ? IS25sim_address(cmd) : 0;
+	uint8_t wip			= IS25sim_status() & SIM_WIP;
+	int accept;
+
+	stats.commands++;
+
+	if(powerDown && instruction != 0xAB){
+		return HAL_OK;
+	}
+	if(wip && instruction != 0x05 && instruction != 0xB0 && instruction != 0x48){
+		stats.busyViolations++;
+		if(cmd->DataMode != QSPI_DATA_NONE && data != 0 && instruction != 0x02 && instruction != 0x12 &&
+		   instruction != 0x38 && instruction != 0x34 && instruction != 0x01 && instruction != 0x42 && instruction != 0x62){
+			memset(data, 0xFF, size);
+		}
+		return HAL_OK;
+	}
+
+	if(IS25sim_readWait(instruction) >= 0){
+		IS25sim_read(cmd, data, size);
+		return HAL_OK;
+	}
+
+	switch(instruction){
+		case 0x06:	status |= SIM_WEL;											break;
+		case 0x04:	status &= (uint8_t)~SIM_WEL;								break;
+		case 0x05:	memset(data, IS25sim_status(), size);						break;
+		case 0x48:	memset(data, function, size);								break;
+		case 0x01:	if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(accept){
+						status = (uint8_t)((status & 0x03) | (data[0] & 0xFC));
+						stats.statusWrites++;
+						IS25sim_startBusy(BUSY_REGISTER, cfg.twUs);
+					}
+					break;
+		case 0x42:	if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(accept){
+						function |= data[0] & (0xF0 | SIM_FR_TBS);
+						IS25sim_startBusy(BUSY_REGISTER, cfg.twUs);
+					}
+					break;
+		case 0x02: case 0x12: case 0x38: case 0x34:
+					if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(!accept || ((instruction == 0x38 || instruction == 0x34) && !(status & 0x40))){
+						break;
+					}
+					if(IS25sim_protected(address, size)){
+						status &= (uint8_t)~SIM_WEL;
+						stats.ignored++;
+						break;
+					}
+					for(uint32_t i = 0; i < size; i++){
+						memory[(address & ~0xFFUL) + ((address + i) & 0xFF)] &= data[i];
+					}
+					stats.pagePrograms++;
+					stats.programBytes += size;
+					IS25sim_startBusy(BUSY_PROGRAM, cfg.tppUs);
+					break;
+		case 0x20: case 0x21: case 0x52: case 0x5C: case 0xD8: case 0xDC:
+		{
+			uint32_t size = (instruction == 0x20 || instruction == 0x21) ? 0x1000UL :
+							(instruction == 0x52 || instruction == 0x5C) ? 0x8000UL : 0x10000UL;
+
+					if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					address &= ~(size - 1);
+					if(!accept){
+						break;
+					}
+					if(IS25sim_protected(address, size)){
+						status &= (uint8_t)~SIM_WEL;
+						stats.ignored++;
+						break;
+					}
+					if(size == 0x1000UL){
+						stats.sectorErases++;
+					}else{
+						stats.blockErases++;
+					}
+					IS25sim_erase(address, size, BUSY_ERASE, size == 0x1000UL ? cfg.tseUs : cfg.tbeUs);
+					break;
+		}
+		case 0x60: case 0xC7:
+					if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(!accept){
+						break;
+					}
+					if(status & SIM_BP_MASK){
+						status &= (uint8_t)~SIM_WEL;
+						stats.ignored++;
+						break;
+					}
+					stats.chipErases++;
+					IS25sim_erase(0, memorySize, BUSY_CHIP, cfg.tceUs);
+					break;
+		case 0xB0:	if(!suspended && (busy == BUSY_ERASE || busy == BUSY_PROGRAM) && now < busyUntil){
+						suspended		= 1;
+						suspendRemain	= busyUntil - now;
+						busyUntil		= now + (uint64_t)cfg.tsusUs * 1000;
+						function	   |= (busy == BUSY_ERASE) ? SIM_FR_ESUS : SIM_FR_PSUS;
+						stats.suspends++;
+					}
+					break;
+		case 0x30:	if(suspended){
+						suspended		= 0;
+						busyUntil		= now + suspendRemain;
+						function	   &= (uint8_t)~(SIM_FR_ESUS | SIM_FR_PSUS);
+						stats.resumes++;
+					}
+					break;
+		case 0x26:	if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(accept){
+						unlockedSector	= (int32_t)(address >> 12);
+						status		   &= (uint8_t)~SIM_WEL;
+					}
+					break;
+		case 0x24:	unlockedSector = -1;										break;
+		case 0x62:	if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(accept && !(function & (0x10 << ((address >> 12) & 3)))){
+						for(uint32_t i = 0; i < size; i++){
+							infoRows[(address >> 12) & 3][(address + i) & 0xFF] &= data[i];
+						}
+						IS25sim_startBusy(BUSY_PROGRAM, cfg.tppUs);
+					}else{
+						status &= (uint8_t)~SIM_WEL;
+					}
+					break;
+		case 0x64:	if((accept = IS25sim_write()) < 0){
+						return HAL_ERROR;
+					}
+					if(accept && !(function & (0x10 << ((address >> 12) & 3)))){
+						memset(infoRows[(address >> 12) & 3], 0xFF, 256);
+						IS25sim_startBusy(BUSY_REGISTER, cfg.tseUs);
+					}else{
+						status &= (uint8_t)~SIM_WEL;
+					}
+					break;
+		case 0x68:	for(uint32_t i = 0; i < size; i++){
+						data[i] = infoRows[(address >> 12) & 3][(address + i) & 0xFF];
+					}
+					break;
+		case 0x9F:	for(uint32_t i = 0; i < size; i++){
+						data[i] = (uint8_t[]){0x9D, 0x40, cfg.capacity}[i % 3];
+					}
+					break;
+		case 0xAB:	powerDown = 0;
+					if(data != 0){
+						memset(data, cfg.capacity <= 0x13 ? cfg.capacity - 1 : cfg.capacity, size);
+					}
+					break;
+		case 0xB9:	powerDown = 1;												break;
+		case 0x4B:	for(uint32_t i = 0; i < size; i++){
+						data[i] = (uint8_t)(0xA0 + i);
+					}
+					break;
+		case 0x66:	resetEnabled = 1;											break;
+		case 0x99:	if(resetEnabled){
+						status		   &= (uint8_t)~SIM_WEL;
+						unlockedSector	= -1;
+					}
+					resetEnabled = 0;
+					break;
+		default:	break;
+	}
+
+	return HAL_OK;
+}
+
+/**
+ * IS25sim_defaults(IS25sim_config *cfg)
+ *
+ * @Brief
+ * 		IS25LQ040B at 80 MHz HCLK with typical data sheet times.
+ */
+void IS25sim_defaults(IS25sim_config *config){
+	*config = (IS25sim_config){
+		.capacity	= 0x13,
+		.hclkHz		= 80000000UL,
+		.callNs		= 300,
+		.tppUs		= 200,
+		.tseUs		= 45000,
+		.tbeUs		= 150000,
+		.tceUs		= 1500000,
+		.twUs		= 2000,
+		.tsusUs		= 30,
+		.maxReadHz	= 33000000UL,
+		.maxFastHz	= 104000000UL,
+		.tbs		= 0,
+	};
+}
+
+/**
+ * IS25sim_init(const IS25sim_config *cfg)
+ *
+ * @Brief
+ * 		Erased memory, registers at their defaults, time and statistics at zero. 0 selects IS25sim_defaults.
+ */
+void IS25sim_init(const IS25sim_config *config){
+	uint8_t capacity;
+
+	IS25sim_lock();
+
+	if(config != 0){
+		cfg = *config;
+	}else{
+		IS25sim_defaults(&cfg);
+	}
+
+	capacity	= cfg.capacity;
+	memorySize	= capacity == 0x13 ? 0x80000UL : capacity == 0x12 ? 0x40000UL : capacity == 0x11 ? 0x20000UL :
+				  capacity == 0x10 ? 0x10000UL : capacity == 0x09 ? 0x8000UL : 1UL << capacity;
+	free(memory);
+	free(eraseCounts);
+	memory		= malloc(memorySize);
+	eraseCounts	= calloc(memorySize >> 12, sizeof(uint32_t));
+	memset(memory, 0xFF, memorySize);
+	memset(infoRows, 0xFF, sizeof(infoRows));
+
+	stats			= (IS25sim_stats){0};
+	now				= 0;
+	status			= 0;
+	function		= cfg.tbs ? SIM_FR_TBS : 0;
+	busy			= BUSY_NONE;
+	suspended		= 0;
+	unlockedSector	= -1;
+	resetEnabled	= 0;
+	powerDown		= 0;
+	powerFailIn		= 0;
+	powerFailed		= 0;
+	latchedValid	= 0;
+	event			= EVENT_NONE;
+	dwt				= (DWT_Type){0};
+	coreDebug		= (CoreDebug_Type){0};
+
+	IS25sim_unlock();
+}
+
+/**
+ * IS25sim_handle(uint32_t prescaler)
+ *
+ * @return
+ * 		QSPI_HandleTypeDef *	- the simulated peripheral with the given prescaler, pass it to IS25mem_Init
+ */
+QSPI_HandleTypeDef *IS25sim_handle(uint32_t prescaler){
+	handle					= (QSPI_HandleTypeDef){0};
+	handle.Instance				= &quadspi;
+	handle.Init.ClockPrescaler	= prescaler;
+	quadspi.CR					= prescaler << QUADSPI_CR_PRESCALER_Pos;
+	quadspi.SR					= 0;
+	return &handle;
+}
+
+uint8_t *IS25sim_memory(void){
+	return memory;
+}
+
+uint32_t IS25sim_size(void){
+	return memorySize;
+}
+
+uint32_t IS25sim_eraseCount(uint32_t sector){
+	return sector < (memorySize >> 12) ? eraseCounts[sector] : 0;
+}
+
+uint64_t IS25sim_nowNs(void){
+	return now;
+}
+
+/**
+ * IS25sim_advanceNs(uint64_t ns)
+ *
+ * @Brief
+ * 		Simulated CPU work of the caller.
+ */
+void IS25sim_advanceNs(uint64_t ns){
+	IS25sim_lock();
+	IS25sim_advance(ns);
+	IS25sim_unlock();
+}
+
+void IS25sim_getStats(IS25sim_stats *out){
+	IS25sim_lock();
+	*out = stats;
+	IS25sim_unlock();
+}
+
+void IS25sim_resetStats(void){
+	IS25sim_lock();
+	stats = (IS25sim_stats){0};
+	IS25sim_unlock();
+}
+
+/**
+ * IS25sim_powerFail(uint32_t writes)
+ *
+ * @Brief
+ * 		The power fails at the writes-th program / erase / register write from now on: that command has no effect and
+ * 		every HAL call returns HAL_ERROR until IS25sim_powerOn. 0 disarms.
+ */
+void IS25sim_powerFail(uint32_t writes){
+	IS25sim_lock();
+	powerFailIn = writes;
+	IS25sim_unlock();
+}
+
+uint8_t IS25sim_powerFailed(void){
+	return powerFailed;
+}
+
+/**
+ * IS25sim_powerOn(void)
+ *
+ * @Brief
+ * 		Power cycle: volatile state (WEL, suspend, sector unlock, pending transfers) is lost, the array is kept.
+ */
+void IS25sim_powerOn(void){
+	IS25sim_lock();
+	powerFailed		= 0;
+	powerFailIn		= 0;
+	busy			= BUSY_NONE;
+	suspended		= 0;
+	status		   &= (uint8_t)~SIM_WEL;
+	function	   &= (uint8_t)~(SIM_FR_ESUS | SIM_FR_PSUS);
+	unlockedSector	= -1;
+	latchedValid	= 0;
+	event			= EVENT_NONE;
+	IS25sim_unlock();
+}
+
+/**
+ * HAL_QSPI_xxx
+ *
+ * @Brief
+ * 		The blocking calls return HAL_BUSY while an interrupt driven transfer is running, like the HAL state check.
+ */
+static HAL_StatusTypeDef IS25sim_enter(void){
+	IS25sim_lock();
+	IS25sim_advance(cfg.callNs);
+	if(powerFailed){
+		IS25sim_unlock();
+		return HAL_ERROR;
+	}
+	if(event != EVENT_NONE){
+		stats.halBusy++;
+		IS25sim_unlock();
+		return HAL_BUSY;
+	}
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef IS25sim_leave(HAL_StatusTypeDef result){
+	IS25sim_unlock();
+	return result;
+}
+
+static void IS25sim_schedule(sim_event ev, uint64_t at){
+	event	= ev;
+	eventAt	= at;
+	pthread_cond_broadcast(&eventCond);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi){
+	if(hqspi != &handle){
+		return HAL_ERROR;
+	}
+	IS25sim_lock();
+	stats.inits++;
+	if(maskDepth != 0){
+		stats.maskedInits++;
+	}
+	MODIFY_REG(quadspi.CR, QUADSPI_CR_PRESCALER | QUADSPI_CR_SSHIFT,
+			(hqspi->Init.ClockPrescaler << QUADSPI_CR_PRESCALER_Pos) | hqspi->Init.SampleShifting);
+	IS25sim_advance(2000);
+	IS25sim_unlock();
+	return HAL_OK;
+}
+
+/**
+ * IS25sim_command(QSPI_CommandTypeDef *cmd, uint8_t it)
+ *
+ * @Brief
+ * 		Commands with a data phase are latched until the transfer, the others execute right away.
+ */
+static HAL_StatusTypeDef IS25sim_command(QSPI_CommandTypeDef *cmd, uint8_t it){
+	HAL_StatusTypeDef result = IS25sim_enter();
+	uint64_t ns;
+
+	if(result != HAL_OK){
+		return result;
+	}
+	if(cmd->DataMode != QSPI_DATA_NONE){
+		if(cmd->NbData == 0){
+			stats.lengthErrors++;
+			return IS25sim_leave(HAL_ERROR);
+		}
+		latched			= *cmd;
+		latchedValid	= 1;
+		return IS25sim_leave(HAL_OK);
+	}
+
+	ns			= IS25sim_bus(cmd, 0);
+	commandEnd	= now + ns;
+	result		= IS25sim_execute(cmd, 0, 0);
+	if(result == HAL_OK && it){
+		IS25sim_schedule(EVENT_CMD, now + ns);
+	}else{
+		IS25sim_advance(ns);
+	}
+	return IS25sim_leave(result);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t Timeout){
+	(void)hqspi;
+	(void)Timeout;
+	return IS25sim_command(cmd, 0);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Command_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd){
+	(void)hqspi;
+	return IS25sim_command(cmd, 1);
+}
+
+/**
+ * IS25sim_transfer(uint8_t *data, sim_event it)
+ *
+ * @Brief
+ * 		Data phase of the latched command, blocking (EVENT_NONE) or completed by an interrupt.
+ */
+static HAL_StatusTypeDef IS25sim_transfer(uint8_t *data, sim_event it){
+	HAL_StatusTypeDef result = IS25sim_enter();
+	uint64_t ns;
+
+	if(result != HAL_OK){
+		return result;
+	}
+	if(!latchedValid){
+		return IS25sim_leave(HAL_ERROR);
+	}
+
+	latchedValid	= 0;
+	ns				= IS25sim_bus(&latched, latched.NbData);
+	commandEnd		= now + ns;
+	result			= IS25sim_execute(&latched, data, latched.NbData);
+	if(result == HAL_OK && it != EVENT_NONE){
+		IS25sim_schedule(it, now + ns);
+	}else{
+		IS25sim_advance(ns);
+	}
+	return IS25sim_leave(result);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout){
+	(void)hqspi;
+	(void)Timeout;
+	return IS25sim_transfer(pData, EVENT_NONE);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout){
+	(void)hqspi;
+	(void)Timeout;
+	return IS25sim_transfer(pData, EVENT_NONE);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Transmit_IT(QSPI_HandleTypeDef *hqspi, uint8_t *pData){
+	(void)hqspi;
+	return IS25sim_transfer(pData, EVENT_TX);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Receive_IT(QSPI_HandleTypeDef *hqspi, uint8_t *pData){
+	(void)hqspi;
+	return IS25sim_transfer(pData, EVENT_RX);
+}
+
+/**
+ * IS25sim_matchAt(const QSPI_CommandTypeDef *cmd, const QSPI_AutoPollingTypeDef *poll, uint64_t *at)
+ *
+ * @return
+ * 		uint8_t		- "0" if the status will never match without another command
+ */
+static uint8_t IS25sim_matchAt(const QSPI_CommandTypeDef *cmd, const QSPI_AutoPollingTypeDef *poll, uint64_t *at){
+	uint64_t readNs = IS25sim_bus(cmd, 1);
+	uint8_t value	= IS25sim_status();
+
+	stats.commands++;
+	if((value & poll->Mask) == poll->Match){
+		*at = now + readNs;
+		return 1;
+	}
+	if(value & SIM_WIP){
+		value = (uint8_t)(value & ~(SIM_WIP | (suspended ? 0 : SIM_WEL)));
+		if((value & poll->Mask) == poll->Match){
+			*at = busyUntil + readNs;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+HAL_StatusTypeDef HAL_QSPI_AutoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *poll, uint32_t Timeout){
+	HAL_StatusTypeDef result = IS25sim_enter();
+	uint64_t limit	= now + (uint64_t)Timeout * 1000000ULL;
+	uint64_t at;
+
+	(void)hqspi;
+	if(result != HAL_OK){
+		return result;
+	}
+	if(!IS25sim_matchAt(cmd, poll, &at) || at > limit){
+		IS25sim_advance(limit - now);
+		return IS25sim_leave(HAL_TIMEOUT);
+	}
+	IS25sim_advance(at - now);
+	IS25sim_settle();
+	return IS25sim_leave(HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_QSPI_AutoPolling_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *poll){
+	HAL_StatusTypeDef result = IS25sim_enter();
+	uint64_t at;
+
+	(void)hqspi;
+	if(result != HAL_OK){
+		return result;
+	}
+	if(!IS25sim_matchAt(cmd, poll, &at)){
+		return IS25sim_leave(HAL_ERROR);
+	}
+	IS25sim_schedule(EVENT_MATCH, at);
+	return IS25sim_leave(HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	IS25sim_lock();
+	event			= EVENT_NONE;
+	latchedValid	= 0;
+	IS25sim_advance(cfg.callNs);
+	IS25sim_unlock();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_QSPI_Abort_IT(QSPI_HandleTypeDef *hqspi){
+	return HAL_QSPI_Abort(hqspi);
+}
+
+uint32_t HAL_GetTick(void){
+	return (uint32_t)(now / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay){
+	IS25sim_advanceNs((uint64_t)Delay * 1000000ULL);
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void){
+	return cfg.hclkHz;
+}
+
+//PRIMASK, masks the simulated interrupt source
+uint32_t __get_PRIMASK(void){
+	pthread_once(&lockOnce, IS25sim_initLocks);
+	pthread_mutex_lock(&irqLock);
+	maskDepth++;
+	return 0;
+}
+
+void __set_PRIMASK(uint32_t priMask){
+	(void)priMask;
+	maskDepth--;
+	pthread_mutex_unlock(&irqLock);
+}
+
+void __disable_irq(void){
+}
+
+/**
+ * IS25sim_irqMasked(void)
+ *
+ * @return
+ * 		uint8_t		- "1" if the caller runs with masked interrupts or inside the simulated interrupt handler
+ */
+uint8_t IS25sim_irqMasked(void){
+	return maskDepth != 0;
+}
+
+/**
+ * IS25sim_irqPending(void)
+ *
+ * @return
+ * 		uint8_t		- "1" if an interrupt driven transfer is running
+ */
+uint8_t IS25sim_irqPending(void){
+	return event != EVENT_NONE;
+}
+
+/**
+ * IS25sim_irq(void)
+ *
+ * @Brief
+ * 		Completes the running interrupt driven transfer: the time moves to its end and the matching
+ * 		HAL_QSPI_xxxCallback is called with the interrupts masked, like from the QUADSPI interrupt handler.
+ *
+ * @return
+ * 		uint8_t		- "0" if nothing was pending
+ */
+uint8_t IS25sim_irq(void){
+	sim_event ev;
+
+	pthread_once(&lockOnce, IS25sim_initLocks);
+	pthread_mutex_lock(&irqLock);
+	maskDepth++;
+	IS25sim_lock();
+	ev = event;
+	if(ev != EVENT_NONE){
+		if(eventAt > now){
+			IS25sim_advance(eventAt - now);
+		}
+		IS25sim_settle();
+		event = EVENT_NONE;
+	}
+	IS25sim_unlock();
+
+	switch(ev){
+		case EVENT_CMD:		HAL_QSPI_CmdCpltCallback(&handle);		break;
+		case EVENT_TX:		HAL_QSPI_TxCpltCallback(&handle);		break;
+		case EVENT_RX:		HAL_QSPI_RxCpltCallback(&handle);		break;
+		case EVENT_MATCH:	HAL_QSPI_StatusMatchCallback(&handle);	break;
+		default:			break;
+	}
+	maskDepth--;
+	pthread_mutex_unlock(&irqLock);
+
+	return ev != EVENT_NONE;
+}
+
+/**
+ * IS25sim_irqAll(void)
+ *
+ * @Brief
+ * 		Single threaded tests: delivers interrupts until nothing is running any more.
+ */
+void IS25sim_irqAll(void){
+	while(IS25sim_irq()){
+	}
+}
+
+static void *IS25sim_irqLoop(void *arg){
+	(void)arg;
+	for(;;){
+		IS25sim_lock();
+		while(event == EVENT_NONE && irqRunning){
+			pthread_cond_wait(&eventCond, &simLock);
+		}
+		IS25sim_unlock();
+		if(!irqRunning){
+			return 0;
+		}
+		IS25sim_irq();
+	}
+}
+
+/**
+ * IS25sim_irqThread(uint8_t run)
+ *
+ * @Brief
+ * 		Starts / stops a thread which delivers the interrupts as soon as they are pending, for tests with tasks.
+ */
+void IS25sim_irqThread(uint8_t run){
+	if(run && !irqRunning){
+		irqRunning = 1;
+		pthread_create(&irqThread, 0, IS25sim_irqLoop, 0);
+	}else if(!run && irqRunning){
+		IS25sim_lock();
+		irqRunning = 0;
+		pthread_cond_broadcast(&eventCond);
+		IS25sim_unlock();
+		pthread_join(irqThread, 0);
+	}
+}
+
+/**
+ * HAL_QSPI_xxxCallback
+ *
+ * @Brief
+ * 		Routing of the README: request queue first, then the legacy auto polling callback of the erase functions.
+ */
+void HAL_QSPI_StatusMatchCallback(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	if(IS25async_statusMatchCallback()){
+		return;
+	}
+	if(autoPollingCallback != 0){
+		void (*callback)(void) = autoPollingCallback;
+
+		autoPollingCallback = 0;
+		callback();
+	}
+}
+
+void HAL_QSPI_CmdCpltCallback(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	IS25async_cmdCpltCallback();
+}
+
+void HAL_QSPI_TxCpltCallback(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	IS25async_txCpltCallback();
+}
+
+void HAL_QSPI_RxCpltCallback(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	IS25async_rxCpltCallback();
+}
+
+void HAL_QSPI_ErrorCallback(QSPI_HandleTypeDef *hqspi){
+	(void)hqspi;
+	IS25async_errorCallback();
+}
@@ -0,0 +1,85 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Host model of the QSPI peripheral and an IS25LQ / IS25LP flash
+ *
+ *      Implements the HAL_QSPI functions on a RAM array with simulated time, so the driver and its modules run
+ *      unchanged on a host. Every command takes its bus cycles at the current QSPI clock, programs, erases and
+ *      register writes keep WIP set for their typical time. Interrupt driven calls complete through
+ *      IS25sim_irq, which calls the HAL_QSPI_xxxCallback like the QUADSPI interrupt handler, either from the test
+ *      itself or from the interrupt thread of IS25sim_irqThread. Protocol errors of the driver (commands while
+ *      busy, clock above the instruction maximum, data phase without length) are counted, not hidden.
+ *
+ *      The block protection map is the one assumed by is25lqxxxb_protect.c (BP = n protects 64 kByte << (n - 1)
+ *      from the top, from the bottom with TBS set), check the data sheet of the part before relying on it.
+ *
+ */
+
+#ifndef SIM_IS25SIM_H_
+#define SIM_IS25SIM_H_
+
+#include <stdint.h>
+#include "stm32l4xx_hal.h"
+
+typedef struct{
+	uint8_t		capacity;			// JEDEC capacity code, 0x13 = 512 kByte (IS25LQ040B), 0x19 = 32 MByte
+	uint32_t	hclkHz;				// HAL_RCC_GetHCLKFreq
+	uint32_t	callNs;				// CPU time of every HAL call
+	uint32_t	tppUs;				// Page program
+	uint32_t	tseUs;				// Sector erase
+	uint32_t	tbeUs;				// 32 / 64 kByte block erase
+	uint32_t	tceUs;				// Chip erase
+	uint32_t	twUs;				// Status / function register write
+	uint32_t	tsusUs;				// Suspend latency
+	uint32_t	maxReadHz;			// RD (03h / 13h)
+	uint32_t	maxFastHz;			// All other instructions
+	uint8_t		tbs;				// Function register TBS, "1" protects from address 0
+}IS25sim_config;
+
+typedef struct{
+	uint32_t	commands;
+	uint32_t	pagePrograms;
+	uint32_t	programBytes;
+	uint32_t	sectorErases;
+	uint32_t	blockErases;
+	uint32_t	chipErases;
+	uint32_t	statusWrites;
+	uint32_t	reads;
+	uint32_t	readBytes;
+	uint32_t	inits;				// HAL_QSPI_Init calls
+	uint32_t	maskedInits;		// HAL_QSPI_Init calls with the interrupts masked, its HAL_GetTick timeout can not run
+	uint32_t	suspends;
+	uint32_t	resumes;
+	uint32_t	ignored;			// Program / erase / write rejected by WEL or block protection
+	uint32_t	busyViolations;		// Commands sent while WIP was set (RDSR, PERSUS and RDFR excepted)
+	uint32_t	suspendViolations;	// Reads of the suspended erase range, writes while suspended
+	uint32_t	clockViolations;	// Instruction above its maximum SCLK
+	uint32_t	lengthErrors;		// Data phase with NbData 0
+	uint32_t	halBusy;			// Blocking calls while an interrupt driven transfer was running
+	uint64_t	busNs;				// Time the bus was driven
+}IS25sim_stats;
+
+
+//External function declaration
+
+extern void IS25sim_defaults(IS25sim_config *cfg);
+extern void IS25sim_init(const IS25sim_config *cfg);
+extern QSPI_HandleTypeDef *IS25sim_handle(uint32_t prescaler);
+extern uint8_t *IS25sim_memory(void);
+extern uint32_t IS25sim_size(void);
+extern uint32_t IS25sim_eraseCount(uint32_t sector);
+extern uint64_t IS25sim_nowNs(void);
+extern void IS25sim_advanceNs(uint64_t ns);
+extern void IS25sim_getStats(IS25sim_stats *stats);
+extern void IS25sim_resetStats(void);
+extern void IS25sim_powerFail(uint32_t writes);
+extern uint8_t IS25sim_powerFailed(void);
+extern void IS25sim_powerOn(void);
+
+extern uint8_t IS25sim_irqMasked(void);
+extern uint8_t IS25sim_irqPending(void);
+extern uint8_t IS25sim_irq(void);
+extern void IS25sim_irqAll(void);
+extern void IS25sim_irqThread(uint8_t run);
+
+#endif /* SIM_IS25SIM_H_ */
@@ -0,0 +1,57 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      pthread wait objects for the IS25sched_osHooks of the simulator tests
+ *
+ */
+
+#ifndef SIM_SIMOS_H_
+#define SIM_SIMOS_H_
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "is25lqxxxb_sched.h"
+
+typedef struct{
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	uint8_t			released;
+}pthreadWait;
+
+static void *waitCreate(void){
+	pthreadWait *wait = calloc(1, sizeof(pthreadWait));
+
+	pthread_mutex_init(&wait->lock, 0);
+	pthread_cond_init(&wait->cond, 0);
+	return wait;
+}
+
+static void waitDelete(void *wait){
+	pthread_mutex_destroy(&((pthreadWait *)wait)->lock);
+	pthread_cond_destroy(&((pthreadWait *)wait)->cond);
+	free(wait);
+}
+
+static void waitBlock(void *arg){
+	pthreadWait *wait = arg;
+
+	pthread_mutex_lock(&wait->lock);
+	while(!wait->released){
+		pthread_cond_wait(&wait->cond, &wait->lock);
+	}
+	wait->released = 0;
+	pthread_mutex_unlock(&wait->lock);
+}
+
+static void waitRelease(void *arg){
+	pthreadWait *wait = arg;
+
+	pthread_mutex_lock(&wait->lock);
+	wait->released = 1;
+	pthread_cond_signal(&wait->cond);
+	pthread_mutex_unlock(&wait->lock);
+}
+
+static const IS25sched_osHooks hooks = {waitCreate, waitDelete, waitBlock, waitRelease};
+
+#endif /* SIM_SIMOS_H_ */
@@ -0,0 +1,27 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Minimal check macros of the simulator tests
+ *
+ */
+
+#ifndef SIM_SIMTEST_H_
+#define SIM_SIMTEST_H_
+
+#include <stdio.h>
+#include "is25sim.h"
+
+static int simtestFailed = 0;
+
+#define CHECK(cond)		do{ if(!(cond)){ printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); simtestFailed++; } }while(0)
+#define CHECK_EQ(a, b)	do{ long long a_ = (long long)(a), b_ = (long long)(b); if(a_ != b_){ \
+							printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #a, a_, b_); simtestFailed++; } }while(0)
+
+//Protocol errors of the driver which the model counted
+#define CHECK_CLEAN()	do{ IS25sim_stats s_; IS25sim_getStats(&s_); CHECK_EQ(s_.busyViolations, 0); CHECK_EQ(s_.suspendViolations, 0); \
+							CHECK_EQ(s_.clockViolations, 0); CHECK_EQ(s_.lengthErrors, 0); CHECK_EQ(s_.halBusy, 0); \
+							CHECK_EQ(s_.maskedInits, 0); }while(0)
+
+#define SIMTEST_RESULT()	(printf("%s\n", simtestFailed ? "FAILED" : "ok"), simtestFailed != 0)
+
+#endif /* SIM_SIMTEST_H_ */
@@ -0,0 +1,152 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Host stand-in for the parts of the STM32L4 HAL / CMSIS used by the driver. The QSPI functions are
+ *      implemented by the flash model in is25sim.c.
+ *
+ */
+
+#ifndef SIM_STM32L4XX_HAL_H_
+#define SIM_STM32L4XX_HAL_H_
+
+#include <stdint.h>
+
+typedef enum{
+	HAL_OK			= 0x00,
+	HAL_ERROR		= 0x01,
+	HAL_BUSY		= 0x02,
+	HAL_TIMEOUT		= 0x03
+}HAL_StatusTypeDef;
+
+typedef struct{
+	uint32_t	ClockPrescaler;
+	uint32_t	FifoThreshold;
+	uint32_t	SampleShifting;
+	uint32_t	FlashSize;
+	uint32_t	ChipSelectHighTime;
+	uint32_t	ClockMode;
+}QSPI_InitTypeDef;
+
+//Registers of the QUADSPI peripheral the driver writes directly
+typedef struct{
+	volatile uint32_t	CR;
+	volatile uint32_t	SR;
+}QUADSPI_TypeDef;
+
+typedef struct{
+	QUADSPI_TypeDef		*Instance;
+	QSPI_InitTypeDef	Init;
+}QSPI_HandleTypeDef;
+
+typedef struct{
+	uint32_t	Instruction;
+	uint32_t	Address;
+	uint32_t	AlternateBytes;
+	uint32_t	AddressSize;
+	uint32_t	AlternateBytesSize;
+	uint32_t	DummyCycles;
+	uint32_t	InstructionMode;
+	uint32_t	AddressMode;
+	uint32_t	AlternateByteMode;
+	uint32_t	DataMode;
+	uint32_t	NbData;
+	uint32_t	DdrMode;
+	uint32_t	DdrHoldHalfCycle;
+	uint32_t	SIOOMode;
+}QSPI_CommandTypeDef;
+
+typedef struct{
+	uint32_t	Match;
+	uint32_t	Mask;
+	uint32_t	Interval;
+	uint32_t	StatusBytesSize;
+	uint32_t	MatchMode;
+	uint32_t	AutomaticStop;
+}QSPI_AutoPollingTypeDef;
+
+//Line counts are encoded as 0 (none), 1, 2, 3 (four lines) like the QUADSPI CCR fields
+#define QSPI_INSTRUCTION_NONE			0
+#define QSPI_INSTRUCTION_1_LINE			1
+#define QSPI_INSTRUCTION_2_LINES		2
+#define QSPI_INSTRUCTION_4_LINES		3
+#define QSPI_ADDRESS_NONE				0
+#define QSPI_ADDRESS_1_LINE				1
+#define QSPI_ADDRESS_2_LINES			2
+#define QSPI_ADDRESS_4_LINES			3
+#define QSPI_ADDRESS_8_BITS				0
+#define QSPI_ADDRESS_16_BITS			1
+#define QSPI_ADDRESS_24_BITS			2
+#define QSPI_ADDRESS_32_BITS			3
+#define QSPI_ALTERNATE_BYTES_NONE		0
+#define QSPI_ALTERNATE_BYTES_1_LINE		1
+#define QSPI_ALTERNATE_BYTES_2_LINES	2
+#define QSPI_ALTERNATE_BYTES_4_LINES	3
+#define QSPI_ALTERNATE_BYTES_8_BITS		0
+#define QSPI_DATA_NONE					0
+#define QSPI_DATA_1_LINE				1
+#define QSPI_DATA_2_LINES				2
+#define QSPI_DATA_4_LINES				3
+#define QSPI_DDR_MODE_DISABLE			0
+#define QSPI_DDR_HHC_ANALOG_DELAY		0
+#define QSPI_SIOO_INST_EVERY_CMD		0
+#define QSPI_MATCH_MODE_AND				0
+#define QSPI_MATCH_MODE_OR				1
+#define QSPI_AUTOMATIC_STOP_DISABLE		0
+#define QSPI_AUTOMATIC_STOP_ENABLE		1
+#define QSPI_SAMPLE_SHIFTING_NONE		0
+#define QSPI_SAMPLE_SHIFTING_HALFCYCLE	QUADSPI_CR_SSHIFT
+
+#define QUADSPI_CR_ABORT				(1UL << 1)
+#define QUADSPI_CR_SSHIFT				(1UL << 4)
+#define QUADSPI_CR_PRESCALER_Pos		24
+#define QUADSPI_CR_PRESCALER			(0xFFUL << QUADSPI_CR_PRESCALER_Pos)
+#define QUADSPI_SR_BUSY					(1UL << 5)
+
+#define SET_BIT(REG, BIT)				((REG) |= (BIT))
+#define READ_BIT(REG, BIT)				((REG) & (BIT))
+#define MODIFY_REG(REG, CLEAR, SET)		((REG) = (((REG) & ~(CLEAR)) | (SET)))
+
+HAL_StatusTypeDef HAL_QSPI_Init(QSPI_HandleTypeDef *hqspi);
+HAL_StatusTypeDef HAL_QSPI_Command(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Command_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd);
+HAL_StatusTypeDef HAL_QSPI_Transmit(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Receive(QSPI_HandleTypeDef *hqspi, uint8_t *pData, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_Transmit_IT(QSPI_HandleTypeDef *hqspi, uint8_t *pData);
+HAL_StatusTypeDef HAL_QSPI_Receive_IT(QSPI_HandleTypeDef *hqspi, uint8_t *pData);
+HAL_StatusTypeDef HAL_QSPI_AutoPolling(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg, uint32_t Timeout);
+HAL_StatusTypeDef HAL_QSPI_AutoPolling_IT(QSPI_HandleTypeDef *hqspi, QSPI_CommandTypeDef *cmd, QSPI_AutoPollingTypeDef *cfg);
+HAL_StatusTypeDef HAL_QSPI_Abort(QSPI_HandleTypeDef *hqspi);
+HAL_StatusTypeDef HAL_QSPI_Abort_IT(QSPI_HandleTypeDef *hqspi);
+
+void HAL_QSPI_CmdCpltCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_TxCpltCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_RxCpltCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_StatusMatchCallback(QSPI_HandleTypeDef *hqspi);
+void HAL_QSPI_ErrorCallback(QSPI_HandleTypeDef *hqspi);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+
+//Interrupt mask, a recursive lock shared with the simulated interrupt source
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+
+//Cycle counter, runs on the simulated time once enabled like on the target
+typedef struct{
+	volatile uint32_t	CTRL;
+	volatile uint32_t	CYCCNT;
+}DWT_Type;
+
+typedef struct{
+	volatile uint32_t	DEMCR;
+}CoreDebug_Type;
+
+extern DWT_Type			*const DWT;
+extern CoreDebug_Type	*const CoreDebug;
+
+#define CoreDebug_DEMCR_TRCENA_Msk		(1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk			(1UL << 0)
+
+#endif /* SIM_STM32L4XX_HAL_H_ */
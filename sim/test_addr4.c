@@ -0,0 +1,82 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      32 MByte part on the simulated flash, driver built with IS25_TRACE: IS25mem_Init selects the 4 byte address,
+ *      program, read and erase above 16 MByte use the 4 byte address opcodes and do not wrap to the lower half.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_trace.h"
+
+#define HIGH				0x1800100		// 24 MByte, 0x800100 with a 3 byte address
+#define ALIAS				(HIGH & 0xFFFFFF)
+
+static IS25trace_record		records[IS25TRACE_DEPTH];
+
+static uint32_t count(uint32_t n, uint8_t opcode, uint32_t address){
+	uint32_t found = 0;
+
+	for(uint32_t i = 0; i < n; i++){
+		if(IS25TRACE_KIND(records[i].info) == IS25_TRACE_CMD && records[i].opcode == opcode &&
+				records[i].address == address){
+			found++;
+		}
+	}
+	return found;
+}
+
+int main(void){
+	IS25sim_config cfg;
+	IS25trace_header header;
+	const IS25mem_MemorySpace *space;
+	mem_address address = {.val = HIGH};
+	uint8_t data[64];
+	uint8_t check[64];
+	uint32_t n;
+
+	IS25sim_defaults(&cfg);
+	cfg.capacity = 0x19;
+	IS25sim_init(&cfg);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(2)), MEMORY_OK);		// 26.7 MHz, RD4 is limited to 33 MHz
+	space = IS25mem_getMemorySpace();
+	CHECK_EQ(space->bytes, 0x2000000);
+	CHECK_EQ(space->sectors, 8192);
+	CHECK_EQ(space->addressBytes, 4);
+	memset(data, 0xA5, sizeof(data));
+	IS25trace_enable(1);
+
+	CHECK_EQ(IS25mem_programData(data, address, sizeof(data)), MEMORY_OK);
+	CHECK_EQ(IS25sim_memory()[HIGH], 0xA5);
+	CHECK_EQ(IS25sim_memory()[ALIAS], 0xFF);
+	CHECK_EQ(IS25mem_readData(check, address, sizeof(check)), MEMORY_OK);
+	CHECK(memcmp(check, data, sizeof(check)) == 0);
+	memset(check, 0, sizeof(check));
+	CHECK_EQ(IS25mem_readDataFast(check, address, sizeof(check)), MEMORY_OK);
+	CHECK(memcmp(check, data, sizeof(check)) == 0);
+
+	CHECK_EQ(IS25mem_sectorEraseWait(address), MEMORY_OK);
+	CHECK_EQ(IS25sim_memory()[HIGH], 0xFF);
+	CHECK_EQ(IS25sim_eraseCount(HIGH >> 12), 1);
+	CHECK_EQ(IS25sim_eraseCount(ALIAS >> 12), 0);
+	CHECK_EQ(IS25mem_blockEraseWait(address), MEMORY_OK);
+	CHECK_EQ(IS25sim_eraseCount(HIGH >> 12), 2);
+	CHECK_EQ(IS25sim_eraseCount(ALIAS >> 12), 0);
+
+	//SECUNLOCK has no 4 byte address variant
+	CHECK_EQ(IS25mem_sectorUnlock(address), MEMORY_WRONG_CPACITY_ERR);
+
+	IS25trace_enable(0);
+	n = IS25trace_export(&header, records, IS25TRACE_DEPTH);
+	CHECK_EQ(count(n, PP4, HIGH), 1);
+	CHECK_EQ(count(n, RD4, HIGH), 1);
+	CHECK_EQ(count(n, FR4, HIGH), 1);
+	CHECK_EQ(count(n, SER4, HIGH), 1);
+	CHECK_EQ(count(n, BER64_4, HIGH), 1);
+	CHECK_EQ(count(n, PP, HIGH) + count(n, RD, HIGH) + count(n, FR, HIGH) + count(n, SER, HIGH), 0);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
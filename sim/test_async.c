@@ -0,0 +1,175 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Request queue on the simulated flash: interrupt sequencing, request validation, callbacks of requests which
+ *      fail inside IS25async_submit and concurrent submitters with a threaded interrupt source.
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_async.h"
+
+#define TASK_REQUESTS		64
+
+static volatile int	doneCnt;
+static volatile int	errorCnt;
+static volatile int	maskedCnt;			// Callbacks called with masked interrupts outside the interrupt handler
+
+static void done(flash_err result, void *context){
+	(void)context;
+	if(result != MEMORY_OK){
+		errorCnt++;
+	}
+	doneCnt++;
+}
+
+static void failedDone(flash_err result, void *context){
+	(void)context;
+	//Called from IS25async_submit, the critical section must have been left
+	if(IS25sim_irqMasked()){
+		maskedCnt++;
+	}
+	if(result != MEMORY_OK){
+		errorCnt++;
+	}
+	doneCnt++;
+}
+
+static flash_err submitWait(const IS25async_request *req){
+	flash_err err;
+
+	while((err = IS25async_submit(req)) == MEMORY_BUSY){
+		sched_yield();
+	}
+	return err;
+}
+
+static void testSequence(void){
+	uint8_t data[600];
+	uint8_t back[600];
+	IS25async_request req;
+
+	for(uint32_t i = 0; i < sizeof(data); i++){
+		data[i] = (uint8_t)(i * 7 + 3);
+	}
+	doneCnt = errorCnt = 0;
+
+	req = (IS25async_request){.op = IS25_REQ_PROGRAM, .buffer = data, .size = 300, .callback = done};
+	req.address.val = 0x1F0;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	req = (IS25async_request){.op = IS25_REQ_READ, .buffer = back, .size = 300, .callback = done};
+	req.address.val = 0x1F0;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	CHECK_EQ(IS25async_pending(), 2);
+
+	IS25sim_irqAll();
+	CHECK_EQ(doneCnt, 2);
+	CHECK_EQ(errorCnt, 0);
+	CHECK(memcmp(back, data, 300) == 0);
+	CHECK(memcmp(IS25sim_memory() + 0x1F0, data, 300) == 0);
+
+	req = (IS25async_request){.op = IS25_REQ_SECTOR_ERASE, .callback = done};
+	req.address.val = 0x0000;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	IS25sim_irqAll();
+	CHECK_EQ(doneCnt, 3);
+	CHECK_EQ(IS25sim_memory()[0x1F0], 0xFF);
+	CHECK_EQ(IS25sim_memory()[0x31F], 0xFF);
+	CHECK_EQ(IS25sim_eraseCount(0), 1);
+	CHECK_EQ(IS25async_getState(), IS25_STATE_IDLE);
+}
+
+static void testValidation(void){
+	uint8_t buffer[4];
+	IS25async_request req;
+
+	req = (IS25async_request){.op = IS25_REQ_READ, .buffer = buffer, .size = 0};
+	CHECK_EQ(IS25async_submit(&req), MEMORY_ERROR);
+	req = (IS25async_request){.op = IS25_REQ_PROGRAM, .buffer = buffer, .size = 0};
+	CHECK_EQ(IS25async_submit(&req), MEMORY_ERROR);
+	req = (IS25async_request){.op = IS25_REQ_PROGRAM, .buffer = 0, .size = 4};
+	CHECK_EQ(IS25async_submit(&req), MEMORY_ERROR);
+	req = (IS25async_request){.op = (IS25async_op)9, .buffer = buffer, .size = 4};
+	CHECK_EQ(IS25async_submit(&req), MEMORY_ERROR);
+	CHECK_EQ(IS25async_pending(), 0);
+}
+
+static void testFailedStart(void){
+	uint8_t buffer[16];
+	IS25async_request req = {.op = IS25_REQ_READ, .buffer = buffer, .size = sizeof(buffer), .callback = failedDone};
+
+	doneCnt = errorCnt = maskedCnt = 0;
+
+	//Every HAL call fails from the next write on (the erase fails in the interrupt), the reads fail inside the submit
+	IS25sim_powerFail(1);
+	req.op			= IS25_REQ_SECTOR_ERASE;
+	req.callback	= done;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	IS25sim_irqAll();
+	req.op			= IS25_REQ_READ;
+	req.callback	= failedDone;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+
+	CHECK(IS25sim_powerFailed());
+	CHECK_EQ(doneCnt, 3);
+	CHECK_EQ(errorCnt, 3);
+	CHECK_EQ(maskedCnt, 0);
+	CHECK_EQ(IS25async_pending(), 0);
+	IS25sim_powerOn();
+}
+
+static uint8_t		taskPages[2][IS25_PAGE_SIZE];	// Must stay valid until the callbacks ran
+
+static void *task(void *arg){
+	uint32_t base	= (uint32_t)(uintptr_t)arg;
+	uint8_t *page	= taskPages[(base >> 16) - 1];
+	IS25async_request req = {.op = IS25_REQ_PROGRAM, .buffer = page, .size = IS25_PAGE_SIZE, .callback = done};
+
+	memset(page, (int)(base >> 16), IS25_PAGE_SIZE);
+	for(uint32_t i = 0; i < TASK_REQUESTS; i++){
+		req.address.val = base + i * IS25_PAGE_SIZE;
+		CHECK_EQ(submitWait(&req), MEMORY_OK);
+	}
+	return 0;
+}
+
+static void testThreads(void){
+	pthread_t tasks[2];
+
+	doneCnt = errorCnt = 0;
+	IS25sim_irqThread(1);
+	pthread_create(&tasks[0], 0, task, (void *)(uintptr_t)0x10000);
+	pthread_create(&tasks[1], 0, task, (void *)(uintptr_t)0x20000);
+	pthread_join(tasks[0], 0);
+	pthread_join(tasks[1], 0);
+	while(IS25async_pending() != 0){
+		sched_yield();
+	}
+	IS25sim_irqThread(0);
+
+	CHECK_EQ(doneCnt, 2 * TASK_REQUESTS);
+	CHECK_EQ(errorCnt, 0);
+	for(uint32_t i = 0; i < TASK_REQUESTS * IS25_PAGE_SIZE; i++){
+		if(IS25sim_memory()[0x10000 + i] != 0x01 || IS25sim_memory()[0x20000 + i] != 0x02){
+			CHECK(!"page content");
+			break;
+		}
+	}
+}
+
+int main(void){
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+
+	testSequence();
+	testValidation();
+	testThreads();
+	CHECK_CLEAN();
+	testFailedStart();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,100 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Boot parameters in an information row of the simulated flash: store and load, unchanged parameters are not
+ *      written again, a full row is erased and written from slot 0, an empty row does not load. Built twice: without
+ *      IS25BOOTP_ALLOW_LOCK there is no lock function at all, with it (test_bootp_lock) a wrong key is refused.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_bootp.h"
+
+#ifndef IS25BOOTP_ALLOW_LOCK
+extern flash_err IS25bootp_lock(uint32_t key) __attribute__((weak));
+#endif
+
+static void setParams(IS25bootp_params *params, uint32_t n){
+	memset(params, 0, sizeof(*params));
+	IS25mem_getReadConfig(&params->readConfig);
+	params->role = (uint8_t)(n & 0x0F);
+	for(uint32_t i = 0; i < IS25BOOTP_CALIB_WORDS; i++){
+		params->calibration[i] = n * 1000 + i;
+	}
+}
+
+int main(void){
+	IS25bootp_params params, back;
+	IS25sim_stats before, after;
+	uint8_t slot[32];
+	uint8_t locked;
+
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+
+	//Empty row
+	CHECK_EQ(IS25bootp_load(&back), MEMORY_ERROR);
+	CHECK_EQ(IS25bootp_isLocked(&locked), MEMORY_OK);
+	CHECK_EQ(locked, 0);
+#ifdef IS25BOOTP_ALLOW_LOCK
+	CHECK_EQ(IS25bootp_lock(IS25BOOTP_LOCK_KEY), MEMORY_ERROR);			// Nothing stored yet
+#endif
+
+	setParams(&params, 1);
+	CHECK_EQ(IS25bootp_store(&params), MEMORY_OK);
+	CHECK_EQ(IS25bootp_load(&back), MEMORY_OK);
+	CHECK(memcmp(&back, &params, sizeof(params)) == 0);
+
+	//Unchanged: one IRRD, nothing written
+	IS25sim_getStats(&before);
+	CHECK_EQ(IS25bootp_store(&params), MEMORY_OK);
+	IS25sim_getStats(&after);
+	CHECK_EQ(after.commands - before.commands, 1);
+	CHECK_EQ(IS25mem_readInfoRow(slot, IS25BOOTP_ROW, 32, sizeof(slot)), MEMORY_OK);
+	CHECK_EQ(slot[0], 0xFF);
+
+	//Fill all slots, the next store erases the row and starts at slot 0
+	for(uint32_t n = 2; n <= IS25BOOTP_SLOTS; n++){
+		setParams(&params, n);
+		CHECK_EQ(IS25bootp_store(&params), MEMORY_OK);
+	}
+	CHECK_EQ(IS25mem_readInfoRow(slot, IS25BOOTP_ROW, IS25_IR_SIZE - sizeof(slot), sizeof(slot)), MEMORY_OK);
+	CHECK(slot[0] != 0xFF);
+	CHECK_EQ(IS25bootp_load(&back), MEMORY_OK);
+	CHECK(memcmp(&back, &params, sizeof(params)) == 0);
+
+	setParams(&params, IS25BOOTP_SLOTS + 1);
+	CHECK_EQ(IS25bootp_store(&params), MEMORY_OK);
+	CHECK_EQ(IS25mem_readInfoRow(slot, IS25BOOTP_ROW, 32, sizeof(slot)), MEMORY_OK);
+	CHECK_EQ(slot[0], 0xFF);
+	CHECK_EQ(IS25mem_readInfoRow(slot, IS25BOOTP_ROW, IS25_IR_SIZE - sizeof(slot), sizeof(slot)), MEMORY_OK);
+	CHECK_EQ(slot[0], 0xFF);
+	CHECK_EQ(IS25bootp_load(&back), MEMORY_OK);
+	CHECK(memcmp(&back, &params, sizeof(params)) == 0);
+
+#ifdef IS25BOOTP_ALLOW_LOCK
+	//Wrong key: refused, the row stays writable
+	CHECK_EQ(IS25bootp_lock(0), MEMORY_ERROR);
+	CHECK_EQ(IS25bootp_lock(IS25BOOTP_LOCK_KEY ^ 1), MEMORY_ERROR);
+	CHECK_EQ(IS25bootp_isLocked(&locked), MEMORY_OK);
+	CHECK_EQ(locked, 0);
+
+	CHECK_EQ(IS25bootp_lock(IS25BOOTP_LOCK_KEY), MEMORY_OK);
+	CHECK_EQ(IS25bootp_isLocked(&locked), MEMORY_OK);
+	CHECK_EQ(locked, 1);
+	setParams(&back, 0);
+	CHECK_EQ(IS25bootp_store(&back), MEMORY_ERROR);
+	CHECK_EQ(IS25bootp_load(&back), MEMORY_OK);
+	CHECK(memcmp(&back, &params, sizeof(params)) == 0);
+#else
+	//The one time programmable lock is not even linked
+	CHECK(IS25bootp_lock == 0);
+	CHECK_EQ(IS25bootp_isLocked(&locked), MEMORY_OK);
+	CHECK_EQ(locked, 0);
+#endif
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,63 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Read calibration on the simulated flash: the calibrated clock is only used by the configured reads, RD,
+ *      program, erase and register commands keep the clock of IS25mem_Init.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_calib.h"
+
+#define BASE_PRESCALER		3			// 20 MHz, RD is limited to 33 MHz
+
+int main(void){
+	static uint8_t data[4096];
+	static uint8_t back[4096];
+	IS25mem_readConfig cfg;
+	IS25cal_report report;
+	extFlash_stat status;
+	mem_address address = {.val = 0x70000};
+
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(BASE_PRESCALER)), MEMORY_OK);
+
+	IS25mem_getReadConfig(&cfg);
+	CHECK_EQ(cfg.prescaler, BASE_PRESCALER);
+	CHECK_EQ(cfg.check, IS25mem_readConfigCheck(&cfg));
+
+	CHECK_EQ(IS25cal_run(address, &cfg, &report), MEMORY_OK);
+	printf("calibration: mode %u, %u dummy, prescaler %u, shift %u, %u ns -> %u ns\n", cfg.mode, cfg.dummyCycles,
+			cfg.prescaler, cfg.sampleShift, (unsigned)report.baselineNs, (unsigned)report.bestNs);
+	CHECK(cfg.prescaler < BASE_PRESCALER);
+	CHECK(report.bestNs < report.baselineNs);
+	CHECK_EQ(IS25mem_getQspiHandle()->Init.ClockPrescaler, BASE_PRESCALER);
+
+	//Program, RD and register commands after the calibration
+	for(uint32_t i = 0; i < sizeof(data); i++){
+		data[i] = (uint8_t)(i * 13 + 1);
+	}
+	address.val = 0x10000;
+	CHECK_EQ(IS25mem_sectorEraseWait(address), MEMORY_OK);
+	CHECK_EQ(IS25mem_programData(data, address, sizeof(data)), MEMORY_OK);
+	CHECK_EQ(IS25mem_readData(back, address, 256), MEMORY_OK);
+	CHECK(memcmp(back, data, 256) == 0);
+	CHECK_EQ(IS25mem_readStatusReg(&status), MEMORY_OK);
+	CHECK_EQ(IS25mem_readDataFast(back, address, sizeof(back)), MEMORY_OK);
+	CHECK(memcmp(back, data, sizeof(back)) == 0);
+	CHECK_EQ(IS25mem_getQspiHandle()->Init.ClockPrescaler, BASE_PRESCALER);
+
+	//Stored configuration on a later boot
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(BASE_PRESCALER)), MEMORY_OK);
+	CHECK_EQ(IS25mem_setReadConfig(&cfg), MEMORY_OK);
+	memset(back, 0, sizeof(back));
+	CHECK_EQ(IS25mem_readDataFast(back, address, sizeof(back)), MEMORY_OK);
+	CHECK(memcmp(back, data, sizeof(back)) == 0);
+	CHECK_EQ(IS25mem_readData(back, address, 256), MEMORY_OK);
+	CHECK(memcmp(back, data, 256) == 0);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
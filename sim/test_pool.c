@@ -0,0 +1,110 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Erase-ahead sector pool on the simulated flash: released sectors are erased in the background and handed out,
+ *      depth and backlog follow, an erase of the application between the background erases reaches its own callback
+ *      and does not hand out a zone a second time.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_pool.h"
+
+#define SECTOR_A			10
+#define SECTOR_B			11
+#define SECTOR_C			12
+#define APP_SECTOR			40
+
+static uint32_t		appErases;
+
+static void appEraseDone(void){
+	appErases++;
+}
+
+static void appErase(uint32_t sector){
+	mem_address address = {.sector = sector};
+
+	CHECK_EQ(IS25mem_writeEnable(), MEMORY_OK);
+	CHECK_EQ(IS25mem_sectorErase(address), MEMORY_OK);
+	IS25sim_irqAll();
+}
+
+int main(void){
+	IS25pool_metrics metrics;
+	uint32_t sector;
+
+	IS25sim_init(0);
+	memset(IS25sim_memory(), 0x00, IS25sim_size());
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	setEraseDoneCallbackFct(&appEraseDone);
+	CHECK_EQ(IS25pool_init(2), MEMORY_OK);
+	CHECK_EQ(IS25pool_zoneSectors(), 1);
+
+	CHECK_EQ(IS25pool_release(SECTOR_A), MEMORY_OK);
+	CHECK_EQ(IS25pool_release(SECTOR_B), MEMORY_OK);
+	CHECK_EQ(IS25pool_release(SECTOR_C), MEMORY_OK);
+	CHECK_EQ(IS25pool_release(SECTOR_A), MEMORY_ERROR);
+	CHECK_EQ(IS25pool_alloc(&sector), MEMORY_BUSY);
+	IS25pool_getMetrics(&metrics);
+	CHECK_EQ(metrics.poolDepth, 0);
+	CHECK_EQ(metrics.eraseBacklog, 3);
+
+	//First background erase
+	IS25pool_idle();
+	CHECK_EQ(IS25pool_busy(), 1);
+	IS25sim_irqAll();
+	CHECK_EQ(IS25pool_busy(), 0);
+	IS25pool_getMetrics(&metrics);
+	CHECK_EQ(metrics.poolDepth, 1);
+	CHECK_EQ(metrics.eraseBacklog, 2);
+	CHECK_EQ(appErases, 0);
+
+	//Erase of the application: its callback, no zone for the pool
+	appErase(APP_SECTOR);
+	CHECK_EQ(appErases, 1);
+	IS25pool_getMetrics(&metrics);
+	CHECK_EQ(metrics.poolDepth, 1);
+	CHECK_EQ(metrics.erasesDone, 1);
+
+	//Second background erase, then the target depth is reached
+	IS25pool_idle();
+	IS25sim_irqAll();
+	IS25pool_idle();
+	CHECK_EQ(IS25pool_busy(), 0);
+	IS25pool_getMetrics(&metrics);
+	CHECK_EQ(metrics.poolDepth, 2);
+	CHECK_EQ(metrics.eraseBacklog, 1);
+	CHECK_EQ(appErases, 1);
+
+	appErase(APP_SECTOR);
+	CHECK_EQ(appErases, 2);
+
+	CHECK_EQ(IS25pool_alloc(&sector), MEMORY_OK);
+	CHECK_EQ(sector, SECTOR_A);
+	CHECK_EQ(IS25sim_memory()[SECTOR_A * 4096], 0xFF);
+	CHECK_EQ(IS25pool_alloc(&sector), MEMORY_OK);
+	CHECK_EQ(sector, SECTOR_B);
+	CHECK_EQ(IS25sim_memory()[SECTOR_B * 4096 + 4095], 0xFF);
+	CHECK_EQ(IS25pool_alloc(&sector), MEMORY_BUSY);
+
+	//Below the target depth again, the last zone follows
+	IS25pool_idle();
+	IS25sim_irqAll();
+	CHECK_EQ(IS25pool_alloc(&sector), MEMORY_OK);
+	CHECK_EQ(sector, SECTOR_C);
+	CHECK_EQ(IS25sim_memory()[SECTOR_C * 4096], 0xFF);
+	IS25pool_getMetrics(&metrics);
+	CHECK_EQ(metrics.poolDepth, 0);
+	CHECK_EQ(metrics.eraseBacklog, 0);
+	CHECK_EQ(metrics.erasesDone, 3);
+	CHECK_EQ(metrics.allocHits, 3);
+	CHECK_EQ(metrics.allocMisses, 2);
+	CHECK_EQ(metrics.eraseErrors, 0);
+	CHECK_EQ(appErases, 2);
+	CHECK_EQ(IS25sim_eraseCount(APP_SECTOR), 2);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
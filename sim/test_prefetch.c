@@ -0,0 +1,128 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Read-ahead on the simulated flash: streamed reads through the scheduler, invalidation by programs and
+ *      erases of the driver and the scheduler, prefetches with the active read configuration.
+ *
+ */
+
+#include <sched.h>
+#include <string.h>
+#include "simtest.h"
+#include "simos.h"
+#include "is25lqxxxb_prefetch.h"
+
+#define BASE_PRESCALER		3
+#define STREAM				0x20000
+#define STREAM_SIZE			0x4000
+#define CHUNK				64
+
+static uint8_t expected(uint32_t address){
+	return (uint8_t)(address * 7 + (address >> 8));
+}
+
+static void testStream(void){
+	uint8_t chunk[CHUNK];
+	IS25pf_stats stats;
+	mem_address address;
+
+	for(uint32_t i = 0; i < STREAM_SIZE; i++){
+		IS25sim_memory()[STREAM + i] = expected(STREAM + i);
+	}
+
+	for(uint32_t offset = 0; offset < STREAM_SIZE; offset += CHUNK){
+		address.val = STREAM + offset;
+		CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+		for(uint32_t i = 0; i < CHUNK; i++){
+			if(chunk[i] != expected(address.val + i)){
+				CHECK(!"stream content");
+				return;
+			}
+		}
+	}
+
+	IS25pf_getStats(&stats);
+	printf("stream: %u reads, %u hits, %u late hits, %u misses, %u prefetches\n", (unsigned)stats.reads,
+			(unsigned)stats.hits, (unsigned)stats.lateHits, (unsigned)stats.misses, (unsigned)stats.prefetches);
+	CHECK(stats.hits + stats.lateHits > stats.reads * 3 / 4);
+}
+
+static void testInvalidate(void){
+	uint8_t chunk[CHUNK];
+	uint8_t zero[CHUNK];
+	mem_address address = {.val = STREAM};
+
+	memset(zero, 0x00, sizeof(zero));
+	IS25pf_init(&hooks);
+
+	//Start a stream, the next window is buffered
+	CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+	address.val += CHUNK;
+	CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+
+	//Blocking program of the driver inside the buffered window, once the prefetch left the bus
+	while(IS25async_pending() != 0){
+		sched_yield();
+	}
+	address.val = STREAM + 2 * CHUNK;
+	CHECK_EQ(IS25mem_programData(zero, address, CHUNK), MEMORY_OK);
+	CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+	CHECK(memcmp(chunk, zero, CHUNK) == 0);
+
+	//Erase through the scheduler (request queue, interrupt context)
+	address.val = STREAM + 3 * CHUNK;
+	CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+	address.val = STREAM;
+	CHECK_EQ(IS25sched_erase(IS25_REQ_SECTOR_ERASE, address), MEMORY_OK);
+	address.val = STREAM + 4 * CHUNK;
+	CHECK_EQ(IS25pf_read(chunk, address, CHUNK), MEMORY_OK);
+	CHECK_EQ(chunk[0], 0xFF);
+	CHECK_EQ(chunk[CHUNK - 1], 0xFF);
+}
+
+static void testReadConfig(void){
+	IS25mem_readConfig cfg = {IS25_READCFG_MAGIC, IS25_READ_1_4_4, 4, 0, 1, 0, 0};
+	uint8_t buffer[2048];
+	mem_address address = {.val = STREAM + 0x1000};
+	IS25sim_stats before, after;
+
+	//Blocking driver calls need the bus, wait for the read-ahead of the last stream
+	while(IS25async_pending() != 0){
+		sched_yield();
+	}
+	cfg.check = IS25mem_readConfigCheck(&cfg);
+	CHECK_EQ(IS25mem_setReadConfig(&cfg), MEMORY_OK);
+
+	//2 kByte at 20 MHz on one line take 820 us, with 1-4-4 at 80 MHz about 55 us
+	IS25sim_getStats(&before);
+	CHECK_EQ(IS25sched_read(buffer, address, sizeof(buffer)), MEMORY_OK);
+	IS25sim_getStats(&after);
+	CHECK(after.busNs - before.busNs < 100000ULL);
+	CHECK_EQ(IS25mem_getQspiHandle()->Init.ClockPrescaler, BASE_PRESCALER);
+	//Clock switched in the request queue by the CR register, not by HAL_QSPI_Init
+	CHECK_EQ(IS25mem_getQspiHandle()->Instance->CR >> QUADSPI_CR_PRESCALER_Pos, BASE_PRESCALER);
+	CHECK_EQ(after.inits, before.inits);
+	for(uint32_t i = 0; i < sizeof(buffer); i++){
+		if(buffer[i] != expected(address.val + i)){
+			CHECK(!"configured read content");
+			break;
+		}
+	}
+}
+
+int main(void){
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(BASE_PRESCALER)), MEMORY_OK);
+	CHECK_EQ(IS25sched_init(&hooks), MEMORY_OK);
+	CHECK_EQ(IS25pf_init(&hooks), MEMORY_OK);
+	IS25sim_irqThread(1);
+
+	testStream();
+	testInvalidate();
+	testReadConfig();
+
+	IS25sim_irqThread(0);
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
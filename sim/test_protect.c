@@ -0,0 +1,91 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Block protection on the simulated flash, part configured with TBS (protection from address 0): the planner
+ *      takes the protected area from the function register, programs (also single page programs) and erases of the
+ *      driver and the request queue into it are rejected before anything is sent, batches write it with SECUNLOCK or
+ *      one WRSR pair.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_async.h"
+#include "is25lqxxxb_protect.h"
+
+#define PROTECTED			0x1000			// Inside the lower 64 kByte
+#define UNPROTECTED			0x70000			// Upper block, protected without TBS
+
+int main(void){
+	IS25sim_config cfg;
+	IS25sim_stats before, after;
+	IS25prot_stats stats;
+	IS25async_request req = {.op = IS25_REQ_PROGRAM, .size = 16};
+	mem_address address = {.val = PROTECTED};
+	uint8_t data[16];
+	uint32_t start, size;
+
+	IS25sim_defaults(&cfg);
+	cfg.tbs = 1;
+	IS25sim_init(&cfg);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK_EQ(IS25prot_init(), MEMORY_OK);
+	CHECK_EQ(IS25prot_setProtection(1), MEMORY_OK);
+	IS25prot_getRange(&start, &size);
+	CHECK_EQ(start, 0);
+	CHECK_EQ(size, 0x10000);
+	memset(data, 0x5A, sizeof(data));
+
+	//Rejected without a command on the bus
+	IS25sim_getStats(&before);
+	CHECK_EQ(IS25mem_programData(data, address, sizeof(data)), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(IS25mem_pageProgramm(data, address, sizeof(data)), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(IS25mem_quadPageProgramm(data, address, sizeof(data)), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(IS25mem_sectorEraseWait(address), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(IS25mem_sectorErase(address), MEMORY_PROTECTED_ERR);
+	address.val = 0;
+	CHECK_EQ(IS25mem_blockEraseWait(address), MEMORY_PROTECTED_ERR);
+	CHECK_EQ(IS25mem_chipEraseWait(), MEMORY_PROTECTED_ERR);
+	req.buffer		= data;
+	req.address.val	= PROTECTED;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_PROTECTED_ERR);
+	req.op = IS25_REQ_CHIP_ERASE;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_PROTECTED_ERR);
+	IS25sim_getStats(&after);
+	CHECK_EQ(after.commands, before.commands);
+
+	//Outside of the protected area
+	address.val = UNPROTECTED;
+	CHECK_EQ(IS25mem_programData(data, address, sizeof(data)), MEMORY_OK);
+	CHECK_EQ(IS25sim_memory()[UNPROTECTED], 0x5A);
+
+	//Batch inside one sector: SECUNLOCK, the driver check lets the unlocked sector through
+	address.val = PROTECTED;
+	IS25prot_begin();
+	CHECK_EQ(IS25prot_addErase(IS25_PROT_SECTOR_ERASE, address), MEMORY_OK);
+	CHECK_EQ(IS25prot_addProgram(data, address, sizeof(data)), MEMORY_OK);
+	CHECK_EQ(IS25prot_execute(1), MEMORY_OK);
+	CHECK_EQ(IS25sim_memory()[PROTECTED], 0x5A);
+
+	//Batch over two sectors: one WRSR pair
+	address.val = PROTECTED + 0x2000;
+	IS25prot_begin();
+	CHECK_EQ(IS25prot_addProgram(data, address, sizeof(data)), MEMORY_OK);
+	address.val = PROTECTED + 0x3000;
+	CHECK_EQ(IS25prot_addProgram(data, address, sizeof(data)), MEMORY_OK);
+	CHECK_EQ(IS25prot_execute(1), MEMORY_OK);
+	CHECK_EQ(IS25sim_memory()[PROTECTED + 0x3000], 0x5A);
+
+	//Protection and the driver check are back
+	address.val = PROTECTED + 0x100;
+	CHECK_EQ(IS25mem_programData(data, address, sizeof(data)), MEMORY_PROTECTED_ERR);
+	IS25prot_getStats(&stats);
+	CHECK_EQ(stats.sectorUnlocks, 1);
+	CHECK_EQ(stats.statusWrites, 3);
+	IS25sim_getStats(&after);
+	CHECK_EQ(after.ignored, 0);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,177 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Scheduler on the simulated flash with pthreads: erase suspension for reads, dispatcher progress while a
+ *      producer has reserved but not published a slot (white box, includes the module), concurrent tasks.
+ *
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "simtest.h"
+#include "simos.h"
+#include "../is25lqxxxb_sched.c"
+
+#define TASK_ROUNDS			24
+
+static char			order[8];
+static uint8_t		orderCnt;
+static uint64_t		doneNs[8];
+
+static void record(flash_err result, void *context){
+	CHECK_EQ(result, MEMORY_OK);
+	doneNs[orderCnt]	= IS25sim_nowNs();
+	order[orderCnt++]	= *(const char *)context;
+}
+
+static void testSuspend(void){
+	uint8_t buffer[256];
+	IS25async_request erase	= {.op = IS25_REQ_SECTOR_ERASE, .callback = record, .context = "E"};
+	IS25async_request read	= {.op = IS25_REQ_READ, .buffer = buffer, .size = sizeof(buffer), .callback = record, .context = "R"};
+	IS25sched_stats stats;
+	IS25sim_stats sim;
+	uint64_t start;
+
+	memset(IS25sim_memory(), 0x5A, 0x1000);
+	IS25sim_resetStats();
+	orderCnt	= 0;
+	start		= IS25sim_nowNs();
+
+	//A read of another sector suspends the erase and completes long before it
+	erase.address.val	= 0x10000;
+	read.address.val	= 0x00000;
+	CHECK_EQ(IS25sched_submit(&erase), MEMORY_OK);
+	CHECK_EQ(IS25sched_submit(&read), MEMORY_OK);
+	IS25sim_irqAll();
+
+	CHECK_EQ(orderCnt, 2);
+	CHECK(memcmp(order, "RE", 2) == 0);
+	CHECK(doneNs[0] - start < 1000000ULL);
+	CHECK(doneNs[1] - start >= 45000000ULL);
+	CHECK_EQ(buffer[0], 0x5A);
+	IS25sim_getStats(&sim);
+	CHECK_EQ(sim.suspends, 1);
+	CHECK_EQ(sim.resumes, 1);
+	CHECK_EQ(sim.sectorErases, 1);
+	CHECK_EQ(IS25sim_eraseCount(0x10), 1);
+	IS25sched_getStats(&stats);
+	CHECK_EQ(stats.suspended, 1);
+
+	//A read of the erased sector waits for the erase
+	orderCnt			= 0;
+	read.address.val	= 0x10000;
+	CHECK_EQ(IS25sched_submit(&erase), MEMORY_OK);
+	CHECK_EQ(IS25sched_submit(&read), MEMORY_OK);
+	IS25sim_irqAll();
+
+	CHECK_EQ(orderCnt, 2);
+	CHECK(memcmp(order, "ER", 2) == 0);
+	IS25sim_getStats(&sim);
+	CHECK_EQ(sim.suspends, 1);
+	CHECK_EQ(buffer[0], 0xFF);
+	CHECK_EQ(IS25async_pending(), 0);
+}
+
+static void testReservedSlot(void){
+	uint8_t buffer[16];
+	IS25async_request read = {.op = IS25_REQ_READ, .buffer = buffer, .size = sizeof(buffer), .callback = record, .context = "R"};
+	unsigned pos;
+
+	orderCnt = 0;
+
+	//Producer interrupted between reserving the slot and publishing it, the dispatch of an interrupt must return
+	pos = atomic_fetch_add(&enqueuePos, 1);
+	alarm(10);
+	IS25sched_dispatch();
+	alarm(0);
+	CHECK_EQ(orderCnt, 0);
+
+	//The producer publishes and dispatches itself
+	submitRing[pos & SCHED_MASK].request = read;
+	atomic_store(&submitRing[pos & SCHED_MASK].seq, pos + 1);
+	IS25sched_dispatch();
+	IS25sim_irqAll();
+	CHECK_EQ(orderCnt, 1);
+}
+
+static volatile uint8_t		readersRun;
+
+static void *writer(void *arg){
+	uint32_t base = (uint32_t)(uintptr_t)arg;
+	uint8_t page[IS25_PAGE_SIZE];
+	uint8_t back[IS25_PAGE_SIZE];
+	mem_address address;
+
+	for(uint32_t round = 0; round < TASK_ROUNDS; round++){
+		address.val = base;
+		CHECK_EQ(IS25sched_erase(IS25_REQ_SECTOR_ERASE, address), MEMORY_OK);
+		for(uint32_t p = 0; p < 4; p++){
+			memset(page, (int)(round + p + (base >> 12)), sizeof(page));
+			address.val = base + p * IS25_PAGE_SIZE;
+			CHECK_EQ(IS25sched_program(page, address, sizeof(page)), MEMORY_OK);
+			CHECK_EQ(IS25sched_read(back, address, sizeof(back)), MEMORY_OK);
+			CHECK(memcmp(back, page, sizeof(page)) == 0);
+		}
+	}
+	return 0;
+}
+
+static void *reader(void *arg){
+	uint8_t back[512];
+	mem_address address = {.val = (uint32_t)(uintptr_t)arg};
+
+	while(readersRun){
+		CHECK_EQ(IS25sched_read(back, address, sizeof(back)), MEMORY_OK);
+		for(uint32_t i = 0; i < sizeof(back); i++){
+			if(back[i] != (uint8_t)i){
+				CHECK(!"reader content");
+				break;
+			}
+		}
+	}
+	return 0;
+}
+
+static void testThreads(void){
+	pthread_t writers[2];
+	pthread_t readers[2];
+	IS25sched_stats stats;
+
+	for(uint32_t i = 0; i < 0x1000; i++){
+		IS25sim_memory()[0x40000 + i] = (uint8_t)i;
+	}
+
+	IS25sim_irqThread(1);
+	readersRun = 1;
+	pthread_create(&readers[0], 0, reader, (void *)(uintptr_t)0x40000);
+	pthread_create(&readers[1], 0, reader, (void *)(uintptr_t)0x40200);
+	pthread_create(&writers[0], 0, writer, (void *)(uintptr_t)0x20000);
+	pthread_create(&writers[1], 0, writer, (void *)(uintptr_t)0x30000);
+	pthread_join(writers[0], 0);
+	pthread_join(writers[1], 0);
+	readersRun = 0;
+	pthread_join(readers[0], 0);
+	pthread_join(readers[1], 0);
+	IS25sim_irqThread(0);
+
+	IS25sched_getStats(&stats);
+	printf("threads: %u requests, %u reordered, %u reads during suspended erases\n",
+			(unsigned)stats.submitted, (unsigned)stats.reordered, (unsigned)stats.suspended);
+	CHECK_EQ(stats.rejected, 0);
+	CHECK_EQ(IS25sim_eraseCount(0x20), TASK_ROUNDS);
+	CHECK_EQ(IS25sim_eraseCount(0x30), TASK_ROUNDS);
+}
+
+int main(void){
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK_EQ(IS25sched_init(&hooks), MEMORY_OK);
+
+	testSuspend();
+	testReservedSlot();
+	testThreads();
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
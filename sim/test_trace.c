@@ -0,0 +1,73 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      QSPI trace on the simulated flash, driver and request queue built with IS25_TRACE: interrupt driven calls
+ *      of the request queue are recorded, data phases above 64 kByte keep their length.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_async.h"
+#include "is25lqxxxb_trace.h"
+
+#define BIG_READ			100000
+
+static IS25trace_record		records[IS25TRACE_DEPTH];
+static uint8_t				big[BIG_READ];
+
+static uint32_t count(uint32_t n, uint8_t kind, uint8_t opcode, uint32_t length){
+	uint32_t found = 0;
+
+	for(uint32_t i = 0; i < n; i++){
+		if(IS25TRACE_KIND(records[i].info) == kind && records[i].opcode == opcode &&
+				(length == 0 || records[i].length == length)){
+			found++;
+		}
+	}
+	return found;
+}
+
+int main(void){
+	IS25async_request req = {.op = IS25_REQ_READ, .buffer = big, .size = BIG_READ};
+	IS25trace_header header;
+	uint8_t page[300];
+	uint32_t n;
+
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	IS25trace_enable(1);
+
+	//Queued read above 64 kByte and a queued program across a page boundary
+	req.address.val = 0x1000;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	IS25sim_irqAll();
+	memset(page, 0x3C, sizeof(page));
+	req = (IS25async_request){.op = IS25_REQ_PROGRAM, .buffer = page, .size = sizeof(page)};
+	req.address.val = 0x40080;
+	CHECK_EQ(IS25async_submit(&req), MEMORY_OK);
+	IS25sim_irqAll();
+
+	//Blocking read above 64 kByte
+	req.address.val = 0x20000;
+	CHECK_EQ(IS25mem_readDataFast(big, req.address, 70000), MEMORY_OK);
+
+	IS25trace_enable(0);
+	n = IS25trace_export(&header, records, IS25TRACE_DEPTH);
+	CHECK_EQ(header.version, IS25TRACE_VERSION);
+	CHECK_EQ(header.recordSize, sizeof(IS25trace_record));
+	CHECK_EQ(header.total, n);
+
+	CHECK_EQ(count(n, IS25_TRACE_CMD, FR, BIG_READ), 1);
+	CHECK_EQ(count(n, IS25_TRACE_RX, FR, BIG_READ), 1);
+	CHECK_EQ(count(n, IS25_TRACE_CMD, WREN, 0), 2);
+	CHECK_EQ(count(n, IS25_TRACE_CMD, PP, 128), 1);
+	CHECK_EQ(count(n, IS25_TRACE_TX, PP, 172), 1);
+	CHECK_EQ(count(n, IS25_TRACE_POLL, RDSR, 0), 2);
+	CHECK_EQ(count(n, IS25_TRACE_RX, FR, 70000), 1);
+	CHECK_EQ(IS25sim_memory()[0x40100], 0x3C);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,113 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Transactions on the simulated flash: a commit whose target writes fail after the commit record is
+ *      programmed must not let the next transaction erase the journal, IS25txn_recover applies it. A commit over
+ *      three sectors (bits only cleared, erase needed, blank) programs less than copying every sector twice.
+ *
+ */
+
+#include <string.h>
+#include "simtest.h"
+#include "is25lqxxxb_txn.h"
+
+#define JOURNAL				0x60000
+#define TARGET				0x10000
+#define MULTI				0x20000			// Three sectors: bits cleared, erase needed, blank
+#define PAGES_USED			4				// Programmed pages of the sector which needs the erase
+
+static uint8_t		page[256];
+
+int main(void){
+	uint8_t data[64];
+	uint8_t back[64];
+	mem_address journal	= {.val = JOURNAL};
+	mem_address target	= {.val = TARGET};
+	mem_address address;
+	IS25txn_stats before, after;
+	uint32_t changed, programmed, copyTwice;
+
+	IS25sim_init(0);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK_EQ(IS25txn_init(journal), MEMORY_OK);
+	CHECK_EQ(IS25txn_begin(), MEMORY_ERROR);
+	CHECK_EQ(IS25txn_recover(), MEMORY_OK);
+
+	//Old content, the new one sets bits again, so the target sector needs an erase
+	memset(data, 0x00, sizeof(data));
+	CHECK_EQ(IS25mem_programData(data, target, sizeof(data)), MEMORY_OK);
+	for(uint32_t i = 0; i < sizeof(data); i++){
+		data[i] = (uint8_t)(i + 1);
+	}
+
+	CHECK_EQ(IS25txn_begin(), MEMORY_OK);
+	CHECK_EQ(IS25txn_write(target, data, sizeof(data)), MEMORY_OK);
+
+	//First write of the commit: the commit record, the second one (target erase) fails
+	IS25sim_powerFail(2);
+	CHECK_EQ(IS25txn_commit(), MEMORY_ERROR);
+	CHECK(IS25sim_powerFailed());
+	IS25sim_powerOn();
+	CHECK(memcmp(IS25sim_memory() + JOURNAL, "CNXT", 4) == 0);
+	CHECK_EQ(IS25sim_memory()[TARGET], 0x00);
+
+	//No new transaction may reuse the journal before the committed one is applied
+	CHECK_EQ(IS25txn_begin(), MEMORY_ERROR);
+	CHECK_EQ(IS25txn_write(target, data, sizeof(data)), MEMORY_ERROR);
+	CHECK(memcmp(IS25sim_memory() + JOURNAL, "CNXT", 4) == 0);
+
+	CHECK_EQ(IS25txn_recover(), MEMORY_OK);
+	CHECK_EQ(IS25mem_readDataFast(back, target, sizeof(back)), MEMORY_OK);
+	CHECK(memcmp(back, data, sizeof(data)) == 0);
+
+	//The journal is usable again
+	data[0] = 0xA5;
+	CHECK_EQ(IS25txn_begin(), MEMORY_OK);
+	CHECK_EQ(IS25txn_write(target, data, 1), MEMORY_OK);
+	CHECK_EQ(IS25txn_commit(), MEMORY_OK);
+	CHECK_EQ(IS25mem_readDataFast(back, target, sizeof(back)), MEMORY_OK);
+	CHECK(memcmp(back, data, sizeof(data)) == 0);
+
+	//Old content of the multi-sector update
+	memset(page, 0xF0, sizeof(page));
+	address.val = MULTI;
+	CHECK_EQ(IS25mem_programData(page, address, sizeof(page)), MEMORY_OK);
+	memset(page, 0x00, sizeof(page));
+	for(uint32_t i = 0; i < PAGES_USED; i++){
+		address.val = MULTI + 0x1000 + i * 256;
+		CHECK_EQ(IS25mem_programData(page, address, sizeof(page)), MEMORY_OK);
+	}
+
+	IS25txn_getStats(&before);
+	CHECK_EQ(IS25txn_begin(), MEMORY_OK);
+	memset(page, 0x30, sizeof(page));
+	address.val = MULTI;
+	CHECK_EQ(IS25txn_write(address, page, sizeof(page)), MEMORY_OK);
+	memset(page, 0x5A, sizeof(page));
+	address.val = MULTI + 0x1000;
+	CHECK_EQ(IS25txn_write(address, page, sizeof(page)), MEMORY_OK);
+	address.val = MULTI + 0x2000;
+	CHECK_EQ(IS25txn_write(address, page, sizeof(page)), MEMORY_OK);
+	CHECK_EQ(IS25txn_commit(), MEMORY_OK);
+	IS25txn_getStats(&after);
+
+	CHECK_EQ(IS25sim_memory()[MULTI + 255], 0x30);
+	CHECK_EQ(IS25sim_memory()[MULTI + 0x1000], 0x5A);
+	CHECK_EQ(IS25sim_memory()[MULTI + 0x1000 + 256], 0x00);		// Backed up page restored
+	CHECK_EQ(IS25sim_memory()[MULTI + 0x1000 + PAGES_USED * 256], 0xFF);
+	CHECK_EQ(IS25sim_memory()[MULTI + 0x2000], 0x5A);
+
+	changed		= after.bytesChanged - before.bytesChanged;
+	programmed	= after.bytesProgrammed - before.bytesProgrammed;
+	copyTwice	= after.copyTwiceBytes - before.copyTwiceBytes;
+	printf("txn: %u byte changed in 3 sectors, programmed %u (%u.%02u x changed), copy twice %u (%u.%02u x changed)\n",
+			(unsigned)changed, (unsigned)programmed, (unsigned)(programmed / changed),
+			(unsigned)(programmed * 100 / changed % 100), (unsigned)copyTwice, (unsigned)(copyTwice / changed),
+			(unsigned)(copyTwice * 100 / changed % 100));
+	CHECK_EQ(changed, 3 * sizeof(page));
+	CHECK(programmed < copyTwice);
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
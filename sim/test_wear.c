@@ -0,0 +1,50 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      Erase counters on the simulated flash: busy times from the cycle counter started by IS25mem_Init, a chip
+ *      erase wiping the reserved sectors is followed by a new snapshot, the counters survive a re-init.
+ *
+ */
+
+#include "simtest.h"
+#include "is25lqxxxb_wear.h"
+
+#define WEAR_SECTOR			120
+#define HOT_SECTOR			5
+
+int main(void){
+	IS25sim_config cfg;
+	IS25wear_health health;
+	mem_address address = {.val = HOT_SECTOR * 4096};
+
+	IS25sim_defaults(&cfg);
+	IS25sim_init(&cfg);
+	CHECK_EQ(IS25mem_Init(IS25sim_handle(1)), MEMORY_OK);
+	CHECK((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk));
+	CHECK_EQ(IS25wear_init(WEAR_SECTOR), MEMORY_OK);
+
+	for(uint8_t i = 0; i < 3; i++){
+		CHECK_EQ(IS25mem_sectorEraseWait(address), MEMORY_OK);
+	}
+	IS25wear_getHealth(&health);
+	CHECK(health.eraseMaxUs + 10 >= cfg.tseUs && health.eraseMaxUs < cfg.tseUs + 100);
+	CHECK_EQ(IS25wear_flush(), MEMORY_OK);
+	CHECK_EQ(IS25wear_getCount(HOT_SECTOR), 3);
+
+	//A chip erase also wipes the table, the next process call rewrites it
+	CHECK_EQ(IS25mem_chipEraseWait(), MEMORY_OK);
+	CHECK_EQ(IS25wear_getCount(HOT_SECTOR), 4);
+	IS25wear_getHealth(&health);
+	CHECK_EQ(health.snapshotsWritten, 1);
+	CHECK_EQ(IS25wear_process(), MEMORY_OK);
+	IS25wear_getHealth(&health);
+	CHECK_EQ(health.snapshotsWritten, 2);
+
+	CHECK_EQ(IS25wear_init(WEAR_SECTOR), MEMORY_OK);
+	CHECK_EQ(IS25wear_getCount(HOT_SECTOR), 4);
+	CHECK_EQ(IS25wear_getCount(WEAR_SECTOR), 2);	// First snapshot and the chip erase
+
+	CHECK_CLEAN();
+
+	return SIMTEST_RESULT();
+}
@@ -0,0 +1,478 @@
+/*
+ * 		Created on: 18.10.2026
+ *
+ *      IS25LQXXXB trace replay (host tool)
+ *
+ *      Reads a trace exported with IS25trace_export (header followed by the records, little endian) and replays
+ *      it against a timing model of the flash: every command is given its ideal bus time at the traced QSPI clock
+ *      and program / erase / write register cycles keep the simulated flash busy for their typical time.
+ *      Reports bus utilisation, idle gaps and per operation the phase on the critical path.
+ *
+ *      cc -O2 -o is25trace_replay tools/is25trace_replay.c
+ *      is25trace_replay trace.bin [-s sclkHz] [-n slowest]
+ *
+ */
+
+//Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TRACE_MAGIC				0x43525449			// "ITRC"
+#define TRACE_VERSION			2			// Version 1 (16 bit length, 16 byte records) is read as well
+
+#define KIND_CMD				0
+#define KIND_TX					1
+#define KIND_RX					2
+#define KIND_POLL				3
+
+#define OP_WREN					0x06
+
+/**
+ * Same layout as IS25trace_header / IS25trace_record in is25lqxxxb_trace.h
+ */
+typedef struct{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	recordSize;
+	uint32_t	ticksPerUs;
+	uint32_t	sclkHz;
+	uint32_t	count;
+	uint32_t	total;
+}trace_header;
+
+typedef struct{
+	uint32_t	timestamp;
+	uint32_t	duration;
+	uint32_t	address;
+	uint32_t	length;
+	uint8_t		opcode;
+	uint8_t		info;
+	uint16_t	reserved;
+}trace_record;
+
+typedef struct{
+	uint32_t	timestamp;
+	uint32_t	duration;
+	uint32_t	address;
+	uint16_t	length;
+	uint8_t		opcode;
+	uint8_t		info;
+}trace_record_v1;
+
+typedef char trace_record_size_check[(sizeof(trace_record) == 20) ? 1 : -1];
+typedef char trace_record_v1_size_check[(sizeof(trace_record_v1) == 16) ? 1 : -1];
+
+/**
+ * Timing model of the simulated flash, typical values of the IS25LQ / IS25LP data sheets
+ */
+typedef struct{
+	uint8_t		opcode;
+	const char	*name;
+	uint8_t		dummyCycles;
+	uint8_t		modeCycles;			// Mode bits of the I/O reads, in address line cycles
+	uint32_t	busyUs;				// Internal cycle after the command (program / erase / write register)
+}op_model;
+
+static const op_model models[] = {
+	{0x03, "RD",		0, 0, 0},		{0x13, "RD4",		0, 0, 0},
+	{0x0B, "FR",		8, 0, 0},		{0x0C, "FR4",		8, 0, 0},
+	{0x3B, "FRDO",		8, 0, 0},		{0x3C, "FRDO4",		8, 0, 0},
+	{0xBB, "FRDIO",		0, 4, 0},		{0xBC, "FRDIO4",	0, 4, 0},
+	{0x6B, "FRQO",		8, 0, 0},		{0x6C, "FRQO4",		8, 0, 0},
+	{0xEB, "FRQIO",		4, 2, 0},		{0xEC, "FRQIO4",	4, 2, 0},
+	{0x02, "PP",		0, 0, 200},		{0x12, "PP4",		0, 0, 200},
+	{0x38, "PPQ",		0, 0, 200},		{0x34, "PPQ4",		0, 0, 200},
+	{0x20, "SER",		0, 0, 45000},	{0x21, "SER4",		0, 0, 45000},
+	{0x52, "BER32",		0, 0, 150000},	{0x5C, "BER32_4",	0, 0, 150000},
+	{0xD8, "BER64",		0, 0, 300000},	{0xDC, "BER64_4",	0, 0, 300000},
+	{0x60, "CER",		0, 0, 1500000},	{0xC7, "CER",		0, 0, 1500000},
+	{0x06, "WREN",		0, 0, 0},		{0x04, "WRDI",		0, 0, 0},
+	{0x05, "RDSR",		0, 0, 0},		{0x01, "WRSR",		0, 0, 2000},
+	{0x48, "RDFR",		0, 0, 0},		{0x42, "WRFR",		0, 0, 2000},
+	{0xB0, "PERSUS",	0, 0, 0},		{0x30, "PERRSM",	0, 0, 0},
+	{0xAB, "RDID",		24, 0, 0},		{0x9F, "RDJDID",	0, 0, 0},
+	{0x4B, "RDUID",		8, 0, 0},		{0x90, "RDMDID",	0, 0, 0},
+	{0x5A, "RDSFDP",	8, 0, 0},		{0x66, "RSTEN",		0, 0, 0},
+	{0x99, "RST",		0, 0, 0},		{0x62, "IRP",		0, 0, 200},
+	{0x68, "IRRD",		8, 0, 0},		{0x64, "IRER",		0, 0, 45000},
+	{0x26, "SECUNLOCK",	0, 0, 0},		{0x24, "SECLOCK",	0, 0, 0},
+};
+
+#define PHASE_COMMAND			0
+#define PHASE_DATA				1
+#define PHASE_POLL				2
+#define PHASE_GAP				3
+#define PHASES					4
+
+static const char *phaseNames[PHASES] = {"command", "data", "poll", "gap"};
+
+/**
+ * One operation: optional WREN, command, data phase and status poll
+ */
+typedef struct{
+	uint64_t	start;				// us
+	uint64_t	end;
+	double		phase[PHASES];		// us
+	double		modelUs;			// Bus time + busy time of the simulated flash
+	uint32_t	address;
+	uint32_t	length;
+	uint8_t		opcode;
+	uint8_t		hasMain;
+	uint8_t		failed;
+}op_replay;
+
+typedef struct{
+	uint32_t	count;
+	uint32_t	slow;				// Measured more than twice the model
+	uint32_t	critical[PHASES];
+	double		sumUs;
+	double		maxUs;
+	double		sumModelUs;
+}op_summary;
+
+//Private variables
+static op_summary			summary[256];
+
+
+static const op_model *findModel(uint8_t opcode){
+	for(size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++){
+		if(models[i].opcode == opcode){
+			return &models[i];
+		}
+	}
+	return 0;
+}
+
+static const char *opName(uint8_t opcode){
+	static char unknown[8];
+	const op_model *m = findModel(opcode);
+
+	if(m != 0){
+		return m->name;
+	}
+	snprintf(unknown, sizeof(unknown), "0x%02X", opcode);
+	return unknown;
+}
+
+static uint8_t lines(uint8_t code){
+	return code == 3 ? 4 : code;
+}
+
+/**
+ * busUs(const trace_record *rec, double sclk)
+ *
+ * @Brief
+ * 		Ideal bus time of a command with its data phase: instruction, address, mode, dummy and data cycles.
+ */
+static double busUs(const trace_record *rec, double sclk){
+	const op_model *m	= findModel(rec->opcode);
+	uint8_t addrLines	= lines((rec->info >> 4) & 3);
+	uint8_t dataLines	= lines((rec->info >> 6) & 3);
+	double cycles		= 8;
+
+	if(addrLines != 0){
+		cycles += (rec->address > 0xFFFFFF ? 32 : 24) / addrLines;
+	}
+	if(m != 0){
+		cycles += m->dummyCycles + m->modeCycles;
+	}
+	if(dataLines != 0){
+		cycles += (double)rec->length * 8 / dataLines;
+	}
+
+	return cycles * 1e6 / sclk;
+}
+
+static void finishOp(op_replay *op, uint32_t *slowest, op_replay *slowList, uint32_t slowMax){
+	op_summary *s = &summary[op->opcode];
+	double total = (double)(op->end - op->start);
+	uint8_t critical = 0;
+
+	if(!op->hasMain){
+		return;
+	}
+
+	for(uint8_t p = 1; p < PHASES; p++){
+		if(op->phase[p] > op->phase[critical]){
+			critical = p;
+		}
+	}
+
+	s->count++;
+	s->critical[critical]++;
+	s->sumUs		+= total;
+	s->sumModelUs	+= op->modelUs;
+	if(total > s->maxUs){
+		s->maxUs = total;
+	}
+	if(op->modelUs > 0 && total > 2 * op->modelUs){
+		s->slow++;
+	}
+
+	//Keep the slowest operations, sorted by their excess over the model
+	if(slowMax != 0){
+		double excess = total - op->modelUs;
+		uint32_t n = *slowest;
+		uint32_t i;
+
+		if(n == slowMax && excess <= (double)(slowList[n - 1].end - slowList[n - 1].start) - slowList[n - 1].modelUs){
+			return;
+		}
+		if(n < slowMax){
+			n++;
+		}
+		for(i = n - 1; i > 0; i--){
+			op_replay *prev = &slowList[i - 1];
+			if((double)(prev->end - prev->start) - prev->modelUs >= excess){
+				break;
+			}
+			slowList[i] = *prev;
+		}
+		slowList[i] = *op;
+		*slowest = n;
+	}
+}
+
+/**
+ * readRecords(FILE *f, const trace_header *header, trace_record *recs)
+ *
+ * @Brief
+ * 		Reads the records of a version 2 trace, or of a version 1 trace converted to the version 2 layout.
+ */
+static int readRecords(FILE *f, const trace_header *header, trace_record *recs){
+	trace_record_v1 old;
+
+	if(header->version == TRACE_VERSION){
+		return fread(recs, sizeof(*recs), header->count, f) == header->count;
+	}
+	for(uint32_t i = 0; i < header->count; i++){
+		if(fread(&old, sizeof(old), 1, f) != 1){
+			return 0;
+		}
+		recs[i] = (trace_record){old.timestamp, old.duration, old.address, old.length, old.opcode, old.info, 0};
+	}
+	return 1;
+}
+
+static void usage(void){
+	fprintf(stderr, "usage: is25trace_replay trace.bin [-s sclkHz] [-n slowest]\n");
+	exit(2);
+}
+
+int main(int argc, char **argv){
+	const char *path	= 0;
+	double sclk			= 0;
+	uint32_t slowMax	= 10;
+	trace_header header;
+	trace_record *recs;
+	uint64_t *startUs;
+	FILE *f;
+
+	for(int i = 1; i < argc; i++){
+		if(strcmp(argv[i], "-s") == 0 && i + 1 < argc){
+			sclk = atof(argv[++i]);
+		}else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc){
+			slowMax = (uint32_t)atoi(argv[++i]);
+		}else if(argv[i][0] == '-' || path != 0){
+			usage();
+		}else{
+			path = argv[i];
+		}
+	}
+	if(path == 0){
+		usage();
+	}
+
+	f = fopen(path, "rb");
+	if(f == 0){
+		perror(path);
+		return 1;
+	}
+	if(fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_MAGIC || header.ticksPerUs == 0 ||
+			!((header.version == TRACE_VERSION && header.recordSize == sizeof(trace_record)) ||
+			  (header.version == 1 && header.recordSize == sizeof(trace_record_v1)))){
+		fprintf(stderr, "%s: not an IS25 trace\n", path);
+		return 1;
+	}
+	if(sclk == 0){
+		sclk = header.sclkHz;
+	}
+	if(sclk == 0 || header.count == 0){
+		fprintf(stderr, "%s: no records or unknown QSPI clock (use -s)\n", path);
+		return 1;
+	}
+
+	recs	= malloc(header.count * sizeof(*recs));
+	startUs	= malloc(header.count * sizeof(*startUs));
+	if(recs == 0 || startUs == 0 || !readRecords(f, &header, recs)){
+		fprintf(stderr, "%s: truncated\n", path);
+		return 1;
+	}
+	fclose(f);
+
+	//Absolute time line, the 32 bit timestamps wrap
+	uint64_t ticks = 0;
+	for(uint32_t i = 0; i < header.count; i++){
+		if(i != 0){
+			ticks += (uint32_t)(recs[i].timestamp - recs[i - 1].timestamp);
+		}
+		startUs[i] = ticks / header.ticksPerUs;
+	}
+
+	//Bus utilisation and idle gaps
+	static const double gapLimits[] = {10, 100, 1000, 10000};
+	uint32_t gapHistogram[5]	= {0};
+	double busyUs				= 0;
+	double pollUs				= 0;
+	double gapUs				= 0;
+	double maxGap				= 0;
+	uint32_t maxGapAt			= 0;
+	uint32_t errors				= 0;
+	uint64_t spanUs				= startUs[header.count - 1] + recs[header.count - 1].duration / header.ticksPerUs;
+
+	for(uint32_t i = 0; i < header.count; i++){
+		double duration = (double)recs[i].duration / header.ticksPerUs;
+
+		if(((recs[i].info >> 2) & 3) != 0){
+			errors++;
+		}
+		if((recs[i].info & 3) == KIND_POLL){
+			pollUs += duration;
+		}else{
+			busyUs += duration;
+		}
+
+		if(i + 1 < header.count){
+			double end	= (double)startUs[i] + duration;
+			double gap	= (double)startUs[i + 1] > end ? (double)startUs[i + 1] - end : 0;
+			uint8_t b	= 0;
+			while(b < 4 && gap >= gapLimits[b]){
+				b++;
+			}
+			gapHistogram[b]++;
+			gapUs += gap;
+			if(gap > maxGap){
+				maxGap		= gap;
+				maxGapAt	= i;
+			}
+		}
+	}
+
+	printf("records      %u (%u overwritten), span %.3f ms, QSPI clock %.1f MHz\n",
+			header.count, header.total - header.count, spanUs / 1000.0, sclk / 1e6);
+	printf("bus busy     %.3f ms (%.1f %%), polling %.3f ms (%.1f %%), idle %.3f ms (%.1f %%)\n",
+			busyUs / 1000.0, spanUs ? 100.0 * busyUs / spanUs : 0, pollUs / 1000.0, spanUs ? 100.0 * pollUs / spanUs : 0,
+			gapUs / 1000.0, spanUs ? 100.0 * gapUs / spanUs : 0);
+	printf("idle gaps    <10us %u, <100us %u, <1ms %u, <10ms %u, >=10ms %u, longest %.1f us after %s @ %.3f ms\n",
+			gapHistogram[0], gapHistogram[1], gapHistogram[2], gapHistogram[3], gapHistogram[4],
+			maxGap, opName(recs[maxGapAt].opcode), startUs[maxGapAt] / 1000.0);
+	printf("HAL errors   %u\n\n", errors);
+
+	//Replay the operations against the flash model
+	op_replay *slowList	= calloc(slowMax ? slowMax : 1, sizeof(op_replay));
+	uint32_t slowest	= 0;
+	uint64_t busyUntil	= 0;				// Simulated flash busy with a program / erase cycle
+	uint64_t modelClock	= 0;				// Simulated time line without host side gaps
+	op_replay op;
+
+	memset(&op, 0, sizeof(op));
+	for(uint32_t i = 0; i < header.count; i++){
+		const trace_record *rec	= &recs[i];
+		uint8_t kind			= rec->info & 3;
+		double duration			= (double)rec->duration / header.ticksPerUs;
+		uint64_t end			= startUs[i] + rec->duration / header.ticksPerUs;
+
+		if(kind == KIND_CMD && op.hasMain){
+			finishOp(&op, &slowest, slowList, slowMax);
+			memset(&op, 0, sizeof(op));
+		}
+		if(op.start == 0 && op.end == 0){
+			op.start = startUs[i];
+		}else if(startUs[i] > op.end){
+			op.phase[PHASE_GAP] += (double)(startUs[i] - op.end);
+		}
+		op.end = end;
+		if(((rec->info >> 2) & 3) != 0){
+			op.failed = 1;
+		}
+
+		switch(kind){
+			case KIND_CMD:
+				op.phase[PHASE_COMMAND] += duration;
+				if(rec->opcode == OP_WREN){
+					op.modelUs += busUs(rec, sclk);
+				}else{
+					const op_model *m = findModel(rec->opcode);
+					op.hasMain	= 1;
+					op.opcode	= rec->opcode;
+					op.address	= rec->address;
+					op.length	= rec->length;
+					if(rec->length == 0){
+						op.modelUs += busUs(rec, sclk);		// Without data phase the command is the whole transfer
+					}
+					if(m != 0 && m->busyUs != 0){
+						busyUntil	= modelClock + (uint64_t)busUs(rec, sclk) + m->busyUs;
+						op.modelUs	+= m->busyUs;
+					}
+				}
+				break;
+			case KIND_TX:
+			case KIND_RX:
+				op.phase[PHASE_DATA] += duration;
+				op.modelUs += busUs(rec, sclk);
+				break;
+			case KIND_POLL:
+				op.phase[PHASE_POLL] += duration;
+				if(modelClock < busyUntil){
+					modelClock = busyUntil;					// The simulated flash finishes its cycle
+				}
+				if(!op.hasMain){
+					op.hasMain	= 1;
+					op.opcode	= rec->opcode;
+				}
+				break;
+		}
+		if(kind != KIND_POLL){
+			modelClock += (uint64_t)busUs(rec, sclk);
+		}
+	}
+	finishOp(&op, &slowest, slowList, slowMax);
+
+	printf("replay       %.3f ms on the simulated flash without host gaps (measured %.3f ms)\n\n",
+			modelClock / 1000.0, spanUs / 1000.0);
+
+	printf("%-10s %7s %11s %11s %11s %6s  critical path (command / data / poll / gap)\n",
+			"operation", "count", "avg us", "max us", "model us", "slow");
+	for(int opcode = 0; opcode < 256; opcode++){
+		op_summary *s = &summary[opcode];
+		if(s->count == 0){
+			continue;
+		}
+		printf("%-10s %7u %11.1f %11.1f %11.1f %6u  %u / %u / %u / %u\n", opName((uint8_t)opcode), s->count,
+				s->sumUs / s->count, s->maxUs, s->sumModelUs / s->count, s->slow,
+				s->critical[PHASE_COMMAND], s->critical[PHASE_DATA], s->critical[PHASE_POLL], s->critical[PHASE_GAP]);
+	}
+
+	if(slowest != 0){
+		printf("\nslowest operations against the model\n");
+		for(uint32_t i = 0; i < slowest; i++){
+			op_replay *o	= &slowList[i];
+			uint8_t worst	= 0;
+			for(uint8_t p = 1; p < PHASES; p++){
+				if(o->phase[p] > o->phase[worst]){
+					worst = p;
+				}
+			}
+			printf("  @%10.3f ms %-10s addr 0x%08X len %5u  %10.1f us (model %10.1f us), %s %.1f us%s\n",
+					o->start / 1000.0, opName(o->opcode), o->address, o->length, (double)(o->end - o->start), o->modelUs,
+					phaseNames[worst], o->phase[worst], o->failed ? ", HAL error" : "");
+		}
+	}
+
+	free(slowList);
+	free(startUs);
+	free(recs);
+	return 0;
+}